@@ -6,15 +6,107 @@
 
 #include <cassert>
 #include <cmath>
+#include <cstdint>
 #include <cstring>
 #include <initializer_list>
+#include <new>
 #include <random>
 
 #include "functional.hpp"
 #include "iterator.hpp"
+#include "simd.hpp"
 
 namespace tiny_stl {
 
+namespace details {
+
+// call op(localFirst, localLast) for each block of a segmented range
+template <typename SegIter, typename Op>
+inline void forEachSegment(SegIter first, SegIter last, Op op) {
+    using Traits = SegmentedIteratorTraits<SegIter>;
+    auto seg = Traits::segment(first);
+    const auto segLast = Traits::segment(last);
+
+    if (seg == segLast) {
+        op(Traits::local(first), Traits::local(last));
+        return;
+    }
+
+    op(Traits::local(first), Traits::end(seg));
+    for (++seg; seg != segLast; ++seg)
+        op(Traits::begin(seg), Traits::end(seg));
+    op(Traits::begin(segLast), Traits::local(last));
+}
+
+// same as forEachSegment, from the last block to the first
+template <typename SegIter, typename Op>
+inline void forEachSegmentBackward(SegIter first, SegIter last, Op op) {
+    using Traits = SegmentedIteratorTraits<SegIter>;
+    const auto segFirst = Traits::segment(first);
+    auto seg = Traits::segment(last);
+
+    if (seg == segFirst) {
+        op(Traits::local(first), Traits::local(last));
+        return;
+    }
+
+    op(Traits::begin(seg), Traits::local(last));
+    for (--seg; seg != segFirst; --seg)
+        op(Traits::begin(seg), Traits::end(seg));
+    op(Traits::local(first), Traits::end(segFirst));
+}
+
+// cut [first, last) into pieces that fit the blocks behind dst,
+// op(first, first + k, localDst) returns the local end of what it wrote
+template <typename RanIter, typename SegIter, typename Op>
+inline SegIter segmentedOutput(RanIter first, RanIter last, SegIter dst,
+                               Op op) {
+    using Traits = SegmentedIteratorTraits<SegIter>;
+    auto seg = Traits::segment(dst);
+    auto local = Traits::local(dst);
+
+    for (auto n = last - first; n > 0;) {
+        if (local == Traits::end(seg))
+            local = Traits::begin(++seg);
+
+        auto k = Traits::end(seg) - local;
+        if (k > n)
+            k = n;
+
+        local = op(first, first + k, local);
+        first += k;
+        n -= k;
+    }
+
+    return Traits::compose(seg, local);
+}
+
+// segmentedOutput for a destination filled backward from dstLast
+template <typename RanIter, typename SegIter, typename Op>
+inline SegIter segmentedOutputBackward(RanIter first, RanIter last,
+                                       SegIter dstLast, Op op) {
+    using Traits = SegmentedIteratorTraits<SegIter>;
+    auto seg = Traits::segment(dstLast);
+    auto local = Traits::local(dstLast);
+
+    for (auto n = last - first; n > 0;) {
+        if (local == Traits::begin(seg))
+            local = Traits::end(--seg);
+
+        auto k = local - Traits::begin(seg);
+        if (k > n)
+            k = n;
+
+        local = op(last - k, last, local);
+        last -= k;
+        n -= k;
+    }
+
+    return Traits::compose(seg, local);
+}
+
+} // namespace details
+
 template <typename InIter, typename UnaryPred>
 inline bool all_of(InIter first, InIter last, UnaryPred pred) {
     for (; first != last; ++first)
@@ -42,29 +134,107 @@ inline bool none_of(InIter first, InIter last, UnaryPred pred) {
     return true;
 }
 
+namespace details {
+
 template <typename InIter, typename UnaryFunc>
-inline UnaryFunc for_each(InIter first, InIter last, UnaryFunc f) {
+inline void forEachAux(InIter first, InIter last, UnaryFunc& f, false_type) {
     for (; first != last; ++first)
         f(*first);
+}
+
+template <typename SegIter, typename UnaryFunc>
+inline void forEachAux(SegIter first, SegIter last, UnaryFunc& f, true_type) {
+    forEachSegment(first, last, [&f](auto lfirst, auto llast) {
+        for (; lfirst != llast; ++lfirst)
+            f(*lfirst);
+    });
+}
+
+template <typename InIter, typename UnaryPred>
+inline IterDiffType<InIter> countIfAux(InIter first, InIter last,
+                                       UnaryPred& pred, false_type) {
+    IterDiffType<InIter> c = 0;
+    for (; first != last; ++first)
+        c += pred(*first) ? 1 : 0; // no branch, vectorizes for simple preds
+
+    return c;
+}
+
+template <typename SegIter, typename UnaryPred>
+inline IterDiffType<SegIter> countIfAux(SegIter first, SegIter last,
+                                        UnaryPred& pred, true_type) {
+    IterDiffType<SegIter> c = 0;
+    forEachSegment(first, last, [&](auto lfirst, auto llast) {
+        c += countIfAux(lfirst, llast, pred, false_type{});
+    });
+
+    return c;
+}
+
+} // namespace details
 
+template <typename InIter, typename UnaryFunc>
+inline UnaryFunc for_each(InIter first, InIter last, UnaryFunc f) {
+    details::forEachAux(first, last, f, IsSegmentedIterator<InIter>{});
     return tiny_stl::move(f);
 }
 
 template <typename InIter, typename UnaryPred>
 inline typename iterator_traits<InIter>::difference_type
 count_if(InIter first, InIter last, UnaryPred pred) {
-    typename iterator_traits<InIter>::difference_type c = 0;
-    for (; first != last; ++first)
-        if (pred(*first))
-            ++c;
+    return details::countIfAux(first, last, pred,
+                               IsSegmentedIterator<InIter>{});
+}
 
-    return c;
+namespace details {
+
+// find / count go to the vector kernels for an arithmetic val, checked by
+// simdSearchKey() to compare with the elements as their own type does, a
+// val that fails the check equals no element. A floating val is not
+// converted to integer elements, that may overflow.
+template <typename Iter, typename T,
+          typename V = remove_cv_t<IteratorValueType<Iter>>>
+struct IsSimdSearch
+    : conjunction<IsSimdRange<Iter>,
+                  bool_constant<is_integral<T>::value ||
+                                (is_floating_point<T>::value &&
+                                 is_floating_point<V>::value)>> {};
+
+// val survives the trip through V, compared in the type that v == val uses
+template <typename V, typename T>
+inline bool simdSearchKey(const T& val) {
+    using C = decltype(tiny_stl::declval<V>() + tiny_stl::declval<T>());
+    return static_cast<C>(static_cast<V>(val)) == static_cast<C>(val);
 }
 
+template <typename InIter, typename T>
+inline IterDiffType<InIter> countAux(InIter first, InIter last, const T& val,
+                                     false_type) {
+    return tiny_stl::count_if(first, last,
+                              [&val](const auto& v) { return v == val; });
+}
+
+template <typename ContIter, typename T>
+inline IterDiffType<ContIter> countAux(ContIter first, ContIter last,
+                                       const T& val, true_type) {
+    using Traits = ContiguousIteratorTraits<ContIter>;
+    using V = remove_cv_t<IteratorValueType<ContIter>>;
+
+    if (!simdSearchKey<V>(val))
+        return 0;
+
+    return static_cast<IterDiffType<ContIter>>(simdRun<SimdCount, V>(
+        Traits::toPointer(first), Traits::toPointer(last),
+        static_cast<V>(val)));
+}
+
+} // namespace details
+
 template <typename InIter, typename T>
 inline typename iterator_traits<InIter>::difference_type
 count(InIter first, InIter last, const T& val) {
-    return count_if(first, last, [&val](const auto& v) { return v == val; });
+    return details::countAux(first, last, val,
+                             details::IsSimdSearch<InIter, T>{});
 }
 
 template <typename InIter1, typename InIter2, typename BinPred>
@@ -112,22 +282,75 @@ inline pair<InIter1, InIter2> mismatch(InIter1 first1, InIter1 last1,
     return tiny_stl::make_pair(first1, first2);
 }
 
-template <typename InIter, typename T>
-inline InIter find(InIter first, InIter last, const T& val) {
+namespace details {
+
+template <typename InIter, typename UnaryPred>
+inline InIter findIfAux(InIter first, InIter last, UnaryPred& pred,
+                        false_type) {
     for (; first != last; ++first)
-        if (*first == val)
+        if (pred(*first))
             return first;
 
     return last;
 }
 
+template <typename SegIter, typename UnaryPred>
+inline SegIter findIfAux(SegIter first, SegIter last, UnaryPred& pred,
+                         true_type) {
+    using Traits = SegmentedIteratorTraits<SegIter>;
+    auto seg = Traits::segment(first);
+    const auto segLast = Traits::segment(last);
+    auto lfirst = Traits::local(first);
+
+    for (; seg != segLast; ++seg, lfirst = Traits::begin(seg)) {
+        const auto llast = Traits::end(seg);
+        const auto pos = findIfAux(lfirst, llast, pred, false_type{});
+        if (pos != llast)
+            return Traits::compose(seg, pos);
+    }
+
+    const auto pos =
+        findIfAux(lfirst, Traits::local(last), pred, false_type{});
+    return Traits::compose(seg, pos);
+}
+
+} // namespace details
+
+namespace details {
+
+template <typename InIter, typename T>
+inline InIter findAux(InIter first, InIter last, const T& val, false_type) {
+    auto pred = [&val](const auto& v) { return v == val; };
+    return findIfAux(first, last, pred, IsSegmentedIterator<InIter>{});
+}
+
+template <typename ContIter, typename T>
+inline ContIter findAux(ContIter first, ContIter last, const T& val,
+                        true_type) {
+    using Traits = ContiguousIteratorTraits<ContIter>;
+    using V = remove_cv_t<IteratorValueType<ContIter>>;
+
+    if (!simdSearchKey<V>(val))
+        return last;
+
+    const auto p = Traits::toPointer(first);
+    const auto pos =
+        simdRun<SimdFind, V>(p, Traits::toPointer(last), static_cast<V>(val));
+    return Traits::fromPointer(first, p + (pos - p));
+}
+
+} // namespace details
+
+template <typename InIter, typename T>
+inline InIter find(InIter first, InIter last, const T& val) {
+    return details::findAux(first, last, val,
+                            details::IsSimdSearch<InIter, T>{});
+}
+
 template <typename InIter, typename UnaryPred>
 inline InIter find_if(InIter first, InIter last, UnaryPred pred) {
-    for (; first != last; ++first)
-        if (pred(*first))
-            return first;
-
-    return last;
+    return details::findIfAux(first, last, pred,
+                              IsSegmentedIterator<InIter>{});
 }
 
 template <typename InIter, typename UnaryPred>
@@ -177,7 +400,7 @@ inline OutIter fillNHelper(OutIter dst, Diff n, const T& val,
 
 template <typename FwdIter, typename T>
 inline void fillHelper(FwdIter first, FwdIter last, const T& val, true_type) {
-    std::memset(first, last - first, val);
+    std::memset(first, val, last - first);
 }
 
 template <typename FwdIter, typename T>
@@ -186,18 +409,54 @@ inline void fillHelper(FwdIter first, FwdIter last, const T& val, false_type) {
         *first = val;
 }
 
+template <typename OutIter, typename Diff, typename T>
+inline OutIter fillNAux(OutIter dst, Diff n, const T& val, false_type) {
+    return fillNHelper(dst, n, val, fillMemsetIsSafe(dst, val));
+}
+
+template <typename SegIter, typename Diff, typename T>
+inline SegIter fillNAux(SegIter dst, Diff n, const T& val, true_type) {
+    using Traits = SegmentedIteratorTraits<SegIter>;
+    auto seg = Traits::segment(dst);
+    auto local = Traits::local(dst);
+
+    while (n > 0) {
+        if (local == Traits::end(seg))
+            local = Traits::begin(++seg);
+
+        Diff k = static_cast<Diff>(Traits::end(seg) - local);
+        if (k > n)
+            k = n;
+
+        local = fillNHelper(local, k, val, fillMemsetIsSafe(local, val));
+        n -= k;
+    }
+
+    return Traits::compose(seg, local);
+}
+
+template <typename FwdIter, typename T>
+inline void fillAux(FwdIter first, FwdIter last, const T& val, false_type) {
+    fillHelper(first, last, val, fillMemsetIsSafe(first, val));
+}
+
+template <typename SegIter, typename T>
+inline void fillAux(SegIter first, SegIter last, const T& val, true_type) {
+    forEachSegment(first, last, [&val](auto lfirst, auto llast) {
+        fillHelper(lfirst, llast, val, fillMemsetIsSafe(lfirst, val));
+    });
+}
+
 } // namespace details
 
 template <typename OutIter, typename Diff, typename T>
 inline OutIter fill_n(OutIter dst, Diff n, const T& val) {
-    return details::fillNHelper(dst, n, val,
-                                details::fillMemsetIsSafe(dst, val));
+    return details::fillNAux(dst, n, val, IsSegmentedIterator<OutIter>{});
 }
 
 template <typename FwdIter, typename T>
 inline void fill(FwdIter first, FwdIter last, const T& val) {
-    details::fillHelper(first, last, val,
-                        details::fillMemsetIsSafe(first, val));
+    details::fillAux(first, last, val, IsSegmentedIterator<FwdIter>{});
 }
 
 template <typename FwdIter, typename Func>
@@ -244,47 +503,240 @@ inline OutIter copy_if(InIter first, InIter last, OutIter dst, UnaryPred pred) {
 }
 
 template <typename InIter, typename OutIter>
-inline OutIter copy(InIter first, InIter last, OutIter dst) {
-    for (; first != last; ++first)
-        *dst++ = *first;
+inline OutIter copy(InIter first, InIter last, OutIter dst);
+
+template <typename BidIter1, typename BidIter2>
+inline BidIter2 copy_backward(BidIter1 first, BidIter1 last, BidIter2 dstLast);
+
+template <typename InIter, typename OutIter>
+inline OutIter move(InIter first, InIter last, OutIter dstFirst);
+
+template <typename BidIter1, typename BidIter2>
+inline BidIter2 move_backward(BidIter1 first, BidIter1 last, BidIter2 dstLast);
+
+namespace details {
+
+// T* -> U* of the same trivially copyable type can be a memmove
+template <typename InIter, typename OutIter>
+struct MemmoveIsSafe : false_type {};
+
+template <typename T, typename U>
+struct MemmoveIsSafe<T*, U*>
+    : conjunction<is_same<remove_const_t<T>, U>, is_trivially_copyable<U>>::
+          type {};
+
+template <typename InIter, typename OutIter>
+inline OutIter copyAux(InIter first, InIter last, OutIter dst, false_type) {
+    for (; first != last; ++first, ++dst)
+        *dst = *first;
 
     return dst;
 }
 
-template <typename InIter, typename Size, typename OutIter>
-inline OutIter copy_n(InIter src, Size count, OutIter dst) {
-    if (count > 0) {
-        for (Size i = 0; i < count; ++i)
-            *dst = *src;
-    }
+template <typename T, typename U>
+inline U* copyAux(T* first, T* last, U* dst, true_type /* memmove */) {
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (n != 0)
+        std::memmove(dst, first, n * sizeof(U));
 
-    return dst;
+    return dst + n;
 }
 
 template <typename BidIter1, typename BidIter2>
-inline BidIter2 copy_backward(BidIter1 first, BidIter1 last, BidIter2 dstLast) {
+inline BidIter2 copyBackwardAux(BidIter1 first, BidIter1 last,
+                                BidIter2 dstLast, false_type) {
     for (; first != last;)
         *(--dstLast) = *(--last);
 
     return dstLast;
 }
 
+template <typename T, typename U>
+inline U* copyBackwardAux(T* first, T* last, U* dstLast,
+                          true_type /* memmove */) {
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (n != 0)
+        std::memmove(dstLast - n, first, n * sizeof(U));
+
+    return dstLast - n;
+}
+
 template <typename InIter, typename OutIter>
-inline OutIter move(InIter first, InIter last, OutIter dstFirst) {
-    for (; first != last;)
-        *(dstFirst++) = tiny_stl::move(*first++);
+inline OutIter moveAux(InIter first, InIter last, OutIter dst, false_type) {
+    for (; first != last; ++first, ++dst)
+        *dst = tiny_stl::move(*first);
 
-    return dstFirst;
+    return dst;
+}
+
+template <typename T, typename U>
+inline U* moveAux(T* first, T* last, U* dst, true_type /* memmove */) {
+    return copyAux(first, last, dst, true_type{});
 }
 
 template <typename BidIter1, typename BidIter2>
-inline BidIter2 move_backward(BidIter1 first, BidIter1 last, BidIter2 dstLast) {
+inline BidIter2 moveBackwardAux(BidIter1 first, BidIter1 last,
+                                BidIter2 dstLast, false_type) {
     for (; first != last;)
         *(--dstLast) = tiny_stl::move(*(--last));
 
     return dstLast;
 }
 
+template <typename T, typename U>
+inline U* moveBackwardAux(T* first, T* last, U* dstLast,
+                          true_type /* memmove */) {
+    return copyBackwardAux(first, last, dstLast, true_type{});
+}
+
+// dispatch on <input is segmented, output is segmented>:
+// a segmented input is walked block by block, each block then goes to the
+// (possibly segmented) output; a segmented output is fed in pieces that
+// fit its blocks; two plain ranges end in the loop or the memmove above
+
+template <typename InIter, typename OutIter, typename AnyTag>
+inline OutIter copyDispatch(InIter first, InIter last, OutIter dst, true_type,
+                            AnyTag) {
+    forEachSegment(first, last, [&dst](auto lfirst, auto llast) {
+        dst = tiny_stl::copy(lfirst, llast, dst);
+    });
+    return dst;
+}
+
+template <typename InIter, typename OutIter>
+inline OutIter copyDispatch(InIter first, InIter last, OutIter dst,
+                            false_type, true_type) {
+    return segmentedOutput(first, last, dst, [](auto f, auto l, auto d) {
+        return tiny_stl::copy(f, l, d);
+    });
+}
+
+template <typename InIter, typename OutIter>
+inline OutIter copyDispatch(InIter first, InIter last, OutIter dst,
+                            false_type, false_type) {
+    return copyAux(first, last, dst, MemmoveIsSafe<InIter, OutIter>{});
+}
+
+template <typename BidIter1, typename BidIter2, typename AnyTag>
+inline BidIter2 copyBackwardDispatch(BidIter1 first, BidIter1 last,
+                                     BidIter2 dstLast, true_type, AnyTag) {
+    forEachSegmentBackward(first, last, [&dstLast](auto lfirst, auto llast) {
+        dstLast = tiny_stl::copy_backward(lfirst, llast, dstLast);
+    });
+    return dstLast;
+}
+
+template <typename BidIter1, typename BidIter2>
+inline BidIter2 copyBackwardDispatch(BidIter1 first, BidIter1 last,
+                                     BidIter2 dstLast, false_type, true_type) {
+    return segmentedOutputBackward(
+        first, last, dstLast, [](auto f, auto l, auto d) {
+            return tiny_stl::copy_backward(f, l, d);
+        });
+}
+
+template <typename BidIter1, typename BidIter2>
+inline BidIter2 copyBackwardDispatch(BidIter1 first, BidIter1 last,
+                                     BidIter2 dstLast, false_type,
+                                     false_type) {
+    return copyBackwardAux(first, last, dstLast,
+                           MemmoveIsSafe<BidIter1, BidIter2>{});
+}
+
+template <typename InIter, typename OutIter, typename AnyTag>
+inline OutIter moveDispatch(InIter first, InIter last, OutIter dst, true_type,
+                            AnyTag) {
+    forEachSegment(first, last, [&dst](auto lfirst, auto llast) {
+        dst = tiny_stl::move(lfirst, llast, dst);
+    });
+    return dst;
+}
+
+template <typename InIter, typename OutIter>
+inline OutIter moveDispatch(InIter first, InIter last, OutIter dst,
+                            false_type, true_type) {
+    return segmentedOutput(first, last, dst, [](auto f, auto l, auto d) {
+        return tiny_stl::move(f, l, d);
+    });
+}
+
+template <typename InIter, typename OutIter>
+inline OutIter moveDispatch(InIter first, InIter last, OutIter dst,
+                            false_type, false_type) {
+    return moveAux(first, last, dst, MemmoveIsSafe<InIter, OutIter>{});
+}
+
+template <typename BidIter1, typename BidIter2, typename AnyTag>
+inline BidIter2 moveBackwardDispatch(BidIter1 first, BidIter1 last,
+                                     BidIter2 dstLast, true_type, AnyTag) {
+    forEachSegmentBackward(first, last, [&dstLast](auto lfirst, auto llast) {
+        dstLast = tiny_stl::move_backward(lfirst, llast, dstLast);
+    });
+    return dstLast;
+}
+
+template <typename BidIter1, typename BidIter2>
+inline BidIter2 moveBackwardDispatch(BidIter1 first, BidIter1 last,
+                                     BidIter2 dstLast, false_type, true_type) {
+    return segmentedOutputBackward(
+        first, last, dstLast, [](auto f, auto l, auto d) {
+            return tiny_stl::move_backward(f, l, d);
+        });
+}
+
+template <typename BidIter1, typename BidIter2>
+inline BidIter2 moveBackwardDispatch(BidIter1 first, BidIter1 last,
+                                     BidIter2 dstLast, false_type,
+                                     false_type) {
+    return moveBackwardAux(first, last, dstLast,
+                           MemmoveIsSafe<BidIter1, BidIter2>{});
+}
+
+// segmented output needs the input length up front
+template <typename InIter, typename OutIter>
+using SegmentedOutputTag = typename conjunction<
+    IsSegmentedIterator<OutIter>,
+    is_convertible<typename iterator_traits<InIter>::iterator_category,
+                   random_access_iterator_tag>>::type;
+
+} // namespace details
+
+template <typename InIter, typename OutIter>
+inline OutIter copy(InIter first, InIter last, OutIter dst) {
+    return details::copyDispatch(
+        first, last, dst, IsSegmentedIterator<InIter>{},
+        details::SegmentedOutputTag<InIter, OutIter>{});
+}
+
+template <typename InIter, typename Size, typename OutIter>
+inline OutIter copy_n(InIter src, Size count, OutIter dst) {
+    for (; count > 0; --count, ++src, ++dst)
+        *dst = *src;
+
+    return dst;
+}
+
+template <typename BidIter1, typename BidIter2>
+inline BidIter2 copy_backward(BidIter1 first, BidIter1 last, BidIter2 dstLast) {
+    return details::copyBackwardDispatch(
+        first, last, dstLast, IsSegmentedIterator<BidIter1>{},
+        details::SegmentedOutputTag<BidIter1, BidIter2>{});
+}
+
+template <typename InIter, typename OutIter>
+inline OutIter move(InIter first, InIter last, OutIter dstFirst) {
+    return details::moveDispatch(
+        first, last, dstFirst, IsSegmentedIterator<InIter>{},
+        details::SegmentedOutputTag<InIter, OutIter>{});
+}
+
+template <typename BidIter1, typename BidIter2>
+inline BidIter2 move_backward(BidIter1 first, BidIter1 last, BidIter2 dstLast) {
+    return details::moveBackwardDispatch(
+        first, last, dstLast, IsSegmentedIterator<BidIter1>{},
+        details::SegmentedOutputTag<BidIter1, BidIter2>{});
+}
+
 template <typename FwdIter1, typename FwdIter2>
 inline FwdIter2 swap_ranges(FwdIter1 first1, FwdIter1 last1, FwdIter2 first2) {
     for (; first1 != last1; ++first1, ++first2)
@@ -337,11 +789,43 @@ constexpr FwdIter min_element(FwdIter first, FwdIter last, Cmp cmp) {
     return max_iter;
 }
 
+namespace details {
+
+template <typename T>
+inline bool simdIsNan(const T& x) {
+    return x != x;
+}
+
 template <typename FwdIter>
-constexpr FwdIter min_element(FwdIter first, FwdIter last) {
+constexpr FwdIter minElementAux(FwdIter first, FwdIter last, false_type) {
     return tiny_stl::min_element(first, last, tiny_stl::less<>{});
 }
 
+// the smallest value, then its first position; a NaN *first stays the result
+template <typename ContIter>
+inline ContIter minElementAux(ContIter first, ContIter last, true_type) {
+    using Traits = ContiguousIteratorTraits<ContIter>;
+    using V = remove_cv_t<IteratorValueType<ContIter>>;
+
+    if (first == last || simdIsNan(*first))
+        return first;
+
+    const auto p = Traits::toPointer(first);
+    const auto q = Traits::toPointer(last);
+    V lo;
+    simdRun<SimdBounds<true, false, false>, V>(p, q, &lo,
+                                                static_cast<V*>(nullptr));
+    return Traits::fromPointer(first, p + (simdRun<SimdFind, V>(p, q, lo) - p));
+}
+
+} // namespace details
+
+template <typename FwdIter>
+constexpr FwdIter min_element(FwdIter first, FwdIter last) {
+    return details::minElementAux(first, last,
+                                  details::IsSimdRange<FwdIter>{});
+}
+
 template <typename T, typename Cmp>
 constexpr const T& min(const T& a, const T& b, Cmp cmp) {
     return cmp(a, b) ? a : b;
@@ -375,11 +859,37 @@ constexpr FwdIter max_element(FwdIter first, FwdIter last, Cmp cmp) {
     return max_iter;
 }
 
+namespace details {
+
 template <typename FwdIter>
-constexpr FwdIter max_element(FwdIter first, FwdIter last) {
+constexpr FwdIter maxElementAux(FwdIter first, FwdIter last, false_type) {
     return tiny_stl::max_element(first, last, tiny_stl::less<>{});
 }
 
+template <typename ContIter>
+inline ContIter maxElementAux(ContIter first, ContIter last, true_type) {
+    using Traits = ContiguousIteratorTraits<ContIter>;
+    using V = remove_cv_t<IteratorValueType<ContIter>>;
+
+    if (first == last || simdIsNan(*first))
+        return first;
+
+    const auto p = Traits::toPointer(first);
+    const auto q = Traits::toPointer(last);
+    V hi;
+    simdRun<SimdBounds<false, true, false>, V>(p, q, static_cast<V*>(nullptr),
+                                                &hi);
+    return Traits::fromPointer(first, p + (simdRun<SimdFind, V>(p, q, hi) - p));
+}
+
+} // namespace details
+
+template <typename FwdIter>
+constexpr FwdIter max_element(FwdIter first, FwdIter last) {
+    return details::maxElementAux(first, last,
+                                  details::IsSimdRange<FwdIter>{});
+}
+
 template <typename T, typename Cmp>
 constexpr const T& max(const T& a, const T& b, Cmp cmp) {
     return cmp(a, b) ? b : a;
@@ -455,9 +965,46 @@ inline pair<FwdIter, FwdIter> minmax_element(FwdIter first, FwdIter last,
     return ret;
 }
 
+namespace details {
+
+template <typename FwdIter>
+inline pair<FwdIter, FwdIter> minmaxElementAux(FwdIter first, FwdIter last,
+                                               false_type) {
+    return tiny_stl::minmax_element(first, last, tiny_stl::less<>{});
+}
+
+// first smallest and last largest; with a NaN in the range the pairwise scan
+// above gives different answers than skipping it, so it runs that scan
+template <typename ContIter>
+inline pair<ContIter, ContIter> minmaxElementAux(ContIter first, ContIter last,
+                                                 true_type) {
+    using Traits = ContiguousIteratorTraits<ContIter>;
+    using V = remove_cv_t<IteratorValueType<ContIter>>;
+    using Bounds = SimdBounds<true, true, is_floating_point<V>::value>;
+    using Result = pair<ContIter, ContIter>;
+
+    if (first == last)
+        return Result(first, first);
+
+    const auto p = Traits::toPointer(first);
+    const auto q = Traits::toPointer(last);
+    V lo;
+    V hi;
+    if (!simdRun<Bounds, V>(p, q, &lo, &hi))
+        return minmaxElementAux(first, last, false_type{});
+
+    const auto loPos = simdRun<SimdFind, V>(p, q, lo);
+    const auto hiPos = simdRun<SimdFindLast, V>(p, q, hi);
+    return Result(Traits::fromPointer(first, p + (loPos - p)),
+                  Traits::fromPointer(first, p + (hiPos - p)));
+}
+
+} // namespace details
+
 template <typename FwdIter>
 inline pair<FwdIter, FwdIter> minmax_element(FwdIter first, FwdIter last) {
-    return tiny_stl::minmax_element(first, last, tiny_stl::less<>{});
+    return details::minmaxElementAux(first, last,
+                                     details::IsSimdRange<FwdIter>{});
 }
 
 template <typename T>
@@ -566,8 +1113,8 @@ inline void adjustHeapHelper(RanIter first, Diff hole, Diff len, T&& val,
 
     // have a right child
     while (rightChild < len) {
-        if (*(first + rightChild) <
-            *(first + (rightChild - 1))) // left child > right child
+        if (cmp(*(first + rightChild),
+                *(first + (rightChild - 1)))) // left child > right child
             --rightChild;
         *(first + hole) = tiny_stl::move(
             *(first + rightChild));      // move the bigger one to the hole
@@ -597,7 +1144,151 @@ inline void popHeapHelper(RanIter first, RanIter last, RanIter dst, T&& val,
                      static_cast<Diff>(last - first), tiny_stl::move(val), cmp);
 }
 
-} // namespace details
+// d-ary heaps, the children of i are i * D + 1 ... i * D + D. A wider
+// node makes the heap shallower and keeps the children of a node next to
+// each other, at the cost of D - 1 comparisons to find the largest one.
+//
+// moved(i) is called whenever an element is stored at index i, which lets
+// an addressable heap keep track of where its elements are.
+struct NotTracked {
+    template <typename Diff>
+    void operator()(Diff) const noexcept {
+    }
+};
+
+template <std::size_t D, typename RanIter, typename Diff, typename T,
+          typename Cmp, typename Moved>
+inline void siftUpDHeap(RanIter first, Diff hole, Diff top, T&& val,
+                        Cmp& cmp, Moved moved) {
+    while (top < hole) {
+        const Diff parent = (hole - 1) / static_cast<Diff>(D);
+        if (!cmp(*(first + parent), val))
+            break;
+
+        *(first + hole) = tiny_stl::move(*(first + parent));
+        moved(hole);
+        hole = parent;
+    }
+
+    *(first + hole) = tiny_stl::move(val);
+    moved(hole);
+}
+
+// Moves the largest child into the hole until the hole reaches a leaf,
+// then sifts val up from there. val mostly comes from the bottom and
+// belongs near it again, so this skips comparing it on every level down.
+template <std::size_t D, typename RanIter, typename Diff, typename T,
+          typename Cmp, typename Moved>
+inline void adjustDHeap(RanIter first, Diff hole, Diff len, T&& val,
+                        Cmp& cmp, Moved moved) {
+    const Diff top = hole;
+    const Diff d = static_cast<Diff>(D);
+    // elements per cache line
+    constexpr Diff kPrefetchStride = static_cast<Diff>(
+        sizeof(*first) >= TINY_STL_CACHE_LINE_SIZE
+            ? 1
+            : TINY_STL_CACHE_LINE_SIZE / sizeof(*first));
+    Diff child = hole * d + 1;
+
+    // all D children exist
+    while (len - child >= d) {
+        // the next level is contiguous, fetch it while comparing this one
+        const Diff grand = child * d + 1;
+        if (grand < len) {
+            const Diff span = tiny_stl::min(d * d, len - grand);
+            for (Diff i = 0; i < span; i += kPrefetchStride)
+                TINY_STL_PREFETCH(tiny_stl::addressof(*(first + (grand + i))));
+            // the block needn't start on a line boundary
+            TINY_STL_PREFETCH(
+                tiny_stl::addressof(*(first + (grand + span - 1))));
+        }
+
+        // pairwise, so the comparisons don't form one dependency chain
+        Diff best[D];
+        for (Diff i = 0; i < d; ++i)
+            best[i] = child + i;
+        for (Diff w = 1; w < d; w *= 2)
+            for (Diff i = 0; i + w < d; i += 2 * w)
+                best[i] = cmp(*(first + best[i]), *(first + best[i + w]))
+                              ? best[i + w]
+                              : best[i];
+
+        *(first + hole) = tiny_stl::move(*(first + best[0]));
+        moved(hole);
+        hole = best[0];
+        child = hole * d + 1;
+    }
+
+    // the last inner node may have fewer children
+    if (child < len) {
+        Diff best = child;
+        for (Diff i = child + 1; i < len; ++i)
+            if (cmp(*(first + best), *(first + i)))
+                best = i;
+
+        *(first + hole) = tiny_stl::move(*(first + best));
+        moved(hole);
+        hole = best;
+    }
+
+    details::siftUpDHeap<D>(first, hole, top, tiny_stl::move(val), cmp,
+                            moved);
+}
+
+// [first, last - 1) is a heap, add *(last - 1)
+template <std::size_t D, typename RanIter, typename Cmp>
+inline void pushDHeap(RanIter first, RanIter last, Cmp& cmp) {
+    using Diff = typename iterator_traits<RanIter>::difference_type;
+    Diff count = last - first;
+    if (count >= 2) {
+        auto val = tiny_stl::move(*--last);
+        details::siftUpDHeap<D>(first, --count, static_cast<Diff>(0),
+                                tiny_stl::move(val), cmp, NotTracked{});
+    }
+}
+
+// move the largest element to last - 1 and make [first, last - 1) a heap
+template <std::size_t D, typename RanIter, typename Cmp>
+inline void popDHeap(RanIter first, RanIter last, Cmp& cmp) {
+    using Diff = typename iterator_traits<RanIter>::difference_type;
+    if (last - first < 2)
+        return;
+
+    --last;
+    auto val = tiny_stl::move(*last);
+    *last = tiny_stl::move(*first);
+    details::adjustDHeap<D>(first, static_cast<Diff>(0),
+                            static_cast<Diff>(last - first),
+                            tiny_stl::move(val), cmp, NotTracked{});
+}
+
+template <std::size_t D, typename RanIter, typename Cmp>
+inline void makeDHeap(RanIter first, RanIter last, Cmp& cmp) {
+    using Diff = typename iterator_traits<RanIter>::difference_type;
+    const Diff len = last - first;
+    if (len < 2)
+        return;
+
+    for (Diff parent = (len - 2) / static_cast<Diff>(D);; --parent) {
+        auto val = tiny_stl::move(*(first + parent));
+        details::adjustDHeap<D>(first, parent, len, tiny_stl::move(val),
+                                cmp, NotTracked{});
+        if (parent == 0)
+            return;
+    }
+}
+
+template <std::size_t D, typename RanIter, typename Cmp>
+inline bool isDHeap(RanIter first, RanIter last, Cmp& cmp) {
+    using Diff = typename iterator_traits<RanIter>::difference_type;
+    const Diff len = last - first;
+    for (Diff i = 1; i < len; ++i)
+        if (cmp(*(first + (i - 1) / static_cast<Diff>(D)), *(first + i)))
+            return false;
+    return true;
+}
+
+} // namespace details
 
 template <typename RanIter, typename Cmp>
 inline void push_heap(RanIter first, RanIter last, Cmp cmp) {
@@ -631,7 +1322,7 @@ inline void pop_heap(RanIter first, RanIter last) {
 template <typename RanIter, typename Cmp>
 inline void sort_heap(RanIter first, RanIter last, Cmp cmp) {
     for (; last - first > 1; --last)
-        tiny_stl::pop_heap(first, last);
+        tiny_stl::pop_heap(first, last, cmp);
 }
 
 template <typename RanIter>
@@ -790,90 +1481,1612 @@ inline void quickSort(RanIter first, RanIter last, IterDiffType<RanIter> diff,
     }
 }
 
+// sort goes through this class so that a container whose iterators sort
+// faster some other way can specialize it, a sort overload would either be
+// missed by the qualified calls or make unqualified ones ambiguous (ADL)
+template <typename RanIter>
+struct SortDispatch {
+    template <typename Compare>
+    static void sort(RanIter first, RanIter last, Compare& cmp) {
+        if (last - first - 1 > 0) {
+            quickSort(first, last, last - first, cmp);
+        }
+    }
+};
+
 } // namespace details
 
 template <typename RanIter, typename Compare>
 inline void sort(RanIter first, RanIter last, Compare cmp) {
-    if (last - first - 1 > 0) {
-        details::quickSort(first, last, last - first, cmp);
-    }
+    details::SortDispatch<RanIter>::sort(first, last, cmp);
 }
 
 template <typename RanIter>
 inline void sort(RanIter first, RanIter last) {
-    sort(first, last, tiny_stl::less<>{});
+    tiny_stl::sort(first, last, tiny_stl::less<>{});
 }
 
-template <typename FwdIter, typename T, typename Compare>
-inline FwdIter lower_bound(FwdIter first, FwdIter last, const T& val,
-                           Compare cmp) {
-    assert(is_sorted(first, last, cmp));
+namespace details {
 
-    FwdIter ret = first;
-    using Diff = typename iterator_traits<FwdIter>::difference_type;
-    Diff size = tiny_stl::distance(first, last);
-    Diff step = 0;
+// Uninitialized storage for a scratch copy of (part of) a range. moveFrom
+// constructs a prefix by moving from a range, and destroy or the
+// destructor ends it; trivial types may also be assigned into the raw
+// storage directly.
+template <typename T>
+class TempBuffer {
+private:
+    T* ptr;
+    std::ptrdiff_t len;
+    std::ptrdiff_t constructed;
+
+public:
+    explicit TempBuffer(std::ptrdiff_t n)
+        : ptr(static_cast<T*>(::operator new(n * sizeof(T)))), len(n),
+          constructed(0) {
+    }
 
-    while (size > 0) {
-        ret = first;
-        step = size >> 1;
-        tiny_stl::advance(ret, step);
+    // as much as can be allocated of n elements, possibly none
+    TempBuffer(std::ptrdiff_t n, const std::nothrow_t&) noexcept
+        : ptr(nullptr), len(0), constructed(0) {
+        const std::ptrdiff_t maxLen = PTRDIFF_MAX / sizeof(T);
+        for (n = n < maxLen ? n : maxLen; n > 0; n /= 2) {
+            ptr = static_cast<T*>(::operator new(n * sizeof(T), std::nothrow));
+            if (ptr != nullptr) {
+                len = n;
+                break;
+            }
+        }
+    }
 
-        if (!cmp(*ret, val)) { // left
-            size = step;
-        } else { // right
-            first = ++ret;
-            size -= (step + 1);
+    TempBuffer(const TempBuffer&) = delete;
+    TempBuffer& operator=(const TempBuffer&) = delete;
+
+    ~TempBuffer() {
+        destroy();
+        ::operator delete(ptr);
+    }
+
+    T* data() const noexcept {
+        return ptr;
+    }
+
+    std::ptrdiff_t size() const noexcept {
+        return len;
+    }
+
+    // move construct the first last - first slots, return their end
+    template <typename InIter>
+    T* moveFrom(InIter first, InIter last) {
+        assert(constructed == 0);
+        for (; first != last; ++constructed, ++first)
+            ::new (static_cast<void*>(ptr + constructed))
+                T(tiny_stl::move(*first));
+        return ptr + constructed;
+    }
+
+    // move construct the next slot from val, return the end of the slots
+    // constructed
+    template <typename U>
+    T* append(U& val) {
+        assert(constructed < len);
+        ::new (static_cast<void*>(ptr + constructed)) T(tiny_stl::move(val));
+        return ptr + ++constructed;
+    }
+
+    // every slot has been move constructed, in whatever order
+    void markConstructed() noexcept {
+        assert(constructed == 0);
+        constructed = len;
+    }
+
+    void destroy() noexcept {
+        for (; constructed > 0; --constructed)
+            ptr[constructed - 1].~T();
+    }
+};
+
+// radix_sort
+
+template <std::size_t Size>
+struct RadixUnsigned;
+
+template <>
+struct RadixUnsigned<1> {
+    using type = std::uint8_t;
+};
+
+template <>
+struct RadixUnsigned<2> {
+    using type = std::uint16_t;
+};
+
+template <>
+struct RadixUnsigned<4> {
+    using type = std::uint32_t;
+};
+
+template <>
+struct RadixUnsigned<8> {
+    using type = std::uint64_t;
+};
+
+// RadixKey<K>::bits maps a key to an unsigned integer of the same width
+// whose order is the order of the keys
+template <typename K,
+          int Kind = is_floating_point<K>::value ? 2
+                     : is_enum<K>::value         ? 3
+                     : is_signed<K>::value       ? 1
+                                                 : 0>
+struct RadixKey { // unsigned integers and bool
+    using type = typename RadixUnsigned<sizeof(K)>::type;
+
+    static type bits(K k) noexcept {
+        return static_cast<type>(k);
+    }
+};
+
+template <typename K>
+struct RadixKey<K, 1> { // signed integers, flip the sign bit
+    using type = typename RadixUnsigned<sizeof(K)>::type;
+
+    static type bits(K k) noexcept {
+        return static_cast<type>(static_cast<type>(k) ^
+                                 (type(1) << (sizeof(K) * 8 - 1)));
+    }
+};
+
+template <typename K>
+struct RadixKey<K, 2> { // IEEE floats, negatives are stored sign-magnitude
+    using type = typename RadixUnsigned<sizeof(K)>::type;
+
+    static type bits(K k) noexcept {
+        type u;
+        std::memcpy(&u, &k, sizeof(K));
+        const type sign = type(1) << (sizeof(K) * 8 - 1);
+        return static_cast<type>((u & sign) ? ~u : (u | sign));
+    }
+};
+
+template <typename K>
+struct RadixKey<K, 3> { // enumerations, by the underlying type
+    using Underlying = typename std::underlying_type<K>::type;
+    using type = typename RadixKey<Underlying>::type;
+
+    static type bits(K k) noexcept {
+        return RadixKey<Underlying>::bits(static_cast<Underlying>(k));
+    }
+};
+
+template <typename RanIter, typename KeyFn>
+using RadixKeyType = decay_t<decltype(
+    tiny_stl::declval<KeyFn&>()(*tiny_stl::declval<RanIter&>()))>;
+
+struct RadixIdentity {
+    template <typename T>
+    const T& operator()(const T& val) const noexcept {
+        return val;
+    }
+};
+
+// elements compare by their radix bits, to agree with the radix passes
+template <typename Key, typename KeyFn>
+struct RadixLess {
+    KeyFn& key;
+
+    template <typename T>
+    bool operator()(const T& lhs, const T& rhs) const {
+        return Key::bits(key(lhs)) < Key::bits(key(rhs));
+    }
+};
+
+// Least significant digit first, one stable counting pass per DigitBits
+// bits of the key. The histograms of all digits are built in a single read
+// of the range, and a digit that is the same for every element is skipped,
+// so narrow values in a wide type cost only the passes they need. The
+// passes alternate between the range and a buffer of n elements.
+template <unsigned DigitBits, typename RanIter, typename KeyFn>
+void lsdRadixSort(RanIter first, RanIter last, KeyFn& key) {
+    using T = typename iterator_traits<RanIter>::value_type;
+    using Key = RadixKey<RadixKeyType<RanIter, KeyFn>>;
+    using U = typename Key::type;
+
+    constexpr unsigned kPasses = (sizeof(U) * 8 + DigitBits - 1) / DigitBits;
+    constexpr std::size_t kBuckets = std::size_t(1) << DigitBits;
+    constexpr U kMask = static_cast<U>(kBuckets - 1);
+
+    const std::ptrdiff_t n = last - first;
+    TempBuffer<std::size_t> hist(kPasses * kBuckets);
+    std::size_t* const h = hist.data();
+    std::memset(h, 0, kPasses * kBuckets * sizeof(std::size_t));
+
+    for (RanIter it = first; it != last; ++it) {
+        const U u = Key::bits(key(*it));
+        for (unsigned p = 0; p < kPasses; ++p)
+            ++h[p * kBuckets + ((u >> (p * DigitBits)) & kMask)];
+    }
+
+    // The first pass into the buffer move constructs its slots out of
+    // order. A move that may throw would leave them untracked, so such
+    // elements are moved over in order up front and the passes start there.
+    constexpr bool kScatterConstruct =
+        !is_trivially_copyable<T>::value &&
+        is_nothrow_move_constructible<T>::value;
+    TempBuffer<T> buf(n);
+    T* const out = buf.data();
+    bool inBuffer = false;
+    bool needConstruct = kScatterConstruct;
+    if (!is_trivially_copyable<T>::value && !kScatterConstruct) {
+        buf.moveFrom(first, last);
+        inBuffer = true;
+    }
+
+    const U u0 = Key::bits(key(*first));
+    for (unsigned p = 0; p < kPasses; ++p) {
+        const unsigned shift = p * DigitBits;
+        std::size_t* const count = h + p * kBuckets;
+        if (count[(u0 >> shift) & kMask] == static_cast<std::size_t>(n))
+            continue;
+
+        std::size_t sum = 0;
+        for (std::size_t b = 0; b < kBuckets; ++b) {
+            const std::size_t c = count[b];
+            count[b] = sum;
+            sum += c;
+        }
+
+        if (!inBuffer && needConstruct) {
+            for (RanIter it = first; it != last; ++it) {
+                const U u = Key::bits(key(*it));
+                ::new (static_cast<void*>(out + count[(u >> shift) & kMask]++))
+                    T(tiny_stl::move(*it));
+            }
+            buf.markConstructed();
+            needConstruct = false;
+        } else if (!inBuffer) {
+            for (RanIter it = first; it != last; ++it) {
+                const U u = Key::bits(key(*it));
+                out[count[(u >> shift) & kMask]++] = tiny_stl::move(*it);
+            }
+        } else {
+            for (T* it = out; it != out + n; ++it) {
+                const U u = Key::bits(key(*it));
+                first[count[(u >> shift) & kMask]++] = tiny_stl::move(*it);
+            }
         }
+
+        inBuffer = !inBuffer;
     }
 
-    return ret;
+    if (inBuffer)
+        tiny_stl::move(out, out + n, first);
 }
 
-template <typename FwdIter, typename T>
-inline FwdIter lower_bound(FwdIter first, FwdIter last, const T& val) {
-    return tiny_stl::lower_bound(first, last, val, tiny_stl::less<>{});
+template <typename RanIter, typename KeyFn>
+void radixSortAux(RanIter first, RanIter last, KeyFn& key, true_type) {
+    using Key = RadixKey<RadixKeyType<RanIter, KeyFn>>;
+    using U = typename Key::type;
+
+    const std::ptrdiff_t n = last - first;
+    if (n <= INSERT_SORT_MAX) {
+        RadixLess<Key, KeyFn> cmp{key};
+        insertSort(first, last, cmp);
+        return;
+    }
+
+    // fewer passes pay off once the wider histograms are small next to n
+    if (sizeof(U) <= 2 || n < (std::ptrdiff_t(1) << 18))
+        lsdRadixSort<8>(first, last, key);
+    else if (n < (std::ptrdiff_t(1) << 22))
+        lsdRadixSort<11>(first, last, key);
+    else
+        lsdRadixSort<16>(first, last, key);
+}
+
+// bucket of a string at depth, 0 once it has ended
+template <typename Str>
+inline std::size_t radixCharBucket(const Str& s, std::size_t depth) {
+    return depth < s.size()
+               ? std::size_t(1) + static_cast<unsigned char>(s[depth])
+               : 0;
+}
+
+// orders strings that are equal up to depth
+template <typename KeyFn>
+struct RadixStringLess {
+    KeyFn& key;
+    std::size_t depth;
+
+    template <typename T>
+    bool operator()(const T& lhs, const T& rhs) const {
+        const auto& a = key(lhs);
+        const auto& b = key(rhs);
+        const std::size_t na = a.size();
+        const std::size_t nb = b.size();
+        for (std::size_t i = depth; i < na && i < nb; ++i) {
+            const auto ca = static_cast<unsigned char>(a[i]);
+            const auto cb = static_cast<unsigned char>(b[i]);
+            if (ca != cb)
+                return ca < cb;
+        }
+
+        return na < nb;
+    }
+};
+
+// Most significant digit first on one byte per level, permuted in place
+// (American flag sort): count the buckets, then swap every element into
+// the next free slot of its bucket, and recurse into each bucket at the
+// next depth. Not stable.
+template <typename RanIter, typename KeyFn>
+void msdRadixSort(RanIter first, RanIter last, std::size_t depth,
+                  KeyFn& key) {
+    constexpr std::size_t kBuckets = 257;
+
+    for (;;) {
+        const std::ptrdiff_t n = last - first;
+        if (n <= INSERT_SORT_MAX) {
+            RadixStringLess<KeyFn> cmp{key, depth};
+            insertSort(first, last, cmp);
+            return;
+        }
+
+        std::size_t count[kBuckets] = {};
+        for (RanIter it = first; it != last; ++it)
+            ++count[radixCharBucket(key(*it), depth)];
+
+        // all strings share the byte at depth, or have all ended
+        const std::size_t b0 = radixCharBucket(key(*first), depth);
+        if (count[b0] == static_cast<std::size_t>(n)) {
+            if (b0 == 0)
+                return;
+            ++depth;
+            continue;
+        }
+
+        std::size_t next[kBuckets];
+        std::size_t end[kBuckets];
+        std::size_t sum = 0;
+        for (std::size_t b = 0; b < kBuckets; ++b) {
+            next[b] = sum;
+            sum += count[b];
+            end[b] = sum;
+        }
+
+        for (std::size_t b = 0; b < kBuckets; ++b) {
+            while (next[b] < end[b]) {
+                const std::size_t d =
+                    radixCharBucket(key(first[next[b]]), depth);
+                if (d == b)
+                    ++next[b];
+                else
+                    tiny_stl::iter_swap(first + next[b], first + next[d]++);
+            }
+        }
+
+        // bucket 0 holds equal strings that have ended
+        for (std::size_t b = 1; b < kBuckets; ++b) {
+            if (count[b] > 1)
+                msdRadixSort(first + (end[b] - count[b]), first + end[b],
+                             depth + 1, key);
+        }
+        return;
+    }
 }
 
-template <typename FwdIter, typename T, typename Compare>
-inline FwdIter upper_bound(FwdIter first, FwdIter last, const T& val,
-                           Compare cmp) {
-    assert(is_sorted(first, last, cmp));
+template <typename RanIter, typename KeyFn>
+void radixSortString(RanIter first, RanIter last, KeyFn& key, true_type) {
+    msdRadixSort(first, last, 0, key);
+}
 
-    FwdIter ret = first;
-    using Diff = typename iterator_traits<FwdIter>::difference_type;
-    Diff size = tiny_stl::distance(first, last);
-    Diff step = 0;
+// characters wider than a byte fall back to comparison
+template <typename RanIter, typename KeyFn>
+void radixSortString(RanIter first, RanIter last, KeyFn& key, false_type) {
+    tiny_stl::sort(first, last, [&key](const auto& lhs, const auto& rhs) {
+        return key(lhs) < key(rhs);
+    });
+}
 
-    while (size > 0) {
-        ret = first;
-        step = size >> 1;
-        tiny_stl::advance(ret, step);
-        if (cmp(val, *ret)) { // left
-            size = step;
-        } else { // right
-            first = ++ret;
-            size -= (step + 1);
+template <typename RanIter, typename KeyFn>
+void radixSortAux(RanIter first, RanIter last, KeyFn& key, false_type) {
+    using Str = RadixKeyType<RanIter, KeyFn>;
+    using CharT = decay_t<decltype(tiny_stl::declval<const Str&>()[0])>;
+    radixSortString(first, last, key, bool_constant<sizeof(CharT) == 1>{});
+}
+
+} // namespace details
+
+// Sort by radix instead of comparison. Integers, floating point numbers,
+// enumerations and bool use a stable LSD radix sort in O(n) time and n
+// extra elements; floats order -0.0 before 0.0 and NaNs at the ends by
+// their sign. Strings (basic_string, basic_string_view, or anything with
+// size() and operator[]) use an in-place MSD radix sort, which isn't
+// stable. key(elem) gives the key to sort by, e.g. a member of a struct.
+template <typename RanIter, typename KeyFn>
+inline void radix_sort(RanIter first, RanIter last, KeyFn key) {
+    using K = details::RadixKeyType<RanIter, KeyFn>;
+    if (last - first > 1)
+        details::radixSortAux(
+            first, last, key,
+            bool_constant<is_arithmetic<K>::value || is_enum<K>::value>{});
+}
+
+template <typename RanIter>
+inline void radix_sort(RanIter first, RanIter last) {
+    tiny_stl::radix_sort(first, last, details::RadixIdentity{});
+}
+
+template <typename InIter1, typename InIter2, typename OutIter,
+          typename Compare>
+inline OutIter merge(InIter1 first1, InIter1 last1, InIter2 first2,
+                     InIter2 last2, OutIter dst, Compare cmp) {
+    for (; first1 != last1 && first2 != last2; ++dst) {
+        if (cmp(*first2, *first1)) {
+            *dst = *first2;
+            ++first2;
+        } else { // equal elements are taken from the first range first
+            *dst = *first1;
+            ++first1;
         }
     }
 
-    return ret;
+    dst = tiny_stl::copy(first1, last1, dst);
+    return tiny_stl::copy(first2, last2, dst);
 }
 
-template <typename FwdIter, typename T>
-inline FwdIter upper_bound(FwdIter first, FwdIter last, const T& val) {
-    return tiny_stl::upper_bound(first, last, val, tiny_stl::less<>{});
+template <typename InIter1, typename InIter2, typename OutIter>
+inline OutIter merge(InIter1 first1, InIter1 last1, InIter2 first2,
+                     InIter2 last2, OutIter dst) {
+    return tiny_stl::merge(first1, last1, first2, last2, dst,
+                           tiny_stl::less<>{});
+}
+
+namespace details {
+
+// pred is true for a prefix of [first, last), find its end by probing
+// offsets 0, 1, 3, 7, ... and then searching the last gap in halves. Costs
+// O(log k) when the answer is k elements in, where a binary search over the
+// whole range costs O(log n).
+template <typename RanIter, typename Pred>
+inline RanIter gallop(RanIter first, RanIter last, Pred pred) {
+    using Diff = IterDiffType<RanIter>;
+    const Diff n = last - first;
+    if (n == 0 || !pred(*first))
+        return first;
+
+    // pred(first[lo]) is true, the end is in (lo, hi]
+    Diff lo = 0;
+    Diff hi = 1;
+    while (hi < n && pred(first[hi])) {
+        lo = hi;
+        hi = hi * 2 + 1;
+    }
+    if (hi > n)
+        hi = n;
+
+    ++lo;
+    while (lo < hi) {
+        const Diff mid = lo + (hi - lo) / 2;
+        if (pred(first[mid]))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return first + lo;
+}
+
+// gallop to the first element that isn't less than val
+template <typename RanIter, typename T, typename Compare>
+inline RanIter gallopLower(RanIter first, RanIter last, const T& val,
+                           Compare& cmp) {
+    return gallop(first, last,
+                  [&](const auto& elem) { return cmp(elem, val); });
+}
+
+// gallop to the first element that is greater than val
+template <typename RanIter, typename T, typename Compare>
+inline RanIter gallopUpper(RanIter first, RanIter last, const T& val,
+                           Compare& cmp) {
+    return gallop(first, last,
+                  [&](const auto& elem) { return !cmp(val, elem); });
+}
+
+template <typename Compare>
+struct ReverseCompare {
+    Compare& cmp;
+
+    template <typename T1, typename T2>
+    bool operator()(T1&& lhs, T2&& rhs) const {
+        return cmp(tiny_stl::forward<T2>(rhs), tiny_stl::forward<T1>(lhs));
+    }
+};
+
+// wins in a row after which a merge gallops through the winning run
+static const std::ptrdiff_t MERGE_MIN_GALLOP = 7;
+
+// Merge the run [b, bEnd), moved out to a buffer, with the run [r, rEnd)
+// into dst, which trails r. Ties go to the buffered run. Once one side has
+// won MERGE_MIN_GALLOP times in a row it is likely to keep winning, so the
+// rest of its winning streak is found by galloping and moved in bulk.
+template <typename BufIter, typename RanIter, typename Compare>
+void mergeWithBuffer(BufIter b, BufIter bEnd, RanIter r, RanIter rEnd,
+                     RanIter dst, Compare& cmp) {
+    std::ptrdiff_t winsB = 0;
+    std::ptrdiff_t winsR = 0;
+    while (b != bEnd && r != rEnd) {
+        if (cmp(*r, *b)) {
+            *dst = tiny_stl::move(*r);
+            ++dst;
+            ++r;
+            winsB = 0;
+            if (++winsR >= MERGE_MIN_GALLOP) {
+                const RanIter e = gallopLower(r, rEnd, *b, cmp);
+                dst = tiny_stl::move(r, e, dst);
+                r = e;
+                winsR = 0;
+            }
+        } else {
+            *dst = tiny_stl::move(*b);
+            ++dst;
+            ++b;
+            winsR = 0;
+            if (++winsB >= MERGE_MIN_GALLOP && r != rEnd) {
+                const BufIter e = gallopUpper(b, bEnd, *r, cmp);
+                dst = tiny_stl::move(b, e, dst);
+                b = e;
+                winsB = 0;
+            }
+        }
+    }
+
+    // what's left of [r, rEnd) is already in place
+    tiny_stl::move(b, bEnd, dst);
+}
+
+// merge the sorted runs [first, mid) and [mid, last) using buf, which holds
+// at least the shorter of them
+template <typename RanIter, typename T, typename Compare>
+void mergeRunsWithBuffer(RanIter first, RanIter mid, RanIter last,
+                         TempBuffer<T>& buf, Compare& cmp) {
+    if (mid - first <= last - mid) {
+        T* const bEnd = buf.moveFrom(first, mid);
+        mergeWithBuffer(buf.data(), bEnd, mid, last, first, cmp);
+    } else {
+        // merge from the back, as a forward merge of the reversed runs
+        T* const bEnd = buf.moveFrom(mid, last);
+        ReverseCompare<Compare> rcmp{cmp};
+        mergeWithBuffer(tiny_stl::make_reverse_iterator(bEnd),
+                        tiny_stl::make_reverse_iterator(buf.data()),
+                        tiny_stl::make_reverse_iterator(mid),
+                        tiny_stl::make_reverse_iterator(first),
+                        tiny_stl::make_reverse_iterator(last), rcmp);
+    }
+    buf.destroy();
+}
+
+// Merge the sorted runs [first, mid) and [mid, last). With a buffer for the
+// shorter run it's a linear merge, otherwise the longer run is split at its
+// middle, the other one where that element belongs, and the inner parts are
+// rotated into place, down to pieces that fit the buffer. That's
+// O(n log n) without any buffer.
+template <typename RanIter, typename T, typename Compare>
+void mergeAdaptive(RanIter first, RanIter mid, RanIter last,
+                   TempBuffer<T>& buf, Compare& cmp) {
+    using Diff = IterDiffType<RanIter>;
+
+    for (;;) {
+        if (first == mid || mid == last)
+            return;
+
+        // skip the elements at either end that are already in place
+        first = gallopUpper(first, mid, *mid, cmp);
+        if (first == mid)
+            return;
+
+        const auto& leftMax = *(mid - 1);
+        last = gallop(tiny_stl::make_reverse_iterator(last),
+                      tiny_stl::make_reverse_iterator(mid),
+                      [&](const auto& elem) { return !cmp(elem, leftMax); })
+                   .base();
+
+        const Diff len1 = mid - first;
+        const Diff len2 = last - mid;
+        if (tiny_stl::min(len1, len2) <= buf.size()) {
+            mergeRunsWithBuffer(first, mid, last, buf, cmp);
+            return;
+        }
+
+        if (len1 == 1 && len2 == 1) {
+            tiny_stl::iter_swap(first, mid);
+            return;
+        }
+
+        RanIter cut1;
+        RanIter cut2;
+        if (len1 > len2) {
+            cut1 = first + len1 / 2;
+            cut2 = gallopLower(mid, last, *cut1, cmp);
+        } else {
+            cut2 = mid + len2 / 2;
+            cut1 = gallopUpper(first, mid, *cut2, cmp);
+        }
+
+        const RanIter newMid = tiny_stl::rotate(cut1, mid, cut2);
+        mergeAdaptive(first, cut1, newMid, buf, cmp);
+        first = newMid;
+        mid = cut2;
+    }
+}
+
+static const std::ptrdiff_t MERGE_MIN_RUN = 32;
+
+// Find the run that starts at first, reversing it if strictly descending,
+// and extend it to MERGE_MIN_RUN elements by insertion sort. Returns its end.
+template <typename RanIter, typename Compare>
+RanIter makeRun(RanIter first, RanIter last, Compare& cmp) {
+    RanIter runEnd = first + 1;
+    if (runEnd == last)
+        return last;
+
+    if (cmp(*runEnd, *first)) {
+        for (++runEnd; runEnd != last && cmp(*runEnd, *(runEnd - 1));)
+            ++runEnd;
+        tiny_stl::reverse(first, runEnd);
+    } else {
+        for (++runEnd; runEnd != last && !cmp(*runEnd, *(runEnd - 1));)
+            ++runEnd;
+    }
+
+    if (runEnd - first < MERGE_MIN_RUN) {
+        runEnd = last - first < MERGE_MIN_RUN ? last : first + MERGE_MIN_RUN;
+        insertSort(first, runEnd, cmp);
+    }
+
+    return runEnd;
+}
+
+// The power of the boundary between the adjacent runs [s1, s1 + n1) and
+// [s1 + n1, s1 + n1 + n2) of n elements: the depth of the node that splits
+// them in the binary tree over [0, 1), at the run midpoints scaled by 1/n.
+inline unsigned mergePower(std::size_t s1, std::size_t n1, std::size_t n2,
+                           std::size_t n) noexcept {
+    std::size_t a = 2 * s1 + n1; // 2 * the midpoint of the first run
+    std::size_t b = a + n1 + n2; // 2 * the midpoint of the second run
+    unsigned power = 0;
+    for (;;) {
+        ++power;
+        if (a >= n) {
+            a -= n;
+            b -= n;
+        } else if (b >= n) {
+            break;
+        }
+        a <<= 1;
+        b <<= 1;
+    }
+
+    return power;
+}
+
+// Powersort: find the natural runs from left to right and merge them in the
+// nearly optimal order given by the power of the boundaries between them.
+// Presorted or reversed input costs O(n) compares, and there's no buffer
+// to allocate when it's one run.
+template <typename RanIter, typename Compare>
+void powerSort(RanIter first, RanIter last, Compare& cmp) {
+    using T = typename iterator_traits<RanIter>::value_type;
+    using Diff = IterDiffType<RanIter>;
+
+    struct Run {
+        Diff start;
+        unsigned power; // of the boundary with the next run
+    };
+
+    const Diff n = last - first;
+    Diff begin = 0;
+    Diff end = makeRun(first, last, cmp) - first;
+    if (end == n)
+        return;
+
+    TempBuffer<T> buf((n + 1) / 2, std::nothrow);
+
+    // powers increase up the stack, so it holds at most one run per bit
+    Run stack[sizeof(Diff) * 8 + 1];
+    int top = 0;
+    while (end < n) {
+        const Diff next = makeRun(first + end, last, cmp) - first;
+        const unsigned power = mergePower(begin, end - begin, next - end, n);
+        while (top > 0 && stack[top - 1].power > power) {
+            const Diff start = stack[--top].start;
+            mergeAdaptive(first + start, first + begin, first + end, buf, cmp);
+            begin = start;
+        }
+
+        stack[top++] = Run{begin, power};
+        begin = end;
+        end = next;
+    }
+
+    while (top > 0) {
+        const Diff start = stack[--top].start;
+        mergeAdaptive(first + start, first + begin, last, buf, cmp);
+        begin = start;
+    }
+}
+
+} // namespace details
+
+// Merge the consecutive sorted ranges [first, mid) and [mid, last) in
+// place, stable. Uses a buffer for the shorter range if one can be
+// allocated, O(n log n) otherwise.
+template <typename RanIter, typename Compare>
+inline void inplace_merge(RanIter first, RanIter mid, RanIter last,
+                          Compare cmp) {
+    using T = typename iterator_traits<RanIter>::value_type;
+    details::TempBuffer<T> buf(tiny_stl::min(mid - first, last - mid),
+                               std::nothrow);
+    details::mergeAdaptive(first, mid, last, buf, cmp);
+}
+
+template <typename RanIter>
+inline void inplace_merge(RanIter first, RanIter mid, RanIter last) {
+    tiny_stl::inplace_merge(first, mid, last, tiny_stl::less<>{});
+}
+
+// Sort keeping the order of equivalent elements. Natural runs are found
+// and merged as in powersort, with galloping merges. O(n log n) with a
+// buffer of n / 2 elements, and O(n log^2 n) when it can't be allocated.
+template <typename RanIter, typename Compare>
+inline void stable_sort(RanIter first, RanIter last, Compare cmp) {
+    if (last - first < 2)
+        return;
+
+    if (last - first <= details::INSERT_SORT_MAX)
+        details::insertSort(first, last, cmp);
+    else
+        details::powerSort(first, last, cmp);
+}
+
+template <typename RanIter>
+inline void stable_sort(RanIter first, RanIter last) {
+    tiny_stl::stable_sort(first, last, tiny_stl::less<>{});
+}
+
+template <typename FwdIter, typename UnaryPred>
+inline FwdIter remove_if(FwdIter first, FwdIter last, UnaryPred pred);
+
+template <typename FwdIter, typename BinPred>
+inline FwdIter unique(FwdIter first, FwdIter last, BinPred pred);
+
+namespace details {
+
+template <typename Iter>
+using IsRanIter =
+    is_convertible<typename iterator_traits<Iter>::iterator_category,
+                   random_access_iterator_tag>;
+
+// Small trivially copyable elements behind random access iterators are
+// compacted without a branch per element: each one is written to the next
+// slot, and the slot only advances past those kept.
+template <typename Iter, typename V = IteratorValueType<Iter>>
+struct IsBranchlessCompact
+    : conjunction<IsRanIter<Iter>, is_trivially_copyable<V>,
+                  bool_constant<sizeof(V) <= 16>> {};
+
+// remove and unique with == pack 32 and 64 bit elements with the vector
+// kernels, narrower elements aren't worth a shuffle table per width
+template <typename Iter, typename V = remove_cv_t<IteratorValueType<Iter>>>
+struct IsSimdCompress
+    : conjunction<IsSimdRange<Iter>, bool_constant<sizeof(V) >= 4>> {};
+
+template <typename FwdIter, typename UnaryPred>
+inline FwdIter removeIfAux(FwdIter first, FwdIter last, UnaryPred& pred,
+                           false_type) {
+    FwdIter out = first;
+    for (++first; first != last; ++first) {
+        if (!pred(*first)) {
+            *out = tiny_stl::move(*first);
+            ++out;
+        }
+    }
+
+    return out;
+}
+
+template <typename RanIter, typename UnaryPred>
+inline RanIter removeIfAux(RanIter first, RanIter last, UnaryPred& pred,
+                           true_type) {
+    using V = IteratorValueType<RanIter>;
+
+    RanIter out = first;
+    for (++first; first != last; ++first) {
+        const V x = *first;
+        *out = x;
+        out += pred(x) ? 0 : 1;
+    }
+
+    return out;
+}
+
+template <typename FwdIter, typename T>
+inline FwdIter removeAux(FwdIter first, FwdIter last, const T& val,
+                         false_type) {
+    return tiny_stl::remove_if(first, last,
+                               [&val](const auto& v) { return v == val; });
+}
+
+template <typename ContIter, typename T>
+inline ContIter removeAux(ContIter first, ContIter last, const T& val,
+                          true_type) {
+    using Traits = ContiguousIteratorTraits<ContIter>;
+    using V = remove_cv_t<IteratorValueType<ContIter>>;
+
+    if (!simdSearchKey<V>(val))
+        return last;
+
+    const auto p = Traits::toPointer(first);
+    const auto end = simdRun<SimdCompress<false>, V>(
+        p, Traits::toPointer(last), static_cast<V>(val));
+    return Traits::fromPointer(first, end);
+}
+
+// out is the last element kept and out + 1 the first dropped, first is
+// after it
+template <typename FwdIter, typename BinPred>
+inline FwdIter uniqueAux(FwdIter out, FwdIter first, FwdIter last,
+                         BinPred& pred, false_type) {
+    for (; first != last; ++first) {
+        if (!pred(*out, *first))
+            *++out = tiny_stl::move(*first);
+    }
+
+    return ++out;
+}
+
+// out + 1 <= first, so the element at first may be written there before
+// it is known to be kept
+template <typename RanIter, typename BinPred>
+inline RanIter uniqueAux(RanIter out, RanIter first, RanIter last,
+                         BinPred& pred, true_type) {
+    using V = IteratorValueType<RanIter>;
+
+    V kept = *out;
+    for (; first != last; ++first) {
+        const V x = *first;
+        out[1] = x;
+        const bool keep = !pred(kept, x);
+        kept = keep ? x : kept;
+        out += keep ? 1 : 0;
+    }
+
+    return ++out;
+}
+
+template <typename FwdIter>
+inline FwdIter uniqueSimdAux(FwdIter first, FwdIter last, false_type) {
+    return tiny_stl::unique(first, last, tiny_stl::equal_to<>{});
+}
+
+template <typename ContIter>
+inline ContIter uniqueSimdAux(ContIter first, ContIter last, true_type) {
+    using Traits = ContiguousIteratorTraits<ContIter>;
+    using V = remove_cv_t<IteratorValueType<ContIter>>;
+
+    const auto end = simdRun<SimdCompress<true>, V>(
+        Traits::toPointer(first), Traits::toPointer(last), V());
+    return Traits::fromPointer(first, end);
+}
+
+} // namespace details
+
+// Move the elements for which pred is false to the front, keeping their
+// order, and return the end of them.
+template <typename FwdIter, typename UnaryPred>
+inline FwdIter remove_if(FwdIter first, FwdIter last, UnaryPred pred) {
+    first = tiny_stl::find_if(first, last, pred);
+    if (first == last)
+        return first;
+
+    return details::removeIfAux(first, last, pred,
+                                details::IsBranchlessCompact<FwdIter>{});
+}
+
+template <typename FwdIter, typename T>
+inline FwdIter remove(FwdIter first, FwdIter last, const T& val) {
+    return details::removeAux(
+        first, last, val,
+        conjunction<details::IsSimdCompress<FwdIter>,
+                    details::IsSimdSearch<FwdIter, T>>{});
+}
+
+// Keep the first element of each run of consecutive elements that pred
+// finds equal to it, and return the end of those kept.
+template <typename FwdIter, typename BinPred>
+inline FwdIter unique(FwdIter first, FwdIter last, BinPred pred) {
+    if (first == last)
+        return last;
+
+    for (FwdIter next = first; ++next != last; first = next) {
+        if (pred(*first, *next)) {
+            return details::uniqueAux(
+                first, ++next, last, pred,
+                details::IsBranchlessCompact<FwdIter>{});
+        }
+    }
+
+    return last;
+}
+
+template <typename FwdIter>
+inline FwdIter unique(FwdIter first, FwdIter last) {
+    return details::uniqueSimdAux(first, last,
+                                  details::IsSimdCompress<FwdIter>{});
+}
+
+namespace details {
+
+template <typename FwdIter, typename UnaryPred>
+inline FwdIter partitionAux(FwdIter first, FwdIter last, UnaryPred& pred,
+                            forward_iterator_tag) {
+    first = tiny_stl::find_if_not(first, last, pred);
+    if (first == last)
+        return first;
+
+    for (FwdIter next = tiny_stl::next(first); next != last; ++next) {
+        if (pred(*next)) {
+            tiny_stl::iter_swap(first, next);
+            ++first;
+        }
+    }
+
+    return first;
+}
+
+// swap the first misplaced element from the left with the first one from
+// the right
+template <typename BidIter, typename UnaryPred>
+inline BidIter partitionAux(BidIter first, BidIter last, UnaryPred& pred,
+                            bidirectional_iterator_tag) {
+    for (;; ++first) {
+        for (;; ++first) {
+            if (first == last)
+                return first;
+            if (!pred(*first))
+                break;
+        }
+
+        do {
+            if (first == --last)
+                return first;
+        } while (!pred(*last));
+
+        tiny_stl::iter_swap(first, last);
+    }
+}
+
+template <typename RanIter, typename UnaryPred>
+inline RanIter partitionRanAux(RanIter first, RanIter last, UnaryPred& pred,
+                               false_type) {
+    return partitionAux(first, last, pred, bidirectional_iterator_tag{});
+}
+
+// Each element is swapped with the first one of the false part, or with
+// itself while there is none, and pred decides whether the true part grows
+// over it.
+template <typename RanIter, typename UnaryPred>
+inline RanIter partitionRanAux(RanIter first, RanIter last, UnaryPred& pred,
+                               true_type) {
+    using V = IteratorValueType<RanIter>;
+
+    RanIter out = first;
+    for (; first != last; ++first) {
+        const V x = *first;
+        *first = *out;
+        *out = x;
+        out += pred(x) ? 1 : 0;
+    }
+
+    return out;
+}
+
+template <typename RanIter, typename UnaryPred>
+inline RanIter partitionAux(RanIter first, RanIter last, UnaryPred& pred,
+                            random_access_iterator_tag) {
+    return partitionRanAux(first, last, pred, IsBranchlessCompact<RanIter>{});
+}
+
+template <typename BidIter, typename UnaryPred, typename T>
+inline BidIter stablePartitionBuffered(BidIter first, BidIter last,
+                                       UnaryPred& pred, TempBuffer<T>& buf,
+                                       false_type) {
+    first = tiny_stl::find_if_not(first, last, pred);
+    if (first == last)
+        return first;
+
+    // out is behind first from here on, no element moves onto itself
+    BidIter out = first;
+    T* end = buf.append(*first);
+    for (++first; first != last; ++first) {
+        if (pred(*first)) {
+            *out = tiny_stl::move(*first);
+            ++out;
+        } else {
+            end = buf.append(*first);
+        }
+    }
+
+    tiny_stl::move(buf.data(), end, out);
+    buf.destroy();
+    return out;
+}
+
+// Every element is written to both sides and one of them keeps it. With n
+// false elements so far the true ones end n behind, so n is all that moves.
+template <typename RanIter, typename UnaryPred, typename T>
+inline RanIter stablePartitionBuffered(RanIter first, RanIter last,
+                                       UnaryPred& pred, TempBuffer<T>& buf,
+                                       true_type) {
+    T* const data = buf.data();
+    IterDiffType<RanIter> n = 0;
+    for (; first != last; ++first) {
+        const T x = *first;
+        *(first - n) = x;
+        data[n] = x;
+        n += pred(x) ? 0 : 1;
+    }
+
+    tiny_stl::copy(data, data + n, last - n);
+    return last - n;
+}
+
+// Partition the halves and rotate the false part of the left one past the
+// true part of the right one, down to pieces the buffer holds. O(n) with a
+// buffer of n elements, O(n log n) swaps without one.
+template <typename BidIter, typename UnaryPred, typename T>
+inline BidIter stablePartitionAux(BidIter first, BidIter last,
+                                  UnaryPred& pred, TempBuffer<T>& buf,
+                                  IterDiffType<BidIter> n) {
+    if (n <= buf.size()) {
+        return stablePartitionBuffered(first, last, pred, buf,
+                                       IsBranchlessCompact<BidIter>{});
+    }
+
+    if (n == 1)
+        return pred(*first) ? last : first;
+
+    const BidIter mid = tiny_stl::next(first, n / 2);
+    const BidIter left = stablePartitionAux(first, mid, pred, buf, n / 2);
+    const BidIter right =
+        stablePartitionAux(mid, last, pred, buf, n - n / 2);
+    return tiny_stl::rotate(left, mid, right);
+}
+
+} // namespace details
+
+// Move the elements for which pred is true before the others and return the
+// end of them.
+template <typename FwdIter, typename UnaryPred>
+inline FwdIter partition(FwdIter first, FwdIter last, UnaryPred pred) {
+    return details::partitionAux(
+        first, last, pred,
+        typename iterator_traits<FwdIter>::iterator_category{});
+}
+
+// partition keeping the order of the elements within each part
+template <typename BidIter, typename UnaryPred>
+inline BidIter stable_partition(BidIter first, BidIter last, UnaryPred pred) {
+    using T = details::IteratorValueType<BidIter>;
+
+    first = tiny_stl::find_if_not(first, last, pred);
+    const auto n = tiny_stl::distance(first, last);
+    if (n == 0)
+        return first;
+
+    details::TempBuffer<T> buf(n, std::nothrow);
+    return details::stablePartitionAux(first, last, pred, buf, n);
+}
+
+template <typename InIter1, typename InIter2, typename OutIter,
+          typename Compare>
+inline OutIter set_union(InIter1 first1, InIter1 last1, InIter2 first2,
+                         InIter2 last2, OutIter dst, Compare cmp) {
+    for (; first1 != last1 && first2 != last2; ++dst) {
+        if (cmp(*first2, *first1)) {
+            *dst = *first2;
+            ++first2;
+        } else { // equivalent elements are taken once, from the first range
+            if (!cmp(*first1, *first2))
+                ++first2;
+            *dst = *first1;
+            ++first1;
+        }
+    }
+
+    dst = tiny_stl::copy(first1, last1, dst);
+    return tiny_stl::copy(first2, last2, dst);
+}
+
+template <typename InIter1, typename InIter2, typename OutIter>
+inline OutIter set_union(InIter1 first1, InIter1 last1, InIter2 first2,
+                         InIter2 last2, OutIter dst) {
+    return tiny_stl::set_union(first1, last1, first2, last2, dst,
+                               tiny_stl::less<>{});
+}
+
+namespace details {
+
+// a range this many times longer than the other is galloped through, below
+// that the gallops cost more than the merge steps they skip
+static const std::ptrdiff_t SET_GALLOP_RATIO = 64;
+
+template <typename InIter1, typename InIter2, typename OutIter,
+          typename Compare>
+inline OutIter setIntersectionAux(InIter1 first1, InIter1 last1,
+                                  InIter2 first2, InIter2 last2, OutIter dst,
+                                  Compare& cmp, false_type) {
+    while (first1 != last1 && first2 != last2) {
+        if (cmp(*first1, *first2)) {
+            ++first1;
+        } else if (cmp(*first2, *first1)) {
+            ++first2;
+        } else {
+            *dst = *first1;
+            ++first1;
+            ++first2;
+            ++dst;
+        }
+    }
+
+    return dst;
+}
+
+// Each element of the short range gallops from where the last one stopped
+// in the long range, O(m log(n / m)) comparisons for m elements in one and
+// n in the other. The output comes from the first range either way.
+template <typename RanIter1, typename RanIter2, typename OutIter,
+          typename Compare>
+inline OutIter setIntersectionAux(RanIter1 first1, RanIter1 last1,
+                                  RanIter2 first2, RanIter2 last2,
+                                  OutIter dst, Compare& cmp, true_type) {
+    const auto n1 = last1 - first1;
+    const auto n2 = last2 - first2;
+
+    if (n1 >= n2 * SET_GALLOP_RATIO) {
+        for (; first2 != last2 && first1 != last1; ++first2) {
+            first1 = gallopLower(first1, last1, *first2, cmp);
+            if (first1 != last1 && !cmp(*first2, *first1)) {
+                *dst = *first1;
+                ++dst;
+                ++first1;
+            }
+        }
+
+        return dst;
+    }
+
+    if (n2 >= n1 * SET_GALLOP_RATIO) {
+        for (; first1 != last1 && first2 != last2; ++first1) {
+            first2 = gallopLower(first2, last2, *first1, cmp);
+            if (first2 != last2 && !cmp(*first1, *first2)) {
+                *dst = *first1;
+                ++dst;
+                ++first2;
+            }
+        }
+
+        return dst;
+    }
+
+    return setIntersectionAux(first1, last1, first2, last2, dst, cmp,
+                              false_type{});
+}
+
+} // namespace details
+
+template <typename InIter1, typename InIter2, typename OutIter,
+          typename Compare>
+inline OutIter set_intersection(InIter1 first1, InIter1 last1, InIter2 first2,
+                                InIter2 last2, OutIter dst, Compare cmp) {
+    return details::setIntersectionAux(
+        first1, last1, first2, last2, dst, cmp,
+        conjunction<details::IsRanIter<InIter1>,
+                    details::IsRanIter<InIter2>>{});
+}
+
+template <typename InIter1, typename InIter2, typename OutIter>
+inline OutIter set_intersection(InIter1 first1, InIter1 last1, InIter2 first2,
+                                InIter2 last2, OutIter dst) {
+    return tiny_stl::set_intersection(first1, last1, first2, last2, dst,
+                                      tiny_stl::less<>{});
+}
+
+template <typename InIter1, typename InIter2, typename OutIter,
+          typename Compare>
+inline OutIter set_difference(InIter1 first1, InIter1 last1, InIter2 first2,
+                              InIter2 last2, OutIter dst, Compare cmp) {
+    while (first1 != last1 && first2 != last2) {
+        if (cmp(*first1, *first2)) {
+            *dst = *first1;
+            ++dst;
+            ++first1;
+        } else {
+            if (!cmp(*first2, *first1))
+                ++first1;
+            ++first2;
+        }
+    }
+
+    return tiny_stl::copy(first1, last1, dst);
+}
+
+template <typename InIter1, typename InIter2, typename OutIter>
+inline OutIter set_difference(InIter1 first1, InIter1 last1, InIter2 first2,
+                              InIter2 last2, OutIter dst) {
+    return tiny_stl::set_difference(first1, last1, first2, last2, dst,
+                                    tiny_stl::less<>{});
+}
+
+namespace details {
+
+// move the median of *a, *b and *c to *a
+template <typename RanIter, typename Compare>
+inline void medianToFirst(RanIter a, RanIter b, RanIter c, Compare& cmp) {
+    if (cmp(*b, *a))
+        tiny_stl::iter_swap(a, b); // *a <= *b
+    if (cmp(*c, *b)) {
+        tiny_stl::iter_swap(b, c); // *b is the largest
+        if (cmp(*b, *a))
+            tiny_stl::iter_swap(a, b);
+    }
+    tiny_stl::iter_swap(a, b);
+}
+
+// Partition around the pivot at *first and return its final position,
+// with nothing greater before it and nothing less after it. Elements equal
+// to the pivot stop both scans and end up on both sides, so runs of equal
+// keys still split in half.
+template <typename RanIter, typename Compare>
+RanIter partitionAtFirst(RanIter first, RanIter last, Compare& cmp) {
+    RanIter i = first;
+    RanIter j = last;
+    for (;;) {
+        while (++i != last && cmp(*i, *first)) {
+        }
+        while (cmp(*first, *--j)) {
+        }
+        if (i >= j)
+            break;
+        tiny_stl::iter_swap(i, j);
+    }
+
+    tiny_stl::iter_swap(first, j);
+    return j;
+}
+
+template <typename RanIter, typename Compare>
+void introSelect(RanIter first, RanIter nth, RanIter last,
+                 IterDiffType<RanIter> budget, Compare& cmp);
+
+// Move a pivot to *first that has at least 3/10 of the elements on either
+// side: the median of the medians of groups of five.
+template <typename RanIter, typename Compare>
+void medianOfMediansToFirst(RanIter first, RanIter last, Compare& cmp) {
+    using Diff = IterDiffType<RanIter>;
+    const Diff n = last - first;
+    Diff groups = 0;
+    for (Diff g = 0; g + 5 <= n; g += 5, ++groups) {
+        insertSort(first + g, first + (g + 5), cmp);
+        tiny_stl::iter_swap(first + groups, first + (g + 2));
+    }
+
+    const RanIter mid = first + groups / 2;
+    introSelect(first, mid, first + groups, Diff(0), cmp);
+    tiny_stl::iter_swap(first, mid);
+}
+
+// Quickselect with a median of three pivot, which is expected O(n). Each
+// step spends one unit of budget; once it's gone the pivot is the median of
+// medians, which bounds the rest by O(n) in the worst case.
+template <typename RanIter, typename Compare>
+void introSelect(RanIter first, RanIter nth, RanIter last,
+                 IterDiffType<RanIter> budget, Compare& cmp) {
+    while (last - first > INSERT_SORT_MAX) {
+        if (budget > 0) {
+            --budget;
+            const RanIter mid = first + (last - first) / 2;
+            // move the three samples to first, first + 1 and last - 1
+            tiny_stl::iter_swap(first + 1, mid);
+            medianToFirst(first, first + 1, last - 1, cmp);
+        } else {
+            medianOfMediansToFirst(first, last, cmp);
+        }
+
+        const RanIter pivot = partitionAtFirst(first, last, cmp);
+        if (pivot == nth)
+            return;
+        if (nth < pivot)
+            last = pivot;
+        else
+            first = pivot + 1;
+    }
+
+    insertSort(first, last, cmp);
+}
+
+} // namespace details
+
+// Rearrange [first, last) so that *nth is the element that would be there
+// if the range were sorted, with no element after it less than any before
+// it. Introselect, O(n).
+template <typename RanIter, typename Compare>
+inline void nth_element(RanIter first, RanIter nth, RanIter last,
+                        Compare cmp) {
+    if (nth == last || last - first < 2)
+        return;
+
+    IterDiffType<RanIter> budget = 0;
+    for (auto n = last - first; n > 1; n >>= 1)
+        budget += 2;
+    details::introSelect(first, nth, last, budget, cmp);
+}
+
+template <typename RanIter>
+inline void nth_element(RanIter first, RanIter nth, RanIter last) {
+    tiny_stl::nth_element(first, nth, last, tiny_stl::less<>{});
+}
+
+namespace details {
+
+// the heap arity used for selecting and sorting the first k elements
+static const std::size_t PARTIAL_SORT_ARITY = 4;
+
+// *first is the largest of the heap [first, first + len), replace it with
+// val and restore the heap
+template <typename RanIter, typename T, typename Compare>
+inline void replaceHeapTop(RanIter first, IterDiffType<RanIter> len, T&& val,
+                           Compare& cmp) {
+    details::adjustDHeap<PARTIAL_SORT_ARITY>(
+        first, IterDiffType<RanIter>(0), len, tiny_stl::forward<T>(val), cmp,
+        NotTracked{});
+}
+
+template <typename RanIter, typename Compare>
+inline void sortDHeap(RanIter first, RanIter last, Compare& cmp) {
+    for (; last - first > 1; --last)
+        details::popDHeap<PARTIAL_SORT_ARITY>(first, last, cmp);
+}
+
+} // namespace details
+
+// Sort the mid - first smallest elements of [first, last) into
+// [first, mid), leaving the rest in an unspecified order. For a small k =
+// mid - first they're kept in a max-heap while scanning, which mostly costs
+// one comparison per element; past n / 64 it's faster to select the k-th
+// element and sort what's before it, O(n + k log k).
+template <typename RanIter, typename Compare>
+inline void partial_sort(RanIter first, RanIter mid, RanIter last,
+                         Compare cmp) {
+    using Diff = IterDiffType<RanIter>;
+    const Diff k = mid - first;
+    if (k == 0)
+        return;
+
+    if (k > (last - first) / 64) {
+        tiny_stl::nth_element(first, mid - 1, last, cmp);
+        tiny_stl::sort(first, mid - 1, cmp);
+        return;
+    }
+
+    details::makeDHeap<details::PARTIAL_SORT_ARITY>(first, mid, cmp);
+    for (RanIter it = mid; it != last; ++it) {
+        if (cmp(*it, *first)) {
+            auto val = tiny_stl::move(*it);
+            *it = tiny_stl::move(*first);
+            details::replaceHeapTop(first, k, tiny_stl::move(val), cmp);
+        }
+    }
+
+    details::sortDHeap(first, mid, cmp);
+}
+
+template <typename RanIter>
+inline void partial_sort(RanIter first, RanIter mid, RanIter last) {
+    tiny_stl::partial_sort(first, mid, last, tiny_stl::less<>{});
+}
+
+// Copy the smallest min(last - first, dstLast - dstFirst) elements of
+// [first, last) to the destination in sorted order, and return the end of
+// what was written. The input is read once, so it can be a stream.
+template <typename InIter, typename RanIter, typename Compare>
+inline RanIter partial_sort_copy(InIter first, InIter last, RanIter dstFirst,
+                                 RanIter dstLast, Compare cmp) {
+    using Diff = IterDiffType<RanIter>;
+    RanIter dst = dstFirst;
+    for (; first != last && dst != dstLast; ++first, ++dst)
+        *dst = *first;
+
+    const Diff k = dst - dstFirst;
+    if (k == 0)
+        return dst;
+
+    details::makeDHeap<details::PARTIAL_SORT_ARITY>(dstFirst, dst, cmp);
+    for (; first != last; ++first) {
+        if (cmp(*first, *dstFirst)) {
+            typename iterator_traits<RanIter>::value_type val = *first;
+            details::replaceHeapTop(dstFirst, k, tiny_stl::move(val), cmp);
+        }
+    }
+
+    details::sortDHeap(dstFirst, dst, cmp);
+    return dst;
+}
+
+template <typename InIter, typename RanIter>
+inline RanIter partial_sort_copy(InIter first, InIter last, RanIter dstFirst,
+                                 RanIter dstLast) {
+    return tiny_stl::partial_sort_copy(first, last, dstFirst, dstLast,
+                                       tiny_stl::less<>{});
+}
+
+// Define TINY_STL_CHECK_SORTED to assert that the ranges given to the
+// binary searches are sorted. It makes every search O(n).
+#ifdef TINY_STL_CHECK_SORTED
+#define TINY_STL_ASSERT_SORTED(first, last, cmp)                               \
+    assert(tiny_stl::is_sorted(first, last, cmp))
+#else
+#define TINY_STL_ASSERT_SORTED(first, last, cmp) ((void)0)
+#endif
+
+namespace details {
+
+template <typename FwdIter, typename Pred>
+inline FwdIter partitionPointAux(FwdIter first, FwdIter last, Pred pred,
+                                 false_type) {
+    using Diff = IterDiffType<FwdIter>;
+    Diff size = tiny_stl::distance(first, last);
+
+    while (size > 0) {
+        FwdIter mid = first;
+        const Diff step = size >> 1;
+        tiny_stl::advance(mid, step);
+
+        if (pred(*mid)) { // right
+            first = ++mid;
+            size -= step + 1;
+        } else { // left
+            size = step;
+        }
+    }
+
+    return first;
+}
+
+// The next probe is at base + len / 2 either way, so the step is a
+// conditional move instead of a branch the CPU has to guess, and both
+// candidates for the probe after it are prefetched while this one loads.
+template <typename RanIter, typename Pred>
+inline RanIter partitionPointAux(RanIter first, RanIter last, Pred pred,
+                                 true_type) {
+    using Diff = IterDiffType<RanIter>;
+    Diff len = last - first;
+    if (len == 0)
+        return first;
+
+    while (len > 1) {
+        const Diff half = len / 2;
+        const Diff next = (len - half) / 2;
+        TINY_STL_PREFETCH(tiny_stl::addressof(first[next]));
+        TINY_STL_PREFETCH(tiny_stl::addressof(first[half + next]));
+        first = pred(first[half]) ? first + half : first;
+        len -= half;
+    }
+
+    return first + (pred(*first) ? 1 : 0);
+}
+
+// the first element in [first, last) for which pred is false, pred must be
+// true for a prefix and false for the rest
+template <typename FwdIter, typename Pred>
+inline FwdIter partitionPoint(FwdIter first, FwdIter last, Pred pred) {
+    return partitionPointAux(
+        first, last, pred,
+        is_convertible<typename iterator_traits<FwdIter>::iterator_category,
+                       random_access_iterator_tag>{});
+}
+
+} // namespace details
+
+template <typename FwdIter, typename T, typename Compare>
+inline FwdIter lower_bound(FwdIter first, FwdIter last, const T& val,
+                           Compare cmp) {
+    TINY_STL_ASSERT_SORTED(first, last, cmp);
+    return details::partitionPoint(
+        first, last, [&](const auto& elem) { return cmp(elem, val); });
+}
+
+template <typename FwdIter, typename T>
+inline FwdIter lower_bound(FwdIter first, FwdIter last, const T& val) {
+    return tiny_stl::lower_bound(first, last, val, tiny_stl::less<>{});
+}
+
+template <typename FwdIter, typename T, typename Compare>
+inline FwdIter upper_bound(FwdIter first, FwdIter last, const T& val,
+                           Compare cmp) {
+    TINY_STL_ASSERT_SORTED(first, last, cmp);
+    return details::partitionPoint(
+        first, last, [&](const auto& elem) { return !cmp(val, elem); });
+}
+
+template <typename FwdIter, typename T>
+inline FwdIter upper_bound(FwdIter first, FwdIter last, const T& val) {
+    return tiny_stl::upper_bound(first, last, val, tiny_stl::less<>{});
+}
+
+// The number of searches lower_bound_many runs side by side.
+static const std::size_t LOWER_BOUND_BATCH = 32;
+
+// Write lower_bound(first, last, key, cmp) for every key in
+// [keyFirst, keyLast) to dst, and return the end of the output.
+//
+// A search of a large range waits on a cache miss at every step, and each
+// step depends on the one before. Here the searches are run in batches
+// that take their steps together, so the loads of one step of the whole
+// batch are in flight at the same time.
+template <typename RanIter, typename FwdIter, typename OutIter,
+          typename Compare>
+inline OutIter lower_bound_many(RanIter first, RanIter last, FwdIter keyFirst,
+                                FwdIter keyLast, OutIter dst, Compare cmp) {
+    using Diff = IterDiffType<RanIter>;
+    const Diff len = last - first;
+    TINY_STL_ASSERT_SORTED(first, last, cmp);
+
+    FwdIter keys[LOWER_BOUND_BATCH];
+    RanIter base[LOWER_BOUND_BATCH];
+    while (keyFirst != keyLast) {
+        std::size_t count = 0;
+        for (; count < LOWER_BOUND_BATCH && keyFirst != keyLast; ++keyFirst)
+            keys[count++] = keyFirst;
+
+        if (len == 0) {
+            for (std::size_t i = 0; i < count; ++i, ++dst)
+                *dst = first;
+            continue;
+        }
+
+        for (std::size_t i = 0; i < count; ++i)
+            base[i] = first;
+
+        for (Diff n = len; n > 1;) {
+            const Diff half = n / 2;
+            for (std::size_t i = 0; i < count; ++i)
+                base[i] = cmp(base[i][half], *keys[i]) ? base[i] + half
+                                                       : base[i];
+            n -= half;
+        }
+
+        for (std::size_t i = 0; i < count; ++i, ++dst)
+            *dst = base[i] + (cmp(*base[i], *keys[i]) ? 1 : 0);
+    }
+
+    return dst;
+}
+
+template <typename RanIter, typename FwdIter, typename OutIter>
+inline OutIter lower_bound_many(RanIter first, RanIter last, FwdIter keyFirst,
+                                FwdIter keyLast, OutIter dst) {
+    return tiny_stl::lower_bound_many(first, last, keyFirst, keyLast, dst,
+                                      tiny_stl::less<>{});
 }
 
 template <typename FwdIter, typename T, typename Compare>
-inline FwdIter binary_search(FwdIter first, FwdIter last, const T& val,
-                             Compare cmp) {
+inline bool binary_search(FwdIter first, FwdIter last, const T& val,
+                          Compare cmp) {
     first = tiny_stl::lower_bound(first, last, val, cmp);
     return (!(first == last)) && !(cmp(val, *first));
 }
 
 template <typename FwdIter, typename T>
-inline FwdIter binary_search(FwdIter first, FwdIter last, const T& val) {
+inline bool binary_search(FwdIter first, FwdIter last, const T& val) {
     first = tiny_stl::lower_bound(first, last, val);
     return (!(first == last)) && !(val < *first);
 }
@@ -881,15 +3094,15 @@ inline FwdIter binary_search(FwdIter first, FwdIter last, const T& val) {
 template <typename FwdIter, typename T, typename Compare>
 inline pair<FwdIter, FwdIter> equal_range(FwdIter first, FwdIter last,
                                           const T& val, Compare cmp) {
-    return tiny_stl::make_pair(lower_bound(first, last, val, cmp),
-                               upper_bound(first, last, val, cmp));
+    return tiny_stl::make_pair(tiny_stl::lower_bound(first, last, val, cmp),
+                               tiny_stl::upper_bound(first, last, val, cmp));
 }
 
 template <typename FwdIter, typename T>
 inline pair<FwdIter, FwdIter> equal_range(FwdIter first, FwdIter last,
                                           const T& val) {
-    return tiny_stl::make_pair(lower_bound(first, last, val),
-                               upper_bound(first, last, val));
+    return tiny_stl::make_pair(tiny_stl::lower_bound(first, last, val),
+                               tiny_stl::upper_bound(first, last, val));
 }
 
 } // namespace tiny_stl
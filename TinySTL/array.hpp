@@ -298,6 +298,37 @@ constexpr ArrayIterator<T, Size> operator+(std::ptrdiff_t offset,
     return rhs += offset;
 }
 
+template <typename Iter, typename Ptr>
+struct ArrayContiguousTraits {
+    using is_contiguous_iterator = true_type;
+
+#ifndef NDEBUG // DEBUG
+    static Ptr toPointer(const Iter& iter) {
+        return const_cast<Ptr>(iter.ptr + iter.idx);
+    }
+
+    static Iter fromPointer(const Iter& iter, Ptr p) {
+        return Iter(const_cast<Ptr>(iter.ptr), p - iter.ptr);
+    }
+#else
+    static Ptr toPointer(const Iter& iter) {
+        return const_cast<Ptr>(iter.ptr);
+    }
+
+    static Iter fromPointer(const Iter&, Ptr p) {
+        return Iter(p, 0);
+    }
+#endif // !NDEBUG
+};
+
+template <typename T, std::size_t Size>
+struct ContiguousIteratorTraits<ArrayConstIterator<T, Size>>
+    : ArrayContiguousTraits<ArrayConstIterator<T, Size>, const T*> {};
+
+template <typename T, std::size_t Size>
+struct ContiguousIteratorTraits<ArrayIterator<T, Size>>
+    : ArrayContiguousTraits<ArrayIterator<T, Size>, T*> {};
+
 template <typename T, std::size_t Size>
 class array {
 public:
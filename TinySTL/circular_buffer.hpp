@@ -0,0 +1,764 @@
+// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <cassert>
+#include <initializer_list>
+
+#include "memory.hpp"
+
+namespace tiny_stl {
+
+// Iterators hold the unwrapped position head + index, the slot is
+// pos & mask, so stepping over the end of the storage needs no branch.
+template <typename T>
+struct CircularBufferConstIterator {
+    using iterator_category = random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+    using Self = CircularBufferConstIterator<T>;
+
+    T* data;
+    std::size_t mask;
+    std::size_t pos;
+
+    CircularBufferConstIterator() : data(), mask(), pos() {
+    }
+
+    CircularBufferConstIterator(T* d, std::size_t m, std::size_t p)
+        : data(d), mask(m), pos(p) {
+    }
+
+    reference operator*() const {
+        return data[pos & mask];
+    }
+
+    pointer operator->() const {
+        return data + (pos & mask);
+    }
+
+    Self& operator++() {
+        ++pos;
+        return *this;
+    }
+
+    Self operator++(int) {
+        Self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    Self& operator--() {
+        --pos;
+        return *this;
+    }
+
+    Self operator--(int) {
+        Self tmp = *this;
+        --*this;
+        return tmp;
+    }
+
+    Self& operator+=(difference_type n) {
+        pos += static_cast<std::size_t>(n);
+        return *this;
+    }
+
+    Self operator+(difference_type n) const {
+        Self tmp = *this;
+        return tmp += n;
+    }
+
+    Self& operator-=(difference_type n) {
+        pos -= static_cast<std::size_t>(n);
+        return *this;
+    }
+
+    Self operator-(difference_type n) const {
+        Self tmp = *this;
+        return tmp -= n;
+    }
+
+    difference_type operator-(const Self& rhs) const {
+        return static_cast<difference_type>(pos - rhs.pos);
+    }
+
+    reference operator[](difference_type n) const {
+        return *(*this + n);
+    }
+
+    bool operator==(const Self& rhs) const {
+        return pos == rhs.pos;
+    }
+
+    bool operator!=(const Self& rhs) const {
+        return !(*this == rhs);
+    }
+
+    bool operator<(const Self& rhs) const {
+        return pos < rhs.pos;
+    }
+
+    bool operator>(const Self& rhs) const {
+        return rhs < *this;
+    }
+
+    bool operator<=(const Self& rhs) const {
+        return !(rhs < *this);
+    }
+
+    bool operator>=(const Self& rhs) const {
+        return !(*this < rhs);
+    }
+}; // class CircularBufferConstIterator<T>
+
+template <typename T>
+inline CircularBufferConstIterator<T>
+operator+(typename CircularBufferConstIterator<T>::difference_type n,
+          CircularBufferConstIterator<T> iter) {
+    return iter += n;
+}
+
+template <typename T>
+struct CircularBufferIterator : CircularBufferConstIterator<T> {
+    using iterator_category = random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    using Base = CircularBufferConstIterator<T>;
+    using Self = CircularBufferIterator<T>;
+
+    CircularBufferIterator() : Base() {
+    }
+
+    CircularBufferIterator(T* d, std::size_t m, std::size_t p) : Base(d, m, p) {
+    }
+
+    reference operator*() const {
+        return const_cast<reference>(Base::operator*());
+    }
+
+    pointer operator->() const {
+        return const_cast<pointer>(Base::operator->());
+    }
+
+    Self& operator++() {
+        ++*static_cast<Base*>(this);
+        return *this;
+    }
+
+    Self operator++(int) {
+        Self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    Self& operator--() {
+        --*static_cast<Base*>(this);
+        return *this;
+    }
+
+    Self operator--(int) {
+        Self tmp = *this;
+        --*this;
+        return tmp;
+    }
+
+    Self& operator+=(difference_type n) {
+        *static_cast<Base*>(this) += n;
+        return *this;
+    }
+
+    Self operator+(difference_type n) const {
+        Self tmp = *this;
+        return tmp += n;
+    }
+
+    Self& operator-=(difference_type n) {
+        return *this += -n;
+    }
+
+    Self operator-(difference_type n) const {
+        Self tmp = *this;
+        return tmp -= n;
+    }
+
+    difference_type operator-(const Self& rhs) const {
+        return static_cast<difference_type>(this->pos - rhs.pos);
+    }
+
+    reference operator[](difference_type n) const {
+        return *(*this + n);
+    }
+}; // class CircularBufferIterator<T>
+
+template <typename T>
+inline CircularBufferIterator<T>
+operator+(typename CircularBufferIterator<T>::difference_type n,
+          CircularBufferIterator<T> iter) {
+    return iter += n;
+}
+
+// One pass over the storage, a range of the buffer spans at most two.
+template <typename T>
+struct CircularBufferSegment {
+    T* data;
+    std::size_t mask;
+    std::size_t lap; // unwrapped position of the first slot
+
+    CircularBufferSegment& operator++() {
+        lap += mask + 1;
+        return *this;
+    }
+
+    CircularBufferSegment& operator--() {
+        lap -= mask + 1;
+        return *this;
+    }
+
+    bool operator==(const CircularBufferSegment& rhs) const {
+        return lap == rhs.lap;
+    }
+
+    bool operator!=(const CircularBufferSegment& rhs) const {
+        return lap != rhs.lap;
+    }
+};
+
+template <typename Iter, typename T, typename Local>
+struct CircularBufferSegmentedTraits {
+    using is_segmented_iterator = true_type;
+    using segment_iterator = CircularBufferSegment<T>;
+    using local_iterator = Local;
+
+    static segment_iterator segment(const Iter& iter) {
+        return segment_iterator{iter.data, iter.mask, iter.pos & ~iter.mask};
+    }
+
+    static local_iterator local(const Iter& iter) {
+        return iter.data + (iter.pos & iter.mask);
+    }
+
+    static local_iterator begin(segment_iterator seg) {
+        return seg.data;
+    }
+
+    static local_iterator end(segment_iterator seg) {
+        return seg.data + seg.mask + 1;
+    }
+
+    static Iter compose(segment_iterator seg, local_iterator local) {
+        return Iter(seg.data, seg.mask,
+                    seg.lap + static_cast<std::size_t>(local - seg.data));
+    }
+};
+
+template <typename T>
+struct SegmentedIteratorTraits<CircularBufferConstIterator<T>>
+    : CircularBufferSegmentedTraits<CircularBufferConstIterator<T>, T,
+                                    const T*> {};
+
+template <typename T>
+struct SegmentedIteratorTraits<CircularBufferIterator<T>>
+    : CircularBufferSegmentedTraits<CircularBufferIterator<T>, T, T*> {};
+
+// Ring buffer over one power-of-two array. When full, a push either grows
+// the array (the default) or overwrites the element at the other end, so
+// a fixed window of the latest values needs no pop. The elements occupy
+// at most two contiguous runs, array_one() and array_two().
+//
+// Meets the container requirements of queue and stack.
+template <typename T, typename Alloc = allocator<T>>
+class circular_buffer {
+public:
+    static_assert(tiny_stl::is_same_v<T, typename Alloc::value_type>,
+                  "Alloc::value_type is not the same as T");
+
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = CircularBufferIterator<T>;
+    using const_iterator = CircularBufferConstIterator<T>;
+    using reverse_iterator = tiny_stl::reverse_iterator<iterator>;
+    using const_reverse_iterator = tiny_stl::reverse_iterator<const_iterator>;
+    using array_range = pair<pointer, size_type>;
+    using const_array_range = pair<const_pointer, size_type>;
+
+    // what a push does when size() == capacity()
+    enum class full_policy { grow, overwrite };
+
+private:
+    using AlTraits = allocator_traits<Alloc>;
+
+    constexpr static const size_type kSmallestCapacity = 8;
+
+    Alloc alloc;
+    T* data;
+    size_type cap; // 0 or a power of two
+    size_type head;
+    size_type count;
+    full_policy policy;
+
+private:
+    size_type mask() const noexcept {
+        return cap == 0 ? 0 : cap - 1;
+    }
+
+    T* slot(size_type i) const noexcept {
+        return data + ((head + i) & (cap - 1));
+    }
+
+    size_type roundCapacity(size_type n) const {
+        if (n > max_size())
+            xLength();
+
+        size_type c = 1;
+        while (c < n)
+            c <<= 1;
+        return c;
+    }
+
+    void destroyAll() noexcept {
+        for (size_type i = 0; i < count; ++i)
+            AlTraits::destroy(alloc, slot(i));
+    }
+
+    void tidy() noexcept {
+        if (data != nullptr) {
+            destroyAll();
+            alloc.deallocate(data, cap);
+        }
+        data = nullptr;
+        cap = head = count = 0;
+    }
+
+    static T&& moveOrCopy(T& val, true_type) noexcept {
+        return tiny_stl::move(val);
+    }
+
+    static const T& moveOrCopy(T& val, false_type) noexcept {
+        return val;
+    }
+
+    // move the elements to a new array of newCap slots, starting at 0,
+    // copy them if a throwing move could lose some, like vector
+    void reallocate(size_type newCap) {
+        using MoveTag = typename tiny_stl::disjunction<
+            is_nothrow_move_constructible<T>,
+            negation<is_copy_constructible<T>>>::type;
+        T* newData = alloc.allocate(newCap);
+        size_type i = 0;
+        try {
+            for (; i < count; ++i)
+                AlTraits::construct(alloc, newData + i,
+                                    moveOrCopy(*slot(i), MoveTag{}));
+        } catch (...) {
+            destroyAllocRange(newData, newData + i, alloc);
+            alloc.deallocate(newData, newCap);
+            throw;
+        }
+
+        const size_type n = count;
+        tidy();
+        data = newData;
+        cap = newCap;
+        count = n;
+    }
+
+    // the copy keeps the capacity, a fixed window depends on it
+    void copyFrom(const circular_buffer& rhs) {
+        if (rhs.cap == 0)
+            return;
+
+        data = alloc.allocate(rhs.cap);
+        cap = rhs.cap;
+        try {
+            for (; count < rhs.count; ++count)
+                AlTraits::construct(alloc, data + count, *rhs.slot(count));
+        } catch (...) {
+            tidy();
+            throw;
+        }
+    }
+
+    void steal(circular_buffer& rhs) noexcept {
+        data = rhs.data;
+        cap = rhs.cap;
+        head = rhs.head;
+        count = rhs.count;
+        rhs.data = nullptr;
+        rhs.cap = rhs.head = rhs.count = 0;
+    }
+
+    size_type grownCapacity() const {
+        if (cap == 0)
+            return kSmallestCapacity;
+        if (cap > max_size() / 2)
+            xLength();
+        return cap * 2;
+    }
+
+public:
+    circular_buffer() noexcept(noexcept(Alloc())) : circular_buffer(Alloc()) {
+    }
+
+    explicit circular_buffer(const Alloc& a) noexcept
+        : alloc(a), data(nullptr), cap(0), head(0), count(0),
+          policy(full_policy::grow) {
+    }
+
+    // capacity is rounded up to a power of two
+    explicit circular_buffer(size_type capacity,
+                             full_policy p = full_policy::grow,
+                             const Alloc& a = Alloc())
+        : circular_buffer(a) {
+        policy = p;
+        reserve(capacity);
+    }
+
+    circular_buffer(std::initializer_list<T> ilist, const Alloc& a = Alloc())
+        : circular_buffer(a) {
+        reserve(ilist.size());
+        for (const T& val : ilist)
+            push_back(val);
+    }
+
+    circular_buffer(const circular_buffer& rhs)
+        : circular_buffer(
+              AlTraits::select_on_container_copy_construction(rhs.alloc)) {
+        policy = rhs.policy;
+        copyFrom(rhs);
+    }
+
+    circular_buffer(const circular_buffer& rhs, const Alloc& a)
+        : circular_buffer(a) {
+        policy = rhs.policy;
+        copyFrom(rhs);
+    }
+
+    circular_buffer(circular_buffer&& rhs) noexcept
+        : alloc(tiny_stl::move(rhs.alloc)), policy(rhs.policy) {
+        steal(rhs);
+    }
+
+    circular_buffer(circular_buffer&& rhs, const Alloc& a)
+        : circular_buffer(a) {
+        policy = rhs.policy;
+        if (alloc == rhs.alloc)
+            steal(rhs);
+        else
+            copyFrom(rhs);
+    }
+
+    circular_buffer& operator=(const circular_buffer& rhs) {
+        if (this != &rhs) {
+            circular_buffer tmp(rhs, alloc);
+            tmp.swapStorage(*this);
+            policy = rhs.policy;
+        }
+        return *this;
+    }
+
+    circular_buffer& operator=(circular_buffer&& rhs) noexcept {
+        if (this != &rhs) {
+            tidy();
+            alloc = tiny_stl::move(rhs.alloc);
+            policy = rhs.policy;
+            steal(rhs);
+        }
+        return *this;
+    }
+
+    ~circular_buffer() {
+        tidy();
+    }
+
+    allocator_type get_allocator() const {
+        return alloc;
+    }
+
+public:
+    reference operator[](size_type pos) {
+        return *slot(pos);
+    }
+
+    const_reference operator[](size_type pos) const {
+        return *slot(pos);
+    }
+
+    reference at(size_type pos) {
+        if (pos >= count)
+            xRange();
+        return *slot(pos);
+    }
+
+    const_reference at(size_type pos) const {
+        if (pos >= count)
+            xRange();
+        return *slot(pos);
+    }
+
+    reference front() {
+        return data[head];
+    }
+
+    const_reference front() const {
+        return data[head];
+    }
+
+    reference back() {
+        return *slot(count - 1);
+    }
+
+    const_reference back() const {
+        return *slot(count - 1);
+    }
+
+    // the elements from front() up to the end of the storage
+    array_range array_one() noexcept {
+        return array_range(data + head, tiny_stl::min(count, cap - head));
+    }
+
+    const_array_range array_one() const noexcept {
+        return const_array_range(data + head,
+                                 tiny_stl::min(count, cap - head));
+    }
+
+    // the elements that wrapped to the start of the storage
+    array_range array_two() noexcept {
+        return array_range(data, count - tiny_stl::min(count, cap - head));
+    }
+
+    const_array_range array_two() const noexcept {
+        return const_array_range(data,
+                                 count - tiny_stl::min(count, cap - head));
+    }
+
+    iterator begin() noexcept {
+        return iterator(data, mask(), head);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(data, mask(), head);
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    iterator end() noexcept {
+        return iterator(data, mask(), head + count);
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(data, mask(), head + count);
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator crbegin() const noexcept {
+        return rbegin();
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    const_reverse_iterator crend() const noexcept {
+        return rend();
+    }
+
+public:
+    bool empty() const noexcept {
+        return count == 0;
+    }
+
+    bool full() const noexcept {
+        return count == cap;
+    }
+
+    size_type size() const noexcept {
+        return count;
+    }
+
+    size_type capacity() const noexcept {
+        return cap;
+    }
+
+    size_type max_size() const noexcept {
+        return (static_cast<size_type>(-1) >> 1) / sizeof(T);
+    }
+
+    full_policy get_full_policy() const noexcept {
+        return policy;
+    }
+
+    void set_full_policy(full_policy p) noexcept {
+        policy = p;
+    }
+
+    // capacity() becomes at least n, rounded up to a power of two
+    void reserve(size_type n) {
+        if (n > cap)
+            reallocate(roundCapacity(n));
+    }
+
+public:
+    template <typename... Args>
+    void emplace_back(Args&&... args) {
+        if (count != cap) {
+            AlTraits::construct(alloc, slot(count),
+                                tiny_stl::forward<Args>(args)...);
+            ++count;
+            return;
+        }
+
+        if (cap == 0 && policy == full_policy::overwrite)
+            return;
+
+        // args may refer to an element, so build the value first
+        T tmp(tiny_stl::forward<Args>(args)...);
+        if (policy == full_policy::grow) {
+            reallocate(grownCapacity());
+            AlTraits::construct(alloc, slot(count), tiny_stl::move(tmp));
+            ++count;
+        } else { // the front slot becomes the back
+            data[head] = tiny_stl::move(tmp);
+            head = (head + 1) & (cap - 1);
+        }
+    }
+
+    void push_back(const T& val) {
+        emplace_back(val);
+    }
+
+    void push_back(T&& val) {
+        emplace_back(tiny_stl::move(val));
+    }
+
+    template <typename... Args>
+    void emplace_front(Args&&... args) {
+        if (count != cap) {
+            const size_type newHead = (head - 1) & (cap - 1);
+            AlTraits::construct(alloc, data + newHead,
+                                tiny_stl::forward<Args>(args)...);
+            head = newHead;
+            ++count;
+            return;
+        }
+
+        if (cap == 0 && policy == full_policy::overwrite)
+            return;
+
+        T tmp(tiny_stl::forward<Args>(args)...);
+        if (policy == full_policy::grow) {
+            reallocate(grownCapacity());
+            head = cap - 1;
+            AlTraits::construct(alloc, data + head, tiny_stl::move(tmp));
+            ++count;
+        } else { // the back slot becomes the front
+            head = (head - 1) & (cap - 1);
+            data[head] = tiny_stl::move(tmp);
+        }
+    }
+
+    void push_front(const T& val) {
+        emplace_front(val);
+    }
+
+    void push_front(T&& val) {
+        emplace_front(tiny_stl::move(val));
+    }
+
+    void pop_front() {
+        assert(!empty());
+        AlTraits::destroy(alloc, data + head);
+        head = (head + 1) & (cap - 1);
+        --count;
+    }
+
+    void pop_back() {
+        assert(!empty());
+        AlTraits::destroy(alloc, slot(count - 1));
+        --count;
+    }
+
+    void clear() noexcept {
+        destroyAll();
+        head = count = 0;
+    }
+
+private:
+    void swapStorage(circular_buffer& rhs) noexcept {
+        tiny_stl::swap(data, rhs.data);
+        tiny_stl::swap(cap, rhs.cap);
+        tiny_stl::swap(head, rhs.head);
+        tiny_stl::swap(count, rhs.count);
+    }
+
+public:
+    void swap(circular_buffer& rhs) noexcept {
+        swapAlloc(alloc, rhs.alloc);
+        swapStorage(rhs);
+        tiny_stl::swap(policy, rhs.policy);
+    }
+
+private:
+    [[noreturn]] static void xLength() {
+        throw "circular_buffer<T> too long";
+    }
+
+    [[noreturn]] static void xRange() {
+        throw "invalid circular_buffer<T> subscript";
+    }
+}; // class circular_buffer<T, Alloc>
+
+template <typename T, typename Alloc>
+constexpr const typename circular_buffer<T, Alloc>::size_type
+    circular_buffer<T, Alloc>::kSmallestCapacity;
+
+template <typename T, typename Alloc>
+inline bool operator==(const circular_buffer<T, Alloc>& lhs,
+                       const circular_buffer<T, Alloc>& rhs) {
+    return lhs.size() == rhs.size() &&
+           tiny_stl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename T, typename Alloc>
+inline bool operator!=(const circular_buffer<T, Alloc>& lhs,
+                       const circular_buffer<T, Alloc>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename T, typename Alloc>
+inline void swap(circular_buffer<T, Alloc>& lhs,
+                 circular_buffer<T, Alloc>& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+} // namespace tiny_stl
@@ -0,0 +1,69 @@
+// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include "concurrent_skiplist.hpp"
+
+namespace tiny_stl {
+
+// Ordered map for concurrent use, see SkipList. A mapped value can't be
+// modified in place, erase the key and insert it again instead.
+template <typename Key, typename T, typename Compare = less<Key>,
+          typename Alloc = allocator<pair<Key, T>>>
+class concurrent_map
+    : public SkipList<pair<const Key, T>, Compare, Alloc, true> {
+private:
+    using Base = SkipList<pair<const Key, T>, Compare, Alloc, true>;
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = pair<const Key, T>;
+    using size_type = std::size_t;
+    using key_compare = Compare;
+    using allocator_type = Alloc;
+
+public:
+    concurrent_map() : concurrent_map(Compare()) {
+    }
+
+    explicit concurrent_map(const Compare& cmp, const Alloc& alloc = Alloc())
+        : Base(cmp, alloc) {
+    }
+
+    explicit concurrent_map(const Alloc& alloc) : Base(Compare(), alloc) {
+    }
+
+public:
+    // true if inserted, false if the key already exists
+    bool insert(const value_type& val) {
+        return this->emplaceUnique(val);
+    }
+
+    bool insert(value_type&& val) {
+        return this->emplaceUnique(tiny_stl::move(val));
+    }
+
+    template <typename... Args>
+    bool emplace(Args&&... args) {
+        return this->emplaceUnique(tiny_stl::forward<Args>(args)...);
+    }
+
+    // copy the mapped value to `value` if the key exists
+    bool find(const key_type& key, mapped_type& value) const {
+        auto f = [&value](const value_type& val) { value = val.second; };
+        return this->visitKey(key, f);
+    }
+
+    // f(const mapped_type&) while the element is protected, false if no
+    // such key
+    template <typename F>
+    bool visit(const key_type& key, F f) const {
+        auto g = [&f](const value_type& val) { f(val.second); };
+        return this->visitKey(key, g);
+    }
+}; // class concurrent_map
+
+} // namespace tiny_stl
@@ -0,0 +1,53 @@
+// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include "concurrent_skiplist.hpp"
+
+namespace tiny_stl {
+
+// Ordered set for concurrent use, see SkipList
+template <typename Key, typename Compare = less<Key>,
+          typename Alloc = allocator<Key>>
+class concurrent_set : public SkipList<Key, Compare, Alloc, false> {
+private:
+    using Base = SkipList<Key, Compare, Alloc, false>;
+
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using size_type = std::size_t;
+    using key_compare = Compare;
+    using value_compare = Compare;
+    using allocator_type = Alloc;
+
+public:
+    concurrent_set() : concurrent_set(Compare()) {
+    }
+
+    explicit concurrent_set(const Compare& cmp, const Alloc& alloc = Alloc())
+        : Base(cmp, alloc) {
+    }
+
+    explicit concurrent_set(const Alloc& alloc) : Base(Compare(), alloc) {
+    }
+
+public:
+    // true if inserted, false if the key already exists
+    bool insert(const value_type& val) {
+        return this->emplaceUnique(val);
+    }
+
+    bool insert(value_type&& val) {
+        return this->emplaceUnique(tiny_stl::move(val));
+    }
+
+    template <typename... Args>
+    bool emplace(Args&&... args) {
+        return this->emplaceUnique(tiny_stl::forward<Args>(args)...);
+    }
+}; // class concurrent_set
+
+} // namespace tiny_stl
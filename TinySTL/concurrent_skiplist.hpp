@@ -0,0 +1,634 @@
+// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "functional.hpp"
+#include "memory.hpp"
+#include "vector.hpp"
+
+namespace tiny_stl {
+
+namespace details {
+
+// small per-thread number, consecutive threads get consecutive numbers
+inline std::size_t threadNumber() noexcept {
+    static std::atomic<std::size_t> next{0};
+    static thread_local const std::size_t number =
+        next.fetch_add(1, std::memory_order_relaxed);
+    return number;
+}
+
+inline void spinWait(int& spins) noexcept {
+    if (++spins < 64)
+        TINY_STL_CPU_RELAX();
+    else
+        std::this_thread::yield();
+}
+
+// Epoch-based reclamation. A thread enters the domain before reading any
+// shared node and leaves when it holds no more node pointers; entering
+// announces the global epoch in a slot. An unlinked node is retired with
+// the epoch of its unlinking and freed once the global epoch is two ahead
+// of it. The epoch only moves from e to e + 1 when every thread inside
+// has announced e, so by then no one can still hold the node.
+//
+// Slots are claimed per critical section, starting at a slot chosen by
+// the thread, so any number of threads may use a domain. Each slot also
+// keeps the nodes retired through it.
+template <typename Node>
+class EpochDomain {
+private:
+    constexpr static const std::size_t kSlots = 128;
+    constexpr static const std::size_t kReclaimBatch = 64;
+
+    struct alignas(TINY_STL_CACHE_LINE_SIZE) Slot {
+        // 0 while unused, otherwise (epoch << 1) | 1
+        std::atomic<std::uint64_t> state{0};
+        // (retire epoch, node), only touched by the owner of the slot
+        vector<pair<std::uint64_t, Node*>> retired;
+    };
+
+    Slot slots[kSlots];
+    alignas(TINY_STL_CACHE_LINE_SIZE) std::atomic<std::uint64_t> epoch{0};
+
+public:
+    class Guard {
+    private:
+        EpochDomain& domain;
+        Slot* slot;
+
+    public:
+        explicit Guard(EpochDomain& d) : domain(d), slot(d.enter()) {
+        }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+        ~Guard() {
+            slot->state.store(0, std::memory_order_release);
+        }
+
+        // p must already be unreachable for threads that enter later
+        template <typename Free>
+        void retire(Node* p, Free free) {
+            domain.retire(slot, p, free);
+        }
+    };
+
+private:
+    Slot* enter() noexcept {
+        std::size_t i = threadNumber();
+        for (;;) {
+            for (std::size_t n = 0; n < kSlots; ++n, ++i) {
+                Slot& s = slots[i % kSlots];
+                std::uint64_t unused = 0;
+                const std::uint64_t e = epoch.load(std::memory_order_seq_cst);
+                if (s.state.load(std::memory_order_relaxed) == 0 &&
+                    s.state.compare_exchange_strong(unused, (e << 1) | 1)) {
+                    // node loads of the critical section stay after this,
+                    // pairs with the fence in retire
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    return &s;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    template <typename Free>
+    void retire(Slot* s, Node* p, Free free) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::uint64_t e = epoch.load(std::memory_order_seq_cst);
+        try {
+            s->retired.push_back(tiny_stl::make_pair(e, p));
+        } catch (...) {
+            return; // out of memory, leaking p is the only safe choice
+        }
+
+        if (s->retired.size() % kReclaimBatch == 0)
+            reclaim(s, free);
+    }
+
+    bool tryAdvance() noexcept {
+        std::uint64_t e = epoch.load(std::memory_order_seq_cst);
+        for (const Slot& s : slots) {
+            const std::uint64_t st = s.state.load(std::memory_order_seq_cst);
+            if (st != 0 && (st >> 1) != e)
+                return false;
+        }
+        return epoch.compare_exchange_strong(e, e + 1);
+    }
+
+    template <typename Free>
+    void reclaim(Slot* s, Free free) {
+        tryAdvance();
+        const std::uint64_t e = epoch.load(std::memory_order_seq_cst);
+
+        // retire epochs are ascending within a slot
+        auto& r = s->retired;
+        auto last = r.begin();
+        for (; last != r.end() && last->first + 2 <= e; ++last)
+            free(last->second);
+        r.erase(r.begin(), last);
+    }
+
+public:
+    EpochDomain() = default;
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    // free every retired node, no thread may be inside
+    template <typename Free>
+    void drain(Free free) {
+        for (Slot& s : slots) {
+            for (auto& val : s.retired)
+                free(val.second);
+            s.retired.clear();
+        }
+    }
+};
+
+template <typename T>
+struct SkipListNode {
+    std::atomic<bool> locked;
+    std::atomic<bool> marked;       // logically erased
+    std::atomic<bool> fully_linked; // linked on all of its levels
+    int height;
+    alignas(T) unsigned char storage[sizeof(T)];
+    // `height` links, the node is allocated large enough for all of them
+    std::atomic<SkipListNode*> next[1];
+
+    T& value() noexcept {
+        return *reinterpret_cast<T*>(storage);
+    }
+
+    void lock() noexcept {
+        int spins = 0;
+        while (locked.exchange(true, std::memory_order_acquire)) {
+            while (locked.load(std::memory_order_relaxed))
+                spinWait(spins);
+        }
+    }
+
+    void unlock() noexcept {
+        locked.store(false, std::memory_order_release);
+    }
+
+    bool live() const noexcept {
+        return fully_linked.load(std::memory_order_acquire) &&
+               !marked.load(std::memory_order_acquire);
+    }
+};
+
+} // namespace details
+
+// Ordered set of unique keys on a skiplist that many threads may use at
+// once (the lazy skiplist of Herlihy, Lev, Luchangco and Shavit).
+// Lookups and scans take no lock. insert locks the predecessors of the
+// new node, erase locks the victim and its predecessors, so only updates
+// next to each other in the list wait for each other. An erased element
+// is first marked, then unlinked, and then freed through the epoch domain
+// when no reader can reach it anymore.
+//
+// Elements are immutable once inserted. As with concurrent_unordered_map
+// no iterator or reference escapes: the accessors copy or run a callback
+// while the element is protected.
+template <typename T, typename Compare, typename Alloc, bool isMap>
+class SkipList {
+public:
+    using key_type =
+        remove_const_t<typename AssociatedTypeHelper<T, isMap>::key_type>;
+    using value_type = T;
+    using key_compare = Compare;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+
+protected:
+    using Node = details::SkipListNode<T>;
+    using Link = std::atomic<Node*>;
+    using AlTraits = allocator_traits<Alloc>;
+    using AlNode = typename AlTraits::template rebind_alloc<Node>;
+    using Epochs = details::EpochDomain<Node>;
+    using Guard = typename Epochs::Guard;
+
+    // with one level in four 16 levels stay balanced past 4G elements
+    constexpr static const int kMaxHeight = 16;
+
+protected:
+    AlNode alloc;
+    Compare compare;
+    Node* head;
+    mutable Epochs epochs;
+    // the highest level in use, only grows
+    std::atomic<int> levels;
+    alignas(TINY_STL_CACHE_LINE_SIZE) std::atomic<size_type> num_elements;
+
+private:
+    // map
+    static const key_type& getKeyValue(const T& val, true_type) noexcept {
+        return val.first;
+    }
+
+    // set
+    static const key_type& getKeyValue(const T& val, false_type) noexcept {
+        return val;
+    }
+
+    static const key_type& getKeyFromValue(const T& val) noexcept {
+        return getKeyValue(val, tiny_stl::bool_constant<isMap>{});
+    }
+
+    static const key_type& get_key(Node* p) noexcept {
+        return getKeyFromValue(p->value());
+    }
+
+    static std::size_t nodeUnits(int h) noexcept {
+        return (sizeof(Node) + (h - 1) * sizeof(Link) + sizeof(Node) - 1) /
+               sizeof(Node);
+    }
+
+    Node* allocNode(int h) {
+        Node* p = alloc.allocate(nodeUnits(h));
+        ::new (static_cast<void*>(&p->locked)) std::atomic<bool>(false);
+        ::new (static_cast<void*>(&p->marked)) std::atomic<bool>(false);
+        ::new (static_cast<void*>(&p->fully_linked)) std::atomic<bool>(false);
+        p->height = h;
+        for (int l = 0; l < h; ++l)
+            ::new (static_cast<void*>(&p->next[l])) Link(nullptr);
+        return p;
+    }
+
+    template <typename... Args>
+    Node* allocAndConstruct(Args&&... args) {
+        Node* p = allocNode(randomHeight());
+        try {
+            alloc.construct(tiny_stl::addressof(p->value()),
+                            tiny_stl::forward<Args>(args)...);
+        } catch (...) {
+            alloc.deallocate(p, nodeUnits(p->height));
+            throw;
+        }
+
+        return p;
+    }
+
+    void destroyAndFree(Node* p) noexcept {
+        alloc.destroy(tiny_stl::addressof(p->value()));
+        alloc.deallocate(p, nodeUnits(p->height));
+    }
+
+    // a level is kept with probability 1/4
+    static int randomHeight() noexcept {
+        static thread_local std::uint64_t seed =
+            (details::threadNumber() + 1) * 0x9E3779B97F4A7C15ull;
+        seed ^= seed >> 12;
+        seed ^= seed << 25;
+        seed ^= seed >> 27;
+        std::uint64_t r = seed * 0x2545F4914F6CDD1Dull;
+
+        int h = 1;
+        while (h < kMaxHeight && (r & 3) == 0) {
+            ++h;
+            r >>= 2;
+        }
+        return h;
+    }
+
+    void raiseHeight(int h) noexcept {
+        int cur = levels.load(std::memory_order_relaxed);
+        while (cur < h &&
+               !levels.compare_exchange_weak(cur, h,
+                                             std::memory_order_relaxed)) {
+        }
+    }
+
+    // preds[l] is the last node before key on level l and succs[l] the
+    // node after it, returns the highest level where succs[l] has the key
+    // or -1
+    int findNode(const key_type& key, Node** preds, Node** succs) const {
+        int found = -1;
+        Node* pred = head;
+        for (int l = levels.load(std::memory_order_relaxed) - 1; l >= 0;
+             --l) {
+            Node* curr = pred->next[l].load(std::memory_order_acquire);
+            while (curr != nullptr && compare(get_key(curr), key)) {
+                pred = curr;
+                curr = pred->next[l].load(std::memory_order_acquire);
+            }
+
+            if (found == -1 && curr != nullptr &&
+                !compare(key, get_key(curr)))
+                found = l;
+
+            preds[l] = pred;
+            succs[l] = curr;
+        }
+        return found;
+    }
+
+    // the node with key, marked or not, nullptr if none
+    Node* findEqual(const key_type& key) const {
+        Node* pred = head;
+        for (int l = levels.load(std::memory_order_relaxed) - 1; l >= 0;
+             --l) {
+            Node* curr = pred->next[l].load(std::memory_order_acquire);
+            while (curr != nullptr && compare(get_key(curr), key)) {
+                pred = curr;
+                curr = pred->next[l].load(std::memory_order_acquire);
+            }
+
+            if (curr != nullptr && !compare(key, get_key(curr)))
+                return curr;
+        }
+        return nullptr;
+    }
+
+    // the first node not less than key, marked or not
+    Node* lowerBound(const key_type& key) const {
+        Node* pred = head;
+        Node* curr = nullptr;
+        for (int l = levels.load(std::memory_order_relaxed) - 1; l >= 0;
+             --l) {
+            curr = pred->next[l].load(std::memory_order_acquire);
+            while (curr != nullptr && compare(get_key(curr), key)) {
+                pred = curr;
+                curr = pred->next[l].load(std::memory_order_acquire);
+            }
+        }
+        return curr;
+    }
+
+    // the locked predecessors are runs of the same node on levels
+    // 0..highest
+    static void unlockPreds(Node** preds, int highest) noexcept {
+        Node* prev = nullptr;
+        for (int l = 0; l <= highest; ++l) {
+            if (preds[l] != prev) {
+                preds[l]->unlock();
+                prev = preds[l];
+            }
+        }
+    }
+
+    // links p unless its key is present, does not throw
+    bool insertNode(Node* p) {
+        const int h = p->height;
+        raiseHeight(h);
+
+        Node* preds[kMaxHeight];
+        Node* succs[kMaxHeight];
+        Guard g(epochs);
+        int spins = 0;
+        for (;;) {
+            const int found = findNode(get_key(p), preds, succs);
+            if (found != -1) {
+                Node* dup = succs[found];
+                if (!dup->marked.load(std::memory_order_acquire)) {
+                    while (!dup->fully_linked.load(std::memory_order_acquire))
+                        details::spinWait(spins);
+                    return false;
+                }
+
+                // wait until the erased node is unlinked
+                details::spinWait(spins);
+                continue;
+            }
+
+            int highest = -1;
+            Node* prev = nullptr;
+            bool valid = true;
+            for (int l = 0; valid && l < h; ++l) {
+                Node* pred = preds[l];
+                Node* succ = succs[l];
+                if (pred != prev) {
+                    pred->lock();
+                    highest = l;
+                    prev = pred;
+                }
+
+                valid = !pred->marked.load(std::memory_order_acquire) &&
+                        (succ == nullptr ||
+                         !succ->marked.load(std::memory_order_acquire)) &&
+                        pred->next[l].load(std::memory_order_acquire) == succ;
+            }
+
+            if (!valid) {
+                unlockPreds(preds, highest);
+                continue;
+            }
+
+            for (int l = 0; l < h; ++l)
+                p->next[l].store(succs[l], std::memory_order_relaxed);
+            for (int l = 0; l < h; ++l)
+                preds[l]->next[l].store(p, std::memory_order_release);
+
+            p->fully_linked.store(true, std::memory_order_release);
+            unlockPreds(preds, highest);
+            num_elements.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+protected:
+    template <typename... Args>
+    bool emplaceUnique(Args&&... args) {
+        Node* p = allocAndConstruct(tiny_stl::forward<Args>(args)...);
+        if (insertNode(p))
+            return true;
+
+        destroyAndFree(p); // never published
+        return false;
+    }
+
+    template <typename F>
+    bool visitKey(const key_type& key, F& f) const {
+        Guard g(epochs);
+        Node* p = findEqual(key);
+        if (p == nullptr || !p->live())
+            return false;
+
+        f(static_cast<const T&>(p->value()));
+        return true;
+    }
+
+public:
+    explicit SkipList(const Compare& cmp, const Alloc& a)
+        : alloc(a), compare(cmp), head(nullptr), levels(1), num_elements(0) {
+        head = allocNode(kMaxHeight);
+    }
+
+    SkipList(const SkipList&) = delete;
+    SkipList& operator=(const SkipList&) = delete;
+
+    // no other thread may use the list any more
+    ~SkipList() {
+        Node* p = head->next[0].load(std::memory_order_relaxed);
+        while (p != nullptr) {
+            Node* next = p->next[0].load(std::memory_order_relaxed);
+            destroyAndFree(p);
+            p = next;
+        }
+        epochs.drain([this](Node* n) { destroyAndFree(n); });
+        alloc.deallocate(head, nodeUnits(kMaxHeight));
+    }
+
+public:
+    // only a snapshot while other threads modify the list
+    size_type size() const noexcept {
+        return num_elements.load(std::memory_order_relaxed);
+    }
+
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    key_compare key_comp() const {
+        return compare;
+    }
+
+    allocator_type get_allocator() const {
+        return allocator_type(alloc);
+    }
+
+public:
+    size_type count(const key_type& key) const {
+        Guard g(epochs);
+        Node* p = findEqual(key);
+        return p != nullptr && p->live() ? 1 : 0;
+    }
+
+    bool contains(const key_type& key) const {
+        return count(key) != 0;
+    }
+
+    size_type erase(const key_type& key) {
+        Node* preds[kMaxHeight];
+        Node* succs[kMaxHeight];
+        Guard g(epochs);
+        Node* victim = nullptr;
+        bool is_marked = false;
+        int h = 0;
+        for (;;) {
+            const int found = findNode(key, preds, succs);
+            if (!is_marked) {
+                if (found == -1)
+                    return 0;
+
+                victim = succs[found];
+                // still being inserted, or being erased by another thread
+                if (!victim->fully_linked.load(std::memory_order_acquire) ||
+                    victim->height - 1 != found ||
+                    victim->marked.load(std::memory_order_acquire))
+                    return 0;
+
+                h = victim->height;
+                victim->lock();
+                if (victim->marked.load(std::memory_order_relaxed)) {
+                    victim->unlock();
+                    return 0;
+                }
+                victim->marked.store(true, std::memory_order_release);
+                is_marked = true;
+            }
+
+            int highest = -1;
+            Node* prev = nullptr;
+            bool valid = true;
+            for (int l = 0; valid && l < h; ++l) {
+                Node* pred = preds[l];
+                if (pred != prev) {
+                    pred->lock();
+                    highest = l;
+                    prev = pred;
+                }
+
+                valid = !pred->marked.load(std::memory_order_acquire) &&
+                        pred->next[l].load(std::memory_order_acquire) == victim;
+            }
+
+            if (!valid) {
+                unlockPreds(preds, highest);
+                continue;
+            }
+
+            for (int l = h - 1; l >= 0; --l)
+                preds[l]->next[l].store(
+                    victim->next[l].load(std::memory_order_relaxed),
+                    std::memory_order_release);
+
+            victim->unlock();
+            unlockPreds(preds, highest);
+            num_elements.fetch_sub(1, std::memory_order_relaxed);
+            g.retire(victim, [this](Node* n) { destroyAndFree(n); });
+            return 1;
+        }
+    }
+
+    // erases the elements one by one, other threads may go on using the
+    // list meanwhile
+    void clear() {
+        for (;;) {
+            Guard g(epochs);
+            Node* p = head->next[0].load(std::memory_order_acquire);
+            while (p != nullptr && !p->live())
+                p = p->next[0].load(std::memory_order_acquire);
+            if (p == nullptr)
+                return;
+
+            erase(get_key(p));
+        }
+    }
+
+    // f(const value_type&) for every element in key order
+    template <typename F>
+    void for_each(F f) const {
+        Guard g(epochs);
+        for (Node* p = head->next[0].load(std::memory_order_acquire);
+             p != nullptr; p = p->next[0].load(std::memory_order_acquire)) {
+            if (p->live())
+                f(static_cast<const T&>(p->value()));
+        }
+    }
+
+    // f(const value_type&) for the elements in [first, last) in key order,
+    // returns how many were visited. An element inserted or erased while
+    // the scan runs may or may not be seen.
+    template <typename F>
+    size_type scan(const key_type& first, const key_type& last, F f) const {
+        size_type n = 0;
+        Guard g(epochs);
+        for (Node* p = lowerBound(first);
+             p != nullptr && compare(get_key(p), last);
+             p = p->next[0].load(std::memory_order_acquire)) {
+            if (p->live()) {
+                f(static_cast<const T&>(p->value()));
+                ++n;
+            }
+        }
+        return n;
+    }
+
+    // f(const value_type&) for at most n elements starting at the first
+    // one not less than first, returns how many were visited
+    template <typename F>
+    size_type scan_n(const key_type& first, size_type n, F f) const {
+        size_type i = 0;
+        Guard g(epochs);
+        for (Node* p = lowerBound(first); p != nullptr && i != n;
+             p = p->next[0].load(std::memory_order_acquire)) {
+            if (p->live()) {
+                f(static_cast<const T&>(p->value()));
+                ++i;
+            }
+        }
+        return i;
+    }
+}; // class SkipList<T, Compare, Alloc, isMap>
+
+} // namespace tiny_stl
@@ -0,0 +1,241 @@
+// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <climits>
+#include <mutex>
+#include <shared_mutex>
+
+#include "unordered_map.hpp"
+
+namespace tiny_stl {
+
+// Hash map for concurrent use, split into `Shards` unordered_maps that
+// are locked independently. A key always lives in the shard picked by the
+// high bits of its mixed hash, so threads working on different shards
+// never wait for each other, and a growing shard rehashes under its own
+// lock only.
+//
+// Lookups take the shard lock shared, modifications take it exclusive.
+// No iterator or reference escapes a lock: find copies the mapped value
+// out, visit/update/emplace_or_update run a callback while the lock is
+// held. A callback must not call back into the same map.
+template <typename Key, typename T, typename Hash = hash<Key>,
+          typename KeyEqual = equal_to<Key>,
+          typename Alloc = allocator<pair<Key, T>>, std::size_t Shards = 64>
+class concurrent_unordered_map {
+    static_assert(Shards != 0 && (Shards & (Shards - 1)) == 0,
+                  "the number of shards must be a power of two");
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = pair<const Key, T>;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Alloc;
+
+private:
+    using Map = unordered_map<Key, T, Hash, KeyEqual, Alloc>;
+    using Lock = std::shared_timed_mutex; // std::shared_mutex is C++17
+    using ReadGuard = std::shared_lock<Lock>;
+    using WriteGuard = std::lock_guard<Lock>;
+
+    struct alignas(TINY_STL_CACHE_LINE_SIZE) Shard {
+        mutable Lock lock;
+        Map map;
+    };
+
+    static constexpr int log2(std::size_t n) {
+        return n <= 1 ? 0 : 1 + log2(n >> 1);
+    }
+
+    constexpr static const int kShardBits = log2(Shards);
+
+    Shard shards[Shards];
+    hasher hashfunc;
+
+private:
+    // Fibonacci hashing: the high bits of the product depend on all bits
+    // of the hash and don't correlate with the bucket (hash % prime) the
+    // key gets inside its shard
+    Shard& shardFor(const key_type& key) const {
+        const std::size_t h =
+            hashfunc(key) * static_cast<std::size_t>(0x9E3779B97F4A7C15ull);
+        const std::size_t idx =
+            kShardBits == 0
+                ? 0
+                : h >> (sizeof(std::size_t) * CHAR_BIT - kShardBits);
+        return const_cast<Shard&>(shards[idx]);
+    }
+
+public:
+    explicit concurrent_unordered_map(size_type num_bucket = 0,
+                                      const Hash& hf = Hash(),
+                                      const KeyEqual& eq = KeyEqual(),
+                                      const Alloc& alloc = Alloc())
+        : hashfunc(hf) {
+        for (Shard& s : shards)
+            s.map = Map(num_bucket / Shards, hf, eq, alloc);
+    }
+
+    concurrent_unordered_map(const concurrent_unordered_map&) = delete;
+    concurrent_unordered_map&
+    operator=(const concurrent_unordered_map&) = delete;
+
+public:
+    constexpr static size_type shard_count() noexcept {
+        return Shards;
+    }
+
+    // only a snapshot while other threads modify the map
+    size_type size() const {
+        size_type n = 0;
+        for (const Shard& s : shards) {
+            ReadGuard g(s.lock);
+            n += s.map.size();
+        }
+        return n;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    void clear() {
+        for (Shard& s : shards) {
+            WriteGuard g(s.lock);
+            s.map.clear();
+        }
+    }
+
+    // shards are grown one at a time, the others stay available
+    void reserve(size_type n) {
+        for (Shard& s : shards) {
+            WriteGuard g(s.lock);
+            s.map.reserve(n / Shards + 1);
+        }
+    }
+
+public:
+    size_type count(const key_type& key) const {
+        const Shard& s = shardFor(key);
+        ReadGuard g(s.lock);
+        return s.map.count(key);
+    }
+
+    bool contains(const key_type& key) const {
+        return count(key) != 0;
+    }
+
+    // copy the mapped value to `value` if the key exists
+    bool find(const key_type& key, mapped_type& value) const {
+        const Shard& s = shardFor(key);
+        ReadGuard g(s.lock);
+        auto pos = s.map.find(key);
+        if (pos == s.map.end())
+            return false;
+
+        value = pos->second;
+        return true;
+    }
+
+    // f(const mapped_type&) under the shared lock, false if no such key
+    template <typename F>
+    bool visit(const key_type& key, F f) const {
+        const Shard& s = shardFor(key);
+        ReadGuard g(s.lock);
+        auto pos = s.map.find(key);
+        if (pos == s.map.end())
+            return false;
+
+        f(static_cast<const mapped_type&>(pos->second));
+        return true;
+    }
+
+    // f(const key_type&, const mapped_type&) for every element, one shard
+    // at a time, so it isn't a snapshot of the whole map
+    template <typename F>
+    void visit_all(F f) const {
+        for (const Shard& s : shards) {
+            ReadGuard g(s.lock);
+            for (const auto& val : s.map)
+                f(val.first, val.second);
+        }
+    }
+
+    // f(mapped_type&) under the exclusive lock, false if no such key
+    template <typename F>
+    bool update(const key_type& key, F f) {
+        Shard& s = shardFor(key);
+        WriteGuard g(s.lock);
+        auto pos = s.map.find(key);
+        if (pos == s.map.end())
+            return false;
+
+        f(pos->second);
+        return true;
+    }
+
+public:
+    // true if inserted, false if the key already exists
+    bool insert(const value_type& val) {
+        Shard& s = shardFor(val.first);
+        WriteGuard g(s.lock);
+        return s.map.insert(val).second;
+    }
+
+    bool insert(value_type&& val) {
+        Shard& s = shardFor(val.first);
+        WriteGuard g(s.lock);
+        return s.map.insert(tiny_stl::move(val)).second;
+    }
+
+    template <typename... Args>
+    bool emplace(Args&&... args) {
+        return insert(value_type(tiny_stl::forward<Args>(args)...));
+    }
+
+    // true if inserted, false if assigned
+    template <typename M>
+    bool insert_or_assign(const key_type& key, M&& obj) {
+        Shard& s = shardFor(key);
+        WriteGuard g(s.lock);
+        auto pos = s.map.find(key);
+        if (pos != s.map.end()) {
+            pos->second = tiny_stl::forward<M>(obj);
+            return false;
+        }
+
+        s.map.insert(value_type(key, tiny_stl::forward<M>(obj)));
+        return true;
+    }
+
+    // f(mapped_type&) if the key exists, otherwise insert
+    // mapped_type(args...), atomically; true if inserted
+    template <typename F, typename... Args>
+    bool emplace_or_update(const key_type& key, F f, Args&&... args) {
+        Shard& s = shardFor(key);
+        WriteGuard g(s.lock);
+        auto pos = s.map.find(key);
+        if (pos != s.map.end()) {
+            f(pos->second);
+            return false;
+        }
+
+        s.map.insert(
+            value_type(key, mapped_type(tiny_stl::forward<Args>(args)...)));
+        return true;
+    }
+
+    size_type erase(const key_type& key) {
+        Shard& s = shardFor(key);
+        WriteGuard g(s.lock);
+        return s.map.erase(key);
+    }
+}; // class concurrent_unordered_map
+
+} // namespace tiny_stl
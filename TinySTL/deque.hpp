@@ -6,7 +6,7 @@
 
 #include <initializer_list>
 
-#include "memory.h"
+#include "memory.hpp"
 
 namespace tiny_stl {
 
@@ -29,7 +29,18 @@ namespace tiny_stl {
 //           node
 //
 
+// Default block size policy, `value` is the number of elements per buffer.
+// A buffer is 512 bytes, but holds at least 16 elements so that a deque of
+// large T doesn't need one allocation per element.
+// Any type with a static `value` can be used as a policy, e.g.
+// deque<T, allocator<T>, integral_constant<std::size_t, 64>>.
 template <typename T>
+struct deque_block_size {
+    static constexpr std::size_t value =
+        512 / sizeof(T) < 16 ? 16 : 512 / sizeof(T);
+};
+
+template <typename T, std::size_t BufSize = deque_block_size<T>::value>
 struct DequeConstIterator {
     using iterator_category = random_access_iterator_tag;
     using value_type = T;
@@ -39,12 +50,12 @@ struct DequeConstIterator {
     using difference_type = std::ptrdiff_t;
 
     using MapPtr = T**;
-    using Self = DequeConstIterator<T>;
+    using Self = DequeConstIterator<T, BufSize>;
+
+    static_assert(BufSize > 0, "deque buffer size must be positive");
 
     constexpr static size_type buffer_size() {
-        constexpr size_type sz = sizeof(T);
-        return sz < 512 ? static_cast<size_type>(512 / sz)
-                        : static_cast<size_type>(1);
+        return BufSize;
     }
 
     T* cur;      // point to current element
@@ -92,7 +103,7 @@ struct DequeConstIterator {
     }
 
     Self operator++(int) {
-        Self tmp;
+        Self tmp = *this;
         ++*this;
         return tmp;
     }
@@ -107,7 +118,7 @@ struct DequeConstIterator {
     }
 
     Self operator--(int) {
-        Self tmp;
+        Self tmp = *this;
         --*this;
         return tmp;
     }
@@ -186,17 +197,17 @@ struct DequeConstIterator {
     bool operator>=(const Self& rhs) const {
         return !(*this < rhs);
     }
-}; // class DequeConstIterator<T>
+}; // class DequeConstIterator<T, BufSize>
 
-template <typename T>
-inline DequeConstIterator<T>
-operator+(typename DequeConstIterator<T>::difference_type n,
-          DequeConstIterator<T> iter) {
+template <typename T, std::size_t BufSize>
+inline DequeConstIterator<T, BufSize>
+operator+(typename DequeConstIterator<T, BufSize>::difference_type n,
+          DequeConstIterator<T, BufSize> iter) {
     return iter += n;
 }
 
-template <typename T>
-struct DequeIterator : DequeConstIterator<T> {
+template <typename T, std::size_t BufSize = deque_block_size<T>::value>
+struct DequeIterator : DequeConstIterator<T, BufSize> {
     using iterator_category = random_access_iterator_tag;
     using value_type = T;
     using pointer = T*;
@@ -205,8 +216,8 @@ struct DequeIterator : DequeConstIterator<T> {
     using difference_type = std::ptrdiff_t;
 
     using MapPtr = T**;
-    using Base = DequeConstIterator<T>;
-    using Self = DequeIterator<T>;
+    using Base = DequeConstIterator<T, BufSize>;
+    using Self = DequeIterator<T, BufSize>;
 
     using Base::cur;
 
@@ -240,7 +251,7 @@ struct DequeIterator : DequeConstIterator<T> {
     }
 
     Self operator++(int) {
-        Self tmp;
+        Self tmp = *this;
         ++*this;
         return tmp;
     }
@@ -251,7 +262,7 @@ struct DequeIterator : DequeConstIterator<T> {
     }
 
     Self operator--(int) {
-        Self tmp;
+        Self tmp = *this;
         --*this;
         return tmp;
     }
@@ -285,15 +296,57 @@ struct DequeIterator : DequeConstIterator<T> {
     reference operator[](difference_type n) const {
         return *(*this + n);
     }
-}; // class DequeIterator<T>
+}; // class DequeIterator<T, BufSize>
 
-template <typename T>
-inline DequeIterator<T> operator+(typename DequeIterator<T>::difference_type n,
-                                  DequeIterator<T> iter) {
+template <typename T, std::size_t BufSize>
+inline DequeIterator<T, BufSize>
+operator+(typename DequeIterator<T, BufSize>::difference_type n,
+          DequeIterator<T, BufSize> iter) {
     return iter += n;
 }
 
-template <typename T, typename Alloc>
+template <typename Iter, typename T, typename Local>
+struct DequeSegmentedTraits {
+    using is_segmented_iterator = true_type;
+    using segment_iterator = T**;
+    using local_iterator = Local;
+
+    static segment_iterator segment(const Iter& iter) {
+        return iter.node;
+    }
+
+    static local_iterator local(const Iter& iter) {
+        return iter.cur;
+    }
+
+    static local_iterator begin(segment_iterator seg) {
+        return *seg;
+    }
+
+    static local_iterator end(segment_iterator seg) {
+        return *seg + Iter::buffer_size();
+    }
+
+    static Iter compose(segment_iterator seg, local_iterator local) {
+        if (local == end(seg)) // keep iterator normalized
+            local = begin(++seg);
+
+        Iter iter;
+        iter.setNode(seg);
+        iter.cur = const_cast<T*>(local);
+        return iter;
+    }
+};
+
+template <typename T, std::size_t BufSize>
+struct SegmentedIteratorTraits<DequeConstIterator<T, BufSize>>
+    : DequeSegmentedTraits<DequeConstIterator<T, BufSize>, T, const T*> {};
+
+template <typename T, std::size_t BufSize>
+struct SegmentedIteratorTraits<DequeIterator<T, BufSize>>
+    : DequeSegmentedTraits<DequeIterator<T, BufSize>, T, T*> {};
+
+template <typename T, typename Alloc, typename BlockSize>
 class DequeBase {
 public:
     using value_type = T;
@@ -304,8 +357,8 @@ public:
     using const_pointer = const T*;
     using reference = T&;
     using const_reference = const T&;
-    using iterator = DequeIterator<T>;
-    using const_iterator = DequeConstIterator<T>;
+    using iterator = DequeIterator<T, BlockSize::value>;
+    using const_iterator = DequeConstIterator<T, BlockSize::value>;
     using reverse_iterator = tiny_stl::reverse_iterator<iterator>;
     using const_reverse_iterator = tiny_stl::reverse_iterator<const_iterator>;
 
@@ -326,6 +379,14 @@ protected:
 
     constexpr static const size_type kSmallestSize = 8;
 
+    // Buffers released by pop/erase/clear are kept here and handed out
+    // again by allocateNode, so a queue moving across a buffer boundary
+    // doesn't allocate and free a buffer each time.
+    constexpr static const size_type kSpareNodes = 2;
+
+    T* spare[kSpareNodes];
+    size_type spare_count;
+
 protected:
     MapPtr allocateMap(size_type n) {
         MapPtr p = nullptr;
@@ -343,18 +404,27 @@ protected:
     }
 
     T* allocateNode() {
-        T* node = nullptr;
-        try {
-            node = alloc.allocate(kBufferSize);
-            return node;
-        } catch (...) {
-            deallocateNode(node);
-            throw;
-        }
+        if (spare_count != 0)
+            return spare[--spare_count];
+        return alloc.allocate(kBufferSize);
     }
 
-    void deallocateNode(T* p) {
-        alloc.deallocate(p, kBufferSize);
+    void deallocateNode(T* p) noexcept {
+        if (spare_count != kSpareNodes)
+            spare[spare_count++] = p;
+        else
+            alloc.deallocate(p, kBufferSize);
+    }
+
+    void releaseSpareNodes() noexcept {
+        while (spare_count != 0)
+            alloc.deallocate(spare[--spare_count], kBufferSize);
+    }
+
+    void swapSpareNodes(DequeBase& rhs) noexcept {
+        for (size_type i = 0; i < kSpareNodes; ++i)
+            tiny_stl::swap(spare[i], rhs.spare[i]);
+        tiny_stl::swap(spare_count, rhs.spare_count);
     }
 
     void initializerMap(size_type n) {
@@ -394,26 +464,37 @@ protected:
                 deallocateNode(*cur);
     }
 
+    // release the buffers and the map, elements must be destroyed already
+    void releaseStorage() noexcept {
+        if (map_ptr != nullptr) {
+            deallocNodes(start.node, finish.node + 1);
+            deallocateMap(map_ptr, map_size);
+            map_ptr = nullptr;
+            map_size = 0;
+        }
+        releaseSpareNodes();
+    }
+
 public:
     DequeBase(const Alloc& a)
-        : start(), finish(), map_ptr(), map_size(0), alloc(a), alloc_map() {
+        : start(), finish(), map_ptr(), map_size(0), alloc(a), alloc_map(),
+          spare_count(0) {
     }
 
     DequeBase(const Alloc& a, size_type num_elements)
-        : start(), finish(), map_ptr(), map_size(0), alloc(a), alloc_map() {
+        : start(), finish(), map_ptr(), map_size(0), alloc(a), alloc_map(),
+          spare_count(0) {
         initializerMap(num_elements);
     }
 
     ~DequeBase() {
-        if (map_ptr != nullptr) {
-            deallocNodes(start.node, finish.node + 1);
-            deallocateMap(map_ptr, map_size);
-        }
+        releaseStorage();
     }
-}; // class DequeBase<T, Alloc>
+}; // class DequeBase<T, Alloc, BlockSize>
 
-template <typename T, typename Alloc = allocator<T>>
-class deque : public DequeBase<T, Alloc> {
+template <typename T, typename Alloc = allocator<T>,
+          typename BlockSize = deque_block_size<T>>
+class deque : public DequeBase<T, Alloc, BlockSize> {
 public:
     static_assert(is_same<T, typename Alloc::value_type>::value,
                   "Allocator::value_type is not the same as T");
@@ -427,8 +508,8 @@ public:
     using const_pointer = const T*;
     using reference = T&;
     using const_reference = const T&;
-    using iterator = DequeIterator<T>;
-    using const_iterator = DequeConstIterator<T>;
+    using iterator = DequeIterator<T, BlockSize::value>;
+    using const_iterator = DequeConstIterator<T, BlockSize::value>;
     using reverse_iterator = tiny_stl::reverse_iterator<iterator>;
     using const_reverse_iterator = tiny_stl::reverse_iterator<const_iterator>;
 
@@ -436,13 +517,14 @@ protected:
     using MapPtr = pointer*;
     using AlPtr =
         typename allocator_traits<Alloc>::template rebind_alloc<pointer>;
-    using Base = DequeBase<T, Alloc>;
-    using Self = deque<T, Alloc>;
+    using Base = DequeBase<T, Alloc, BlockSize>;
+    using Self = deque<T, Alloc, BlockSize>;
 
 private:
     using Base::alloc;
     using Base::alloc_map;
     using Base::allocateNode;
+    using Base::deallocateNode;
     using Base::finish;
     using Base::kBufferSize;
     using Base::map_ptr;
@@ -453,12 +535,12 @@ private:
     void fillInitialize(const T& val) {
         for (MapPtr node = this->start.node; node != this->finish.node; ++node)
             // fill complete buffer
-            uninitialized_fill(*node, *node + kBufferSize, val);
-        uninitialized_fill(this->finish.first, this->finish.cur, val);
+            tiny_stl::uninitialized_fill(*node, *node + kBufferSize, val);
+        tiny_stl::uninitialized_fill(this->finish.first, this->finish.cur, val);
     }
 
     void tidy() {
-        destroy(this->start, this->finish);
+        tiny_stl::destroy(this->start, this->finish);
     }
 
 public:
@@ -485,7 +567,7 @@ public:
     deque(InIter first, InIter last, const Alloc& a = Alloc())
         : Base(a, last - first) {
         try {
-            uninitialized_copy(first, last, this->start);
+            tiny_stl::uninitialized_copy(first, last, this->start);
         } catch (...) {
             tidy();
             throw;
@@ -498,7 +580,7 @@ public:
                    rhs.alloc),
                rhs.size()) {
         try {
-            uninitialized_copy(rhs.begin(), rhs.end(), this->start);
+            tiny_stl::uninitialized_copy(rhs.begin(), rhs.end(), this->start);
         } catch (...) {
             tidy();
             throw;
@@ -508,7 +590,7 @@ public:
     // (5)
     deque(const deque& rhs, const Alloc& a) : Base(a, rhs.size()) {
         try {
-            uninitialized_copy(rhs.begin(), rhs.end(), this->start);
+            tiny_stl::uninitialized_copy(rhs.begin(), rhs.end(), this->start);
         } catch (...) {
             tidy();
             throw;
@@ -530,7 +612,7 @@ private:
 
     template <typename Iter>
     void constructHelper(Iter first, Iter last) {
-        while (first != last)
+        for (; first != last; ++first)
             emplace_back(*first);
     }
 
@@ -539,8 +621,26 @@ private:
             assignMove(tiny_stl::move(rhs), true_type{});
 
         else
-            constructHelper(tiny_stl::make_move_iterator(begin()),
-                            tiny_stl::make_move_iterator(end()));
+            constructHelper(tiny_stl::make_move_iterator(rhs.begin()),
+                            tiny_stl::make_move_iterator(rhs.end()));
+    }
+
+    // propagate allocator: release our storage and steal rhs's
+    void moveAssign(deque&& rhs, true_type) {
+        tidy();
+        this->releaseStorage();
+        this->alloc = tiny_stl::move(rhs.alloc);
+        this->alloc_map = tiny_stl::move(rhs.alloc_map);
+        assignMove(tiny_stl::move(rhs), true_type{});
+    }
+
+    void moveAssign(deque&& rhs, false_type) {
+        if (this->alloc == rhs.alloc) {
+            moveAssign(tiny_stl::move(rhs), true_type{});
+        } else { // storage of rhs can't be adopted, move element-wise
+            clear();
+            assignMove(tiny_stl::move(rhs), false_type{});
+        }
     }
 
 public:
@@ -551,6 +651,8 @@ public:
 
     // (7)
     deque(deque&& rhs, const Alloc& a) : Base(a) {
+        if (this->alloc != rhs.alloc)
+            this->initializerMap(0);
         assignMove(tiny_stl::move(rhs), false_type{});
     }
 
@@ -558,7 +660,8 @@ public:
     deque(std::initializer_list<T> ilist, const Alloc& a = Alloc())
         : Base(a, ilist.size()) {
         try {
-            uninitialized_copy(ilist.begin(), ilist.end(), this->start);
+            tiny_stl::uninitialized_copy(ilist.begin(), ilist.end(),
+                                         this->start);
         } catch (...) {
             tidy();
             throw;
@@ -601,10 +704,7 @@ public:
     deque& operator=(deque&& rhs) noexcept(
         noexcept(allocator_traits<Alloc>::is_always_equal::value)) {
         assert(this != tiny_stl::addressof(rhs));
-        tidy();
-        this->alloc = tiny_stl::move(rhs.alloc);
-        this->alloc_map = tiny_stl::move(rhs.alloc_map);
-        assignMove(tiny_stl::move(rhs),
+        moveAssign(tiny_stl::move(rhs),
                    typename allocator_traits<
                        Alloc>::propagate_on_container_move_assignment{});
 
@@ -739,30 +839,52 @@ public:
         return static_cast<size_type>(-1);
     }
 
+    // Release the spare buffers and shrink the map to the buffers in use.
+    // No element is moved, so references stay valid, but iterators are
+    // invalidated because the map is replaced.
     void shrink_to_fit() {
-        deque tmp{tiny_stl::make_move_iterator(begin()),
-                  tiny_stl::make_move_iterator(end())};
-        swap(tmp);
+        this->releaseSpareNodes();
+        if (map_ptr == nullptr)
+            return;
+
+        size_type num_nodes = finish.node - start.node + 1;
+        if (num_nodes == map_size)
+            return;
+
+        MapPtr new_map = nullptr;
+        try {
+            new_map = this->allocateMap(num_nodes);
+        } catch (...) {
+            return; // shrink_to_fit is non-binding, keep the old map
+        }
+
+        tiny_stl::copy(start.node, finish.node + 1, new_map);
+        this->deallocateMap(map_ptr, map_size);
+
+        map_ptr = new_map;
+        map_size = num_nodes;
+        start.setNode(new_map);
+        finish.setNode(new_map + num_nodes - 1);
     }
 
 public:
     void clear() noexcept {
         // Except for the first and last buffers
         for (MapPtr p = start.node + 1; p < finish.node; ++p) {
-            destroy(*p, *p + kBufferSize);
-            this->alloc.deallocate(*p, kBufferSize);
+            tiny_stl::destroy(*p, *p + kBufferSize);
+            deallocateNode(*p);
         }
 
         // There are at least two buffers
         if (start.node != finish.node) {
-            destroy(start.cur, start.last);
-            destroy(finish.first, finish.cur);
+            tiny_stl::destroy(start.cur, start.last);
+            tiny_stl::destroy(finish.first, finish.cur);
 
             // Release the last buffer, reserve the first buffer
-            this->alloc.deallocate(finish.first, kBufferSize);
+            deallocateNode(finish.first);
         } else {
             // There is only one buffer, reserve the buffer, no deallocate
-            destroy(start.cur, finish.cur);
+            tiny_stl::destroy(start.cur, finish.cur);
         }
 
         finish = start;
@@ -782,10 +904,10 @@ private:
             // Avoid coverage
             try {
                 if (new_nstart < start.node)
-                    copy(start.node, finish.node + 1, new_nstart);
+                    tiny_stl::copy(start.node, finish.node + 1, new_nstart);
                 else
-                    copy_backward(start.node, finish.node + 1,
-                                  new_nstart + old_num_nodes);
+                    tiny_stl::copy_backward(start.node, finish.node + 1,
+                                            new_nstart + old_num_nodes);
             } catch (...) {
                 tidy();
                 throw;
@@ -800,7 +922,7 @@ private:
                 new_nstart =
                     new_map + (new_map_size - new_num_nodes) / 2 + num_add;
 
-                copy(start.node, finish.node + 1,
+                tiny_stl::copy(start.node, finish.node + 1,
                      new_nstart); // copy origin node to new map
             } catch (...) {
 
@@ -832,7 +954,7 @@ private:
             new_map = this->alloc_map.allocate(new_map_size); // reallocate
             new_nstart = new_map + (new_map_size - new_num_nodes) / 2;
 
-            copy(start.node, finish.node + 1,
+            tiny_stl::copy(start.node, finish.node + 1,
                  new_nstart); // copy origin node to new map
         } catch (...) {
             this->alloc_map.deallocate(new_map, new_map_size);
@@ -969,6 +1091,9 @@ private:
         size_type reoffset = size() - offset;
         size_type oldSize = size();
 
+        if (count == 0) // the moves below would self-assign
+            return;
+
         if (offset < oldSize / 2) { // front
             if (offset < count) {   // prefix < count
                 for (size_type i = count - offset; i > 0; --i)
@@ -1096,7 +1221,9 @@ public:
 
         assert(f == l || (f < l && f >= begin() && l <= end()));
 
-        if (f == l && last == finish) {
+        if (f == l) {
+            return f;
+        } else if (f == start && l == finish) {
             clear();
             return end();
         } else {
@@ -1104,9 +1231,9 @@ public:
             size_type num_before = f - start;
 
             if (num_before < (size() - num_erase) / 2) { // front
-                move_backward(start, f, l);
+                tiny_stl::move_backward(start, f, l);
                 iterator new_start = start + num_erase;
-                destroy(start, new_start);
+                tiny_stl::destroy(start, new_start);
 
                 for (MapPtr cur = start.node; cur < new_start.node; ++cur)
                     this->deallocateNode(*cur);
@@ -1114,7 +1241,7 @@ public:
             } else { // back
                 tiny_stl::move(l, finish, f);
                 iterator new_finish = finish - num_erase;
-                destroy(new_finish, finish);
+                tiny_stl::destroy(new_finish, finish);
 
                 for (MapPtr cur = new_finish.node + 1; cur <= finish.node;
                      ++cur)
@@ -1150,46 +1277,113 @@ public:
         tiny_stl::swap(this->start, rhs.start);
         tiny_stl::swap(this->finish, rhs.finish);
         tiny_stl::swap(this->map_size, rhs.map_size);
+        this->swapSpareNodes(rhs);
     }
 
 }; // class deque<T, Alloc>
 
-template <typename T, typename Alloc>
-inline bool operator==(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs) {
+template <typename T, typename Alloc, typename BlockSize>
+inline bool operator==(const deque<T, Alloc, BlockSize>& lhs,
+                       const deque<T, Alloc, BlockSize>& rhs) {
     return lhs.size() == rhs.size() &&
            tiny_stl::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
-template <typename T, typename Alloc>
-inline bool operator!=(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs) {
+template <typename T, typename Alloc, typename BlockSize>
+inline bool operator!=(const deque<T, Alloc, BlockSize>& lhs,
+                       const deque<T, Alloc, BlockSize>& rhs) {
     return !(lhs == rhs);
 }
 
-template <typename T, typename Alloc>
-inline bool operator<(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs) {
+template <typename T, typename Alloc, typename BlockSize>
+inline bool operator<(const deque<T, Alloc, BlockSize>& lhs,
+                      const deque<T, Alloc, BlockSize>& rhs) {
     return tiny_stl::lexicographical_compare(lhs.begin(), lhs.end(),
                                              rhs.begin(), rhs.end());
 }
 
-template <typename T, typename Alloc>
-inline bool operator>(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs) {
+template <typename T, typename Alloc, typename BlockSize>
+inline bool operator>(const deque<T, Alloc, BlockSize>& lhs,
+                      const deque<T, Alloc, BlockSize>& rhs) {
     return rhs < lhs;
 }
 
-template <typename T, typename Alloc>
-inline bool operator<=(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs) {
+template <typename T, typename Alloc, typename BlockSize>
+inline bool operator<=(const deque<T, Alloc, BlockSize>& lhs,
+                       const deque<T, Alloc, BlockSize>& rhs) {
     return !(rhs < lhs);
 }
 
-template <typename T, typename Alloc>
-inline bool operator>=(const deque<T, Alloc>& lhs, const deque<T, Alloc>& rhs) {
+template <typename T, typename Alloc, typename BlockSize>
+inline bool operator>=(const deque<T, Alloc, BlockSize>& lhs,
+                       const deque<T, Alloc, BlockSize>& rhs) {
     return !(lhs < rhs);
 }
 
-template <typename T, typename Alloc>
-inline void swap(deque<T, Alloc>& lhs,
-                 deque<T, Alloc>& rhs) noexcept(noexcept(lhs.swap(rhs))) {
+template <typename T, typename Alloc, typename BlockSize>
+inline void swap(deque<T, Alloc, BlockSize>& lhs,
+                 deque<T, Alloc, BlockSize>& rhs) noexcept(
+    noexcept(lhs.swap(rhs))) {
     lhs.swap(rhs);
 }
 
+namespace details {
+
+template <typename T, std::size_t BufSize, typename Compare>
+inline void dequeSort(DequeIterator<T, BufSize> first,
+                      DequeIterator<T, BufSize> last, Compare& cmp,
+                      false_type) {
+    details::quickSort(first, last, last - first, cmp);
+}
+
+// move into a contiguous buffer, sort it there and move back
+template <typename T, std::size_t BufSize, typename Compare>
+inline void dequeSort(DequeIterator<T, BufSize> first,
+                      DequeIterator<T, BufSize> last, Compare& cmp,
+                      true_type /* nothrow move */) {
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    allocator<T> al;
+    T* buf = nullptr;
+
+    try {
+        buf = al.allocate(n);
+    } catch (...) { // out of memory, sort in place
+        dequeSort(first, last, cmp, false_type{});
+        return;
+    }
+
+    T* p = buf;
+    forEachSegment(first, last, [&p](T* lfirst, T* llast) {
+        for (; lfirst != llast; ++lfirst, ++p)
+            constructInPlace(*p, tiny_stl::move(*lfirst));
+    });
+
+    try {
+        details::quickSort(buf, buf + n, static_cast<std::ptrdiff_t>(n), cmp);
+    } catch (...) {
+        tiny_stl::move(buf, buf + n, first);
+        destroyRange(buf, buf + n);
+        al.deallocate(buf, n);
+        throw;
+    }
+
+    tiny_stl::move(buf, buf + n, first);
+    destroyRange(buf, buf + n);
+    al.deallocate(buf, n);
+}
+
+// every step of the introsort through DequeIterator pays for a block check,
+// so elements that move without throwing are sorted in a contiguous buffer
+template <typename T, std::size_t BufSize>
+struct SortDispatch<DequeIterator<T, BufSize>> {
+    template <typename Compare>
+    static void sort(DequeIterator<T, BufSize> first,
+                     DequeIterator<T, BufSize> last, Compare& cmp) {
+        if (last - first > 1)
+            dequeSort(first, last, cmp, is_nothrow_move_constructible<T>{});
+    }
+};
+
+} // namespace details
+
 } // namespace tiny_stl
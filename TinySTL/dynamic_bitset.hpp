@@ -0,0 +1,498 @@
+// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+#include "vector.hpp"
+
+#if defined(TINY_STL_AVX2)
+#include <immintrin.h>
+#elif defined(TINY_STL_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace tiny_stl {
+
+namespace details {
+
+// Word operations of the bulk kernels, with the same operation on SSE2 and
+// AVX2 vectors. AndNot is a & ~b.
+struct BitAnd {
+    static BitWord word(BitWord a, BitWord b) noexcept {
+        return a & b;
+    }
+#if defined(TINY_STL_AVX2)
+    static __m256i vec(__m256i a, __m256i b) noexcept {
+        return _mm256_and_si256(a, b);
+    }
+#elif defined(TINY_STL_SSE2)
+    static __m128i vec(__m128i a, __m128i b) noexcept {
+        return _mm_and_si128(a, b);
+    }
+#endif
+};
+
+struct BitOr {
+    static BitWord word(BitWord a, BitWord b) noexcept {
+        return a | b;
+    }
+#if defined(TINY_STL_AVX2)
+    static __m256i vec(__m256i a, __m256i b) noexcept {
+        return _mm256_or_si256(a, b);
+    }
+#elif defined(TINY_STL_SSE2)
+    static __m128i vec(__m128i a, __m128i b) noexcept {
+        return _mm_or_si128(a, b);
+    }
+#endif
+};
+
+struct BitXor {
+    static BitWord word(BitWord a, BitWord b) noexcept {
+        return a ^ b;
+    }
+#if defined(TINY_STL_AVX2)
+    static __m256i vec(__m256i a, __m256i b) noexcept {
+        return _mm256_xor_si256(a, b);
+    }
+#elif defined(TINY_STL_SSE2)
+    static __m128i vec(__m128i a, __m128i b) noexcept {
+        return _mm_xor_si128(a, b);
+    }
+#endif
+};
+
+struct BitAndNot {
+    static BitWord word(BitWord a, BitWord b) noexcept {
+        return a & ~b;
+    }
+#if defined(TINY_STL_AVX2)
+    static __m256i vec(__m256i a, __m256i b) noexcept {
+        return _mm256_andnot_si256(b, a);
+    }
+#elif defined(TINY_STL_SSE2)
+    static __m128i vec(__m128i a, __m128i b) noexcept {
+        return _mm_andnot_si128(b, a);
+    }
+#endif
+};
+
+// dst[i] = Op(a[i], b[i]), dst may be a or b
+template <typename Op>
+inline void bitwiseWords(BitWord* dst, const BitWord* a, const BitWord* b,
+                         std::size_t n) noexcept {
+#if defined(TINY_STL_AVX2)
+    for (; n >= 8; n -= 8, dst += 8, a += 8, b += 8) {
+        const __m256i* pa = reinterpret_cast<const __m256i*>(a);
+        const __m256i* pb = reinterpret_cast<const __m256i*>(b);
+        __m256i* pd = reinterpret_cast<__m256i*>(dst);
+        const __m256i r0 =
+            Op::vec(_mm256_loadu_si256(pa), _mm256_loadu_si256(pb));
+        const __m256i r1 =
+            Op::vec(_mm256_loadu_si256(pa + 1), _mm256_loadu_si256(pb + 1));
+        _mm256_storeu_si256(pd, r0);
+        _mm256_storeu_si256(pd + 1, r1);
+    }
+#elif defined(TINY_STL_SSE2)
+    for (; n >= 4; n -= 4, dst += 4, a += 4, b += 4) {
+        const __m128i* pa = reinterpret_cast<const __m128i*>(a);
+        const __m128i* pb = reinterpret_cast<const __m128i*>(b);
+        __m128i* pd = reinterpret_cast<__m128i*>(dst);
+        const __m128i r0 = Op::vec(_mm_loadu_si128(pa), _mm_loadu_si128(pb));
+        const __m128i r1 =
+            Op::vec(_mm_loadu_si128(pa + 1), _mm_loadu_si128(pb + 1));
+        _mm_storeu_si128(pd, r0);
+        _mm_storeu_si128(pd + 1, r1);
+    }
+#endif
+    for (std::size_t i = 0; i < n; ++i)
+        dst[i] = Op::word(a[i], b[i]);
+}
+
+// number of set bits in n words
+inline std::size_t popCountWords(const BitWord* w, std::size_t n) noexcept {
+    std::size_t total = 0;
+    std::size_t i = 0;
+#if defined(TINY_STL_AVX2)
+    // nibble lookup with pshufb, byte counts summed by psadbw
+    const __m256i lookup =
+        _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1,
+                         1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowNibble = _mm256_set1_epi8(0x0f);
+    __m256i acc = _mm256_setzero_si256();
+    for (; i + 4 <= n; i += 4) {
+        const __m256i v =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + i));
+        const __m256i lo = _mm256_and_si256(v, lowNibble);
+        const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), lowNibble);
+        const __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                                              _mm256_shuffle_epi8(lookup, hi));
+        acc = _mm256_add_epi64(
+            acc, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+    }
+    total += static_cast<std::size_t>(_mm256_extract_epi64(acc, 0)) +
+             static_cast<std::size_t>(_mm256_extract_epi64(acc, 1)) +
+             static_cast<std::size_t>(_mm256_extract_epi64(acc, 2)) +
+             static_cast<std::size_t>(_mm256_extract_epi64(acc, 3));
+#elif defined(TINY_STL_SSE2) && !defined(__POPCNT__)
+    // without a popcnt instruction, count both words of a vector at once
+    // by adding adjacent bit fields, byte counts summed by psadbw
+    const __m128i m1 = _mm_set1_epi8(0x55);
+    const __m128i m2 = _mm_set1_epi8(0x33);
+    const __m128i m4 = _mm_set1_epi8(0x0f);
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 2 <= n; i += 2) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w + i));
+        v = _mm_sub_epi8(v, _mm_and_si128(_mm_srli_epi64(v, 1), m1));
+        v = _mm_add_epi8(_mm_and_si128(v, m2),
+                         _mm_and_si128(_mm_srli_epi64(v, 2), m2));
+        v = _mm_and_si128(_mm_add_epi8(v, _mm_srli_epi64(v, 4)), m4);
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(v, _mm_setzero_si128()));
+    }
+    // read the lane sums as full 64-bit values, movq is x86-64 only
+    std::uint64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    total += static_cast<std::size_t>(lanes[0] + lanes[1]);
+#endif
+    for (; i < n; ++i)
+        total += popCount(w[i]);
+    return total;
+}
+
+} // namespace details
+
+// Bitset whose size is chosen at run time, for set algebra over dense ID
+// spaces. Bits live in a vector of 64-bit blocks, the bits of the last
+// block past size() are always zero so whole-block operations need no
+// masking. The binary operations need operands of the same size.
+template <typename Alloc = allocator<std::uint64_t>>
+class dynamic_bitset {
+public:
+    using block_type = std::uint64_t;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using reference = BitReference;
+    using const_reference = bool;
+
+    static_assert(tiny_stl::is_same_v<block_type, typename Alloc::value_type>,
+                  "Alloc::value_type is not the same as block_type");
+
+    constexpr static const size_type bits_per_block = 64;
+    constexpr static const size_type npos = static_cast<size_type>(-1);
+
+private:
+    vector<block_type, Alloc> blocks;
+    size_type nbits;
+
+private:
+    static size_type blockCount(size_type n) noexcept {
+        return (n + bits_per_block - 1) / bits_per_block;
+    }
+
+    // clear the bits of the last block past size()
+    void trimLast() noexcept {
+        const unsigned used = static_cast<unsigned>(nbits % bits_per_block);
+        if (used != 0)
+            blocks.back() &= details::bitMask(0, used);
+    }
+
+    size_type findFrom(size_type w, block_type bits) const noexcept {
+        const size_type n = blocks.size();
+        for (;;) {
+            if (bits != 0)
+                return w * bits_per_block + details::countTrailingZeros(bits);
+            if (++w == n)
+                return npos;
+            bits = blocks[w];
+        }
+    }
+
+    template <typename Op>
+    dynamic_bitset& applyInPlace(const dynamic_bitset& rhs) noexcept {
+        assert(nbits == rhs.nbits);
+        details::bitwiseWords<Op>(blocks.data(), blocks.data(),
+                                  rhs.blocks.data(), blocks.size());
+        return *this;
+    }
+
+    template <typename Op>
+    dynamic_bitset& applyInto(const dynamic_bitset& a,
+                              const dynamic_bitset& b) {
+        assert(a.nbits == b.nbits);
+        blocks.resize(a.blocks.size());
+        nbits = a.nbits;
+        details::bitwiseWords<Op>(blocks.data(), a.blocks.data(),
+                                  b.blocks.data(), blocks.size());
+        return *this;
+    }
+
+public:
+    dynamic_bitset() noexcept(noexcept(Alloc())) : dynamic_bitset(Alloc()) {
+    }
+
+    explicit dynamic_bitset(const Alloc& alloc) noexcept
+        : blocks(alloc), nbits(0) {
+    }
+
+    explicit dynamic_bitset(size_type n, bool val = false,
+                            const Alloc& alloc = Alloc())
+        : blocks(blockCount(n), val ? ~block_type(0) : block_type(0), alloc),
+          nbits(n) {
+        trimLast();
+    }
+
+    allocator_type get_allocator() const {
+        return blocks.get_allocator();
+    }
+
+public:
+    size_type size() const noexcept {
+        return nbits;
+    }
+
+    bool empty() const noexcept {
+        return nbits == 0;
+    }
+
+    size_type num_blocks() const noexcept {
+        return blocks.size();
+    }
+
+    const block_type* data() const noexcept {
+        return blocks.data();
+    }
+
+    void reserve(size_type n) {
+        blocks.reserve(blockCount(n));
+    }
+
+    void resize(size_type n, bool val = false) {
+        const size_type oldSize = nbits;
+        const unsigned used = static_cast<unsigned>(oldSize % bits_per_block);
+        if (val && n > oldSize && used != 0)
+            blocks.back() |= ~details::bitMask(0, used);
+
+        blocks.resize(blockCount(n), val ? ~block_type(0) : block_type(0));
+        nbits = n;
+        trimLast();
+    }
+
+    void clear() noexcept {
+        blocks.clear();
+        nbits = 0;
+    }
+
+    void push_back(bool val) {
+        if (nbits % bits_per_block == 0)
+            blocks.push_back(block_type(0));
+        if (val)
+            blocks.back() |= block_type(1) << (nbits % bits_per_block);
+        ++nbits;
+    }
+
+public:
+    bool test(size_type pos) const {
+        if (pos >= nbits)
+            xRange();
+        return (*this)[pos];
+    }
+
+    const_reference operator[](size_type pos) const noexcept {
+        return (blocks[pos / bits_per_block] >> (pos % bits_per_block)) & 1;
+    }
+
+    reference operator[](size_type pos) noexcept {
+        return reference(blocks.data() + pos / bits_per_block,
+                         block_type(1) << (pos % bits_per_block));
+    }
+
+    dynamic_bitset& set(size_type pos, bool val = true) {
+        if (pos >= nbits)
+            xRange();
+        (*this)[pos] = val;
+        return *this;
+    }
+
+    dynamic_bitset& set() noexcept {
+        for (block_type& w : blocks)
+            w = ~block_type(0);
+        trimLast();
+        return *this;
+    }
+
+    dynamic_bitset& reset(size_type pos) {
+        return set(pos, false);
+    }
+
+    dynamic_bitset& reset() noexcept {
+        for (block_type& w : blocks)
+            w = 0;
+        return *this;
+    }
+
+    dynamic_bitset& flip(size_type pos) {
+        if (pos >= nbits)
+            xRange();
+        (*this)[pos].flip();
+        return *this;
+    }
+
+    dynamic_bitset& flip() noexcept {
+        for (block_type& w : blocks)
+            w = ~w;
+        trimLast();
+        return *this;
+    }
+
+    size_type count() const noexcept {
+        return details::popCountWords(blocks.data(), blocks.size());
+    }
+
+    bool any() const noexcept {
+        for (block_type w : blocks)
+            if (w != 0)
+                return true;
+        return false;
+    }
+
+    bool none() const noexcept {
+        return !any();
+    }
+
+    bool all() const noexcept {
+        return count() == nbits;
+    }
+
+    // index of the first set bit, npos if none
+    size_type find_first() const noexcept {
+        return blocks.empty() ? npos : findFrom(0, blocks[0]);
+    }
+
+    // index of the first set bit after pos, npos if none
+    size_type find_next(size_type pos) const noexcept {
+        if (nbits == 0 || pos >= nbits - 1)
+            return npos;
+        ++pos;
+        const size_type w = pos / bits_per_block;
+        return findFrom(w, blocks[w] & (~block_type(0)
+                                        << (pos % bits_per_block)));
+    }
+
+public:
+    dynamic_bitset& operator&=(const dynamic_bitset& rhs) noexcept {
+        return applyInPlace<details::BitAnd>(rhs);
+    }
+
+    dynamic_bitset& operator|=(const dynamic_bitset& rhs) noexcept {
+        return applyInPlace<details::BitOr>(rhs);
+    }
+
+    dynamic_bitset& operator^=(const dynamic_bitset& rhs) noexcept {
+        return applyInPlace<details::BitXor>(rhs);
+    }
+
+    // clear the bits set in rhs
+    dynamic_bitset& operator-=(const dynamic_bitset& rhs) noexcept {
+        return applyInPlace<details::BitAndNot>(rhs);
+    }
+
+    // *this = a & b, reusing the storage of *this
+    dynamic_bitset& assign_and(const dynamic_bitset& a,
+                               const dynamic_bitset& b) {
+        return applyInto<details::BitAnd>(a, b);
+    }
+
+    dynamic_bitset& assign_or(const dynamic_bitset& a,
+                              const dynamic_bitset& b) {
+        return applyInto<details::BitOr>(a, b);
+    }
+
+    dynamic_bitset& assign_xor(const dynamic_bitset& a,
+                               const dynamic_bitset& b) {
+        return applyInto<details::BitXor>(a, b);
+    }
+
+    // *this = a & ~b
+    dynamic_bitset& assign_and_not(const dynamic_bitset& a,
+                                   const dynamic_bitset& b) {
+        return applyInto<details::BitAndNot>(a, b);
+    }
+
+    dynamic_bitset operator~() const {
+        dynamic_bitset tmp(*this);
+        tmp.flip();
+        return tmp;
+    }
+
+    void swap(dynamic_bitset& rhs) noexcept(noexcept(blocks.swap(rhs.blocks))) {
+        blocks.swap(rhs.blocks);
+        tiny_stl::swap(nbits, rhs.nbits);
+    }
+
+    friend bool operator==(const dynamic_bitset& lhs,
+                           const dynamic_bitset& rhs) noexcept {
+        return lhs.nbits == rhs.nbits && lhs.blocks == rhs.blocks;
+    }
+
+    friend bool operator!=(const dynamic_bitset& lhs,
+                           const dynamic_bitset& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+private:
+    [[noreturn]] static void xRange() {
+        throw "invalid dynamic_bitset position";
+    }
+}; // class dynamic_bitset<Alloc>
+
+template <typename Alloc>
+constexpr const typename dynamic_bitset<Alloc>::size_type
+    dynamic_bitset<Alloc>::bits_per_block;
+
+template <typename Alloc>
+constexpr const typename dynamic_bitset<Alloc>::size_type
+    dynamic_bitset<Alloc>::npos;
+
+template <typename Alloc>
+inline dynamic_bitset<Alloc> operator&(const dynamic_bitset<Alloc>& lhs,
+                                       const dynamic_bitset<Alloc>& rhs) {
+    dynamic_bitset<Alloc> tmp(lhs.get_allocator());
+    tmp.assign_and(lhs, rhs);
+    return tmp;
+}
+
+template <typename Alloc>
+inline dynamic_bitset<Alloc> operator|(const dynamic_bitset<Alloc>& lhs,
+                                       const dynamic_bitset<Alloc>& rhs) {
+    dynamic_bitset<Alloc> tmp(lhs.get_allocator());
+    tmp.assign_or(lhs, rhs);
+    return tmp;
+}
+
+template <typename Alloc>
+inline dynamic_bitset<Alloc> operator^(const dynamic_bitset<Alloc>& lhs,
+                                       const dynamic_bitset<Alloc>& rhs) {
+    dynamic_bitset<Alloc> tmp(lhs.get_allocator());
+    tmp.assign_xor(lhs, rhs);
+    return tmp;
+}
+
+template <typename Alloc>
+inline dynamic_bitset<Alloc> operator-(const dynamic_bitset<Alloc>& lhs,
+                                       const dynamic_bitset<Alloc>& rhs) {
+    dynamic_bitset<Alloc> tmp(lhs.get_allocator());
+    tmp.assign_and_not(lhs, rhs);
+    return tmp;
+}
+
+template <typename Alloc>
+inline void swap(dynamic_bitset<Alloc>& lhs,
+                 dynamic_bitset<Alloc>& rhs) noexcept(noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
+} // namespace tiny_stl
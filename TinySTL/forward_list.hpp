@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <climits>
 #include <initializer_list>
 
 #include "memory.hpp"
@@ -263,7 +264,7 @@ public:
 
 private:
     void constructMove(forward_list&& rhs, true_type) {
-        swapADL(this->getHead(), rhs.getHead());
+        tiny_stl::swap(this->getHead(), rhs.getHead());
     }
 
     void constructMove(forward_list&& rhs, false_type) {
@@ -530,7 +531,7 @@ public:
         allocator_traits<Alloc>::is_always_equal::value) {
         if (this != tiny_stl::addressof(rhs)) {
             swapAlloc(this->getAlloc(), rhs.getAlloc());
-            swapADL(this->getHead(), rhs.getHead());
+            tiny_stl::swap(this->getHead(), rhs.getHead());
         }
     }
 
@@ -578,45 +579,123 @@ private:
         }
     }
 
-    // merge sort
-    template <typename BinPred>
-    void sortAux(iterator before_first, iterator last, BinPred pred,
-                 size_type size) {
-        if (size < 2)
+    // Merge the sorted null-terminated chain src into dst. Stable, nodes of
+    // dst go before equal nodes of src. Links are only rewritten where the
+    // merged order switches between the two chains. If cmp throws, dst still
+    // owns every node of both chains.
+    template <typename Cmp>
+    static void mergeChains(NodePtr& dst, NodePtr src, Cmp& cmp) {
+        if (src == nullptr)
+            return;
+        if (dst == nullptr) {
+            dst = src;
             return;
+        }
 
-        size_type mid_size = size >> 1;
+        NodePtr first = dst;
+        NodePtr tail = nullptr; // last node of the merged part
+        bool fromSrc = false;   // the chain being consumed, linked to tail
 
-        iterator mid = tiny_stl::next(before_first, 1 + mid_size); // init mid
-        sortAux(before_first, mid, pred, mid_size); // sort first half
+        try {
+            fromSrc = cmp(src->data, first->data);
+            if (fromSrc)
+                dst = src;
+
+            for (;;) {
+                if (fromSrc) {
+                    do {
+                        tail = src;
+                        src = src->next;
+                        if (src != nullptr)
+                            TINY_STL_PREFETCH(src->next);
+                    } while (src != nullptr && cmp(src->data, first->data));
+
+                    tail->next = first;
+                    if (src == nullptr)
+                        return;
+                } else {
+                    do {
+                        tail = first;
+                        first = first->next;
+                        if (first != nullptr)
+                            TINY_STL_PREFETCH(first->next);
+                    } while (first != nullptr && !cmp(src->data, first->data));
+
+                    tail->next = src;
+                    if (first == nullptr)
+                        return;
+                }
+
+                fromSrc = !fromSrc;
+            }
+        } catch (...) {
+            dst = appendChain(dst, fromSrc ? first : src);
+            throw;
+        }
+    }
 
-        // init before_mid
-        iterator before_mid = tiny_stl::next(before_first, mid_size);
-        sortAux(before_mid, last, pred, size - mid_size); // sort second half
+    static NodePtr appendChain(NodePtr first, NodePtr second) noexcept {
+        if (first == nullptr)
+            return second;
 
-        // Because the iterator mid does not fail
-        // the previous sort will change the mid
-        // therefore, update the itertor mid
-        mid = tiny_stl::next(before_mid);
-        iterator first = tiny_stl::next(before_first);
+        NodePtr p = first;
+        while (p->next != nullptr)
+            p = p->next;
+        p->next = second;
 
-        // sort [first, mid) and [mid, last)
-        for (;;) {
-            if (pred(*mid, *first)) { // *mid < *first
-                splice_after(before_first, *this, before_mid);
-                ++before_first;
-                mid = tiny_stl::next(before_mid);
+        return first;
+    }
 
-                if (mid == last)
-                    return;
-            } else { // *mid >= *first
-                ++before_first;
-                ++first;
+    // Bottom-up merge sort without recursion or allocation. bins[i] holds a
+    // sorted chain of 2^i nodes (or is empty), every new node is carried up
+    // through the occupied bins like a binary counter.
+    template <typename Cmp>
+    void sortAux(Cmp& cmp) {
+        NodePtr rest = this->getHead()->next;
+        if (rest == nullptr || rest->next == nullptr)
+            return;
+
+        NodePtr result = nullptr;
+        NodePtr bins[sizeof(size_type) * CHAR_BIT] = {};
+        size_type fill = 0; // bins in use are [0, fill)
+
+        try {
+            while (rest != nullptr) {
+                NodePtr carry = rest;
+                rest = rest->next;
+                carry->next = nullptr;
+
+                size_type i = 0;
+                for (; bins[i] != nullptr; ++i) {
+                    mergeChains(bins[i], carry, cmp); // bins[i] is older
+                    carry = bins[i];
+                    bins[i] = nullptr;
+                }
+
+                bins[i] = carry;
+                if (i == fill)
+                    ++fill;
+            }
 
-                if (first == mid)
-                    return;
+            for (size_type i = 0; i < fill; ++i) {
+                if (bins[i] != nullptr) {
+                    NodePtr newer = result;
+                    result = nullptr;
+                    mergeChains(bins[i], newer, cmp);
+                    result = bins[i];
+                    bins[i] = nullptr;
+                }
             }
+        } catch (...) {
+            // no node is lost, but their order is unspecified
+            result = appendChain(result, rest);
+            for (size_type i = 0; i < fill; ++i)
+                result = appendChain(bins[i], result);
+            this->getHead()->next = result;
+            throw;
         }
+
+        this->getHead()->next = result;
     }
 
 public:
@@ -735,7 +814,7 @@ public:
 
     template <typename Cmp>
     void sort(Cmp cmp) {
-        sortAux(before_begin(), end(), cmp, this->sizeAux());
+        sortAux(cmp);
     }
 
     void sort() {
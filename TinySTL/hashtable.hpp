@@ -403,22 +403,23 @@ private:
 
         for (auto cpos = cbegin(idx); cpos != cend(idx); ++cpos) {
             if (key_equ(get_key(val), get_key(*cpos))) { // existing
-                return make_pair(
+                return tiny_stl::make_pair(
                     iterator(idx, buckets[idx].makeIter(cpos), this), false);
             }
         }
 
-        // not exist
-        ++num_elements;
-        if (load_factor() > max_load_factor()) {
-            rehash(details::stlNextPrime(size()));
+        // not exist, grow before counting the new element
+        if (static_cast<float>(size() + 1) >
+            max_load_factor() * static_cast<float>(bucket_count())) {
+            rehash(details::stlNextPrime(size() + 1));
             idx = getNthBucket(val);
         }
+        ++num_elements;
 
         auto pos = buckets[idx].insert_after(buckets[idx].before_begin(),
                                              tiny_stl::forward<Value>(val));
 
-        return make_pair(iterator(idx, pos, this), true);
+        return tiny_stl::make_pair(iterator(idx, pos, this), true);
     }
 
 protected:
@@ -464,7 +465,7 @@ protected:
 
     size_type count_equal(const key_type& key) const {
         auto range = equal_range(key);
-        return distance(range.first, range.second);
+        return tiny_stl::distance(range.first, range.second);
     }
 
     size_type count_unique(const key_type& key) const {
@@ -507,7 +508,7 @@ public:
 
     size_type erase(const key_type& key) {
         auto range = static_cast<const Self*>(this)->equal_range(key);
-        size_type num = distance(range.first, range.second);
+        size_type num = tiny_stl::distance(range.first, range.second);
 
         erase(range.first, range.second);
 
@@ -536,7 +537,7 @@ public:
     const_iterator find(const key_type& key) const {
         size_type idx = getNthBucketK(key);
         for (auto pos = begin(idx); pos != end(idx); ++pos) {
-            if (key_equ(*pos, key))
+            if (key_equ(get_key(*pos), key))
                 return const_iterator(idx, pos, this);
         }
 
@@ -548,24 +549,24 @@ public:
 
         auto first = begin(idx);
         for (; first != end(idx); ++first) {
-            if (key_equ(*first, key)) // find first
+            if (key_equ(get_key(*first), key)) // find first
                 break;
         }
 
         if (first == end(idx))
-            return make_pair(end(), end());
+            return tiny_stl::make_pair(end(), end());
 
         auto last = first;
 
         for (++last; last != end(idx); ++last) {
-            if (!key_equ(*last, key)) // find last
+            if (!key_equ(get_key(*last), key)) // find last
                 break;
         }
 
         size_type lastIdx = updateNextIter(last, idx);
 
-        return make_pair(iterator(idx, first, this),
-                         iterator(lastIdx, last, this));
+        return tiny_stl::make_pair(iterator(idx, first, this),
+                                   iterator(lastIdx, last, this));
     }
 
     pair<const_iterator, const_iterator>
@@ -574,24 +575,24 @@ public:
 
         auto first = begin(idx);
         for (; first != end(idx); ++first) {
-            if (key_equ(*first, key)) // find first
+            if (key_equ(get_key(*first), key)) // find first
                 break;
         }
 
         if (first == end(idx))
-            return make_pair(end(), end());
+            return tiny_stl::make_pair(end(), end());
 
         auto last = first;
 
         for (++last; last != end(idx); ++last) {
-            if (!key_equ(*last, key)) // find last
+            if (!key_equ(get_key(*last), key)) // find last
                 break;
         }
 
         size_type lastIdx = updateNextIter(last, idx);
 
-        return make_pair(const_iterator(idx, first, this),
-                         const_iterator(lastIdx, last, this));
+        return tiny_stl::make_pair(const_iterator(idx, first, this),
+                                   const_iterator(lastIdx, last, this));
     }
 
 public:
@@ -657,13 +658,28 @@ public:
             maxfactor = mlf;
     }
 
+    // relink the existing nodes into the new buckets, nothing is copied
+    // or allocated except the bucket array
     void rehash(size_type n) {
         if (n <= size() / max_load_factor())
             return;
-        HashTable tmp(details::stlNextPrime(n));
-        for (const auto& val : *this)
-            tmp.insert_equal(val);
-        this->swap(tmp);
+
+        const size_type num_bucket = details::stlNextPrime(n);
+        Bucket newBuckets(buckets.get_allocator());
+        newBuckets.reserve(num_bucket);
+        newBuckets.assign(num_bucket, List{});
+
+        // equal keys are adjacent in the old bucket and stay adjacent
+        for (List& old : buckets) {
+            while (!old.empty()) {
+                List& dst = newBuckets[hashfunc(get_key(old.front())) %
+                                       num_bucket];
+                dst.splice_after(dst.cbefore_begin(), old,
+                                 old.cbefore_begin());
+            }
+        }
+
+        buckets.swap(newBuckets);
     }
 
     void reserve(size_type n) {
@@ -684,7 +700,7 @@ template <typename T, typename Hash, typename KeyEqual, typename Alloc,
 inline bool operator==(const HashTable<T, Hash, KeyEqual, Alloc, isMap>& lhs,
                        const HashTable<T, Hash, KeyEqual, Alloc, isMap>& rhs) {
     return lhs.size() == rhs.size() &&
-           equal(lhs.begin(), lhs.end(), rhs.begin());
+           tiny_stl::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
 template <typename T, typename Hash, typename KeyEqual, typename Alloc,
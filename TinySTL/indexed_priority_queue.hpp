@@ -0,0 +1,248 @@
+// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include "algorithm.hpp"
+#include "vector.hpp"
+
+namespace tiny_stl {
+
+// Priority queue whose elements can be changed or removed while queued.
+// push returns a handle that identifies the element until it's popped or
+// erased, after which the handle may be given to a new element.
+//
+// The elements are {value, handle} pairs in a d-ary heap built with the
+// same helpers as priority_queue, and pos[handle] follows the index of
+// every element as the helpers move it. update, decrease_key and erase
+// find the element in O(1) and restore the heap in O(log n).
+template <typename T, typename Compare = tiny_stl::less<T>,
+          std::size_t Arity = 4, typename Alloc = allocator<T>>
+class indexed_priority_queue {
+public:
+    static_assert(Arity >= 2, "a heap node needs at least two children");
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using handle_type = std::size_t;
+    using value_compare = Compare;
+    using allocator_type = Alloc;
+    using reference = T&;
+    using const_reference = const T&;
+
+private:
+    struct Entry {
+        T value;
+        handle_type handle;
+    };
+
+    using AlTraits = allocator_traits<Alloc>;
+    using AlEntry = typename AlTraits::template rebind_alloc<Entry>;
+    using AlSize = typename AlTraits::template rebind_alloc<size_type>;
+    using Iter = typename vector<Entry, AlEntry>::iterator;
+    using Diff = std::ptrdiff_t;
+
+    constexpr static const size_type kFree = static_cast<size_type>(-1);
+
+    struct EntryCompare {
+        const Compare& comp;
+
+        bool operator()(const Entry& lhs, const Entry& rhs) const {
+            return comp(lhs.value, rhs.value);
+        }
+    };
+
+    // records the new index of an element moved by the heap helpers
+    struct Track {
+        Entry* entries;
+        size_type* pos;
+
+        void operator()(Diff i) const noexcept {
+            pos[entries[i].handle] = static_cast<size_type>(i);
+        }
+    };
+
+private:
+    vector<Entry, AlEntry> heap;
+    vector<size_type, AlSize> pos; // heap index of a handle or kFree
+    vector<handle_type, AlSize> free_handles;
+    Compare comp;
+
+private:
+    Track track() noexcept {
+        return Track{heap.data(), pos.data()};
+    }
+
+    handle_type newHandle() {
+        if (!free_handles.empty()) {
+            const handle_type h = free_handles.back();
+            free_handles.pop_back();
+            return h;
+        }
+
+        pos.push_back(kFree);
+        // releaseHandle must not throw
+        free_handles.reserve(pos.capacity());
+        return pos.size() - 1;
+    }
+
+    void releaseHandle(handle_type h) noexcept {
+        pos[h] = kFree;
+        free_handles.push_back(h);
+    }
+
+    void siftUp(Diff hole, Entry&& e) {
+        EntryCompare cmp{comp};
+        details::siftUpDHeap<Arity>(heap.begin(), hole, Diff(0),
+                                    tiny_stl::move(e), cmp, track());
+    }
+
+    // put e into the hole at index i, wherever it belongs
+    void place(Diff hole, Entry&& e) {
+        EntryCompare cmp{comp};
+        const Diff parent = (hole - 1) / static_cast<Diff>(Arity);
+        if (hole > 0 && cmp(heap[parent], e))
+            siftUp(hole, tiny_stl::move(e));
+        else
+            details::adjustDHeap<Arity>(heap.begin(), hole,
+                                        static_cast<Diff>(heap.size()),
+                                        tiny_stl::move(e), cmp, track());
+    }
+
+    template <typename... Args>
+    handle_type emplaceAux(Args&&... args) {
+        const handle_type h = newHandle();
+        try {
+            heap.push_back(Entry{T(tiny_stl::forward<Args>(args)...), h});
+        } catch (...) {
+            releaseHandle(h);
+            throw;
+        }
+
+        Entry e = tiny_stl::move(heap.back());
+        siftUp(static_cast<Diff>(heap.size() - 1), tiny_stl::move(e));
+        return h;
+    }
+
+public:
+    explicit indexed_priority_queue(const Compare& cmp = Compare(),
+                                    const Alloc& alloc = Alloc())
+        : heap(AlEntry(alloc)), pos(AlSize(alloc)),
+          free_handles(AlSize(alloc)), comp(cmp) {
+    }
+
+public:
+    bool empty() const noexcept {
+        return heap.empty();
+    }
+
+    size_type size() const noexcept {
+        return heap.size();
+    }
+
+    // reserve room for n elements, so handles up to n don't allocate
+    void reserve(size_type n) {
+        heap.reserve(n);
+        pos.reserve(n);
+        free_handles.reserve(pos.capacity());
+    }
+
+    // whether h refers to a queued element
+    bool contains(handle_type h) const noexcept {
+        return h < pos.size() && pos[h] != kFree;
+    }
+
+    const_reference top() const {
+        return heap.front().value;
+    }
+
+    handle_type top_handle() const {
+        return heap.front().handle;
+    }
+
+    const_reference value(handle_type h) const {
+        assert(contains(h));
+        return heap[pos[h]].value;
+    }
+
+public:
+    handle_type push(const T& val) {
+        return emplaceAux(val);
+    }
+
+    handle_type push(T&& val) {
+        return emplaceAux(tiny_stl::move(val));
+    }
+
+    template <typename... Args>
+    handle_type emplace(Args&&... args) {
+        return emplaceAux(tiny_stl::forward<Args>(args)...);
+    }
+
+    void pop() {
+        erase(heap.front().handle);
+    }
+
+    void erase(handle_type h) {
+        assert(contains(h));
+        const Diff i = static_cast<Diff>(pos[h]);
+        releaseHandle(h);
+
+        Entry last = tiny_stl::move(heap.back());
+        heap.pop_back();
+        if (i != static_cast<Diff>(heap.size()))
+            place(i, tiny_stl::move(last));
+    }
+
+    // replace the value of h, it may move either way
+    void update(handle_type h, const T& val) {
+        assert(contains(h));
+        place(static_cast<Diff>(pos[h]), Entry{val, h});
+    }
+
+    void update(handle_type h, T&& val) {
+        assert(contains(h));
+        place(static_cast<Diff>(pos[h]), Entry{tiny_stl::move(val), h});
+    }
+
+    // replace the value of h with one that doesn't compare less, i.e. a
+    // smaller key in a min-queue (Compare = greater), it can only move up
+    void decrease_key(handle_type h, const T& val) {
+        assert(contains(h) && !comp(val, value(h)));
+        siftUp(static_cast<Diff>(pos[h]), Entry{val, h});
+    }
+
+    void decrease_key(handle_type h, T&& val) {
+        assert(contains(h) && !comp(val, value(h)));
+        siftUp(static_cast<Diff>(pos[h]), Entry{tiny_stl::move(val), h});
+    }
+
+    void clear() noexcept {
+        heap.clear();
+        pos.clear();
+        free_handles.clear();
+    }
+
+    void swap(indexed_priority_queue& rhs) noexcept(
+        is_nothrow_swappable<Compare>::value) {
+        heap.swap(rhs.heap);
+        pos.swap(rhs.pos);
+        free_handles.swap(rhs.free_handles);
+        swapADL(comp, rhs.comp);
+    }
+}; // class indexed_priority_queue<T, Compare, Arity, Alloc>
+
+template <typename T, typename Compare, std::size_t Arity, typename Alloc>
+constexpr const typename indexed_priority_queue<T, Compare, Arity,
+                                                Alloc>::size_type
+    indexed_priority_queue<T, Compare, Arity, Alloc>::kFree;
+
+template <typename T, typename Compare, std::size_t Arity, typename Alloc>
+void swap(indexed_priority_queue<T, Compare, Arity, Alloc>& lhs,
+          indexed_priority_queue<T, Compare, Arity, Alloc>&
+              rhs) noexcept(noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
+} // namespace tiny_stl
@@ -111,6 +111,47 @@ struct is_iterator<T, void_t<typename iterator_traits<T>::iterator_category>>
 template <typename T>
 constexpr bool is_iterator_v = is_iterator<T>::value;
 
+// Iterators walking a chain of contiguous blocks (deque) specialize this, so
+// algorithms can run a plain pointer loop over each block:
+//   segment(it)           the block it points into
+//   local(it)             its position inside that block
+//   begin(seg), end(seg)  local range of a whole block
+//   compose(seg, local)   back to an iterator, end(seg) means next block
+template <typename Iter>
+struct SegmentedIteratorTraits {
+    using is_segmented_iterator = false_type;
+};
+
+template <typename Iter>
+using IsSegmentedIterator =
+    typename SegmentedIteratorTraits<Iter>::is_segmented_iterator;
+
+// Iterators over a single array (vector, string) specialize this, so
+// algorithms can hand the range to a pointer kernel and map the result back:
+//   toPointer(it)       address of the element it refers to, end() included
+//   fromPointer(it, p)  iterator of the same range as it, referring to p
+template <typename Iter>
+struct ContiguousIteratorTraits {
+    using is_contiguous_iterator = false_type;
+};
+
+template <typename T>
+struct ContiguousIteratorTraits<T*> {
+    using is_contiguous_iterator = true_type;
+
+    static T* toPointer(T* iter) {
+        return iter;
+    }
+
+    static T* fromPointer(T*, T* p) {
+        return p;
+    }
+};
+
+template <typename Iter>
+using IsContiguousIterator =
+    typename ContiguousIteratorTraits<Iter>::is_contiguous_iterator;
+
 namespace details {
 
 template <typename Iter>
@@ -197,7 +238,7 @@ public:
     constexpr pointer operator->() const {
         Iter tmp = current;
         --tmp;
-        return (operator_arrow(tmp, is_pointer<Iter>()));
+        return (details::operator_arrow(tmp, is_pointer<Iter>()));
     }
 
     constexpr Self& operator++() {
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <climits>
 #include <initializer_list>
 
 #include "memory.hpp"
@@ -810,26 +811,54 @@ public:
         splice(pos, rhs, first, last);
     }
 
-    void remove(const T& val) {
-        for (iterator first = begin(); first != end();) {
-            if (*first == val) // remove element
-                first = erase(first);
-            else // ++iterator
-                ++first;
+private:
+    // Unlink the matching nodes first and free them after the pass, so `val`
+    // of remove(val) may refer to an element of this list.
+    template <typename UnaryPred>
+    void removeIfAux(UnaryPred& pred) {
+        const NodePtr head = this->head;
+        NodePtr removed = nullptr; // singly linked by next
+
+        try {
+            for (NodePtr p = head->next; p != head;) {
+                const NodePtr next = p->next;
+                if (pred(p->data)) {
+                    p->prev->next = next;
+                    next->prev = p->prev;
+                    p->next = removed;
+                    removed = p;
+                    --Base::count;
+                }
+                p = next;
+            }
+        } catch (...) {
+            freeChain(removed);
+            throw;
         }
+
+        freeChain(removed);
+    }
+
+    void freeChain(NodePtr p) noexcept {
+        while (p != nullptr) {
+            const NodePtr next = p->next;
+            destroyAndFree(p);
+            p = next;
+        }
+    }
+
+public:
+    void remove(const T& val) {
+        auto pred = [&val](const T& elem) { return elem == val; };
+        removeIfAux(pred);
     }
 
     template <typename UnaryPred>
     void remove_if(UnaryPred pred) {
-        for (iterator first = begin(); first != end();) {
-            if (pred(*first)) // remove element
-                first = erase(first);
-            else // ++iterator
-                ++first;
-        }
+        removeIfAux(pred);
     }
 
-    void reserve() noexcept {
+    void reverse() noexcept {
         const NodePtr head = this->head;
         NodePtr p = head;
 
@@ -844,6 +873,11 @@ public:
         }
     }
 
+    // misspelled reverse(), kept for existing callers
+    void reserve() noexcept {
+        reverse();
+    }
+
     // Removes all *consecutive duplicate* elements from the container.
     void unique() {
         unique(tiny_stl::equal_to<>{});
@@ -865,40 +899,150 @@ public:
     }
 
 private:
+    // A run is a sorted null-terminated chain whose prev links are valid,
+    // except that the prev of its first node points to its last node.
+
+    // Merge the run src into the run dst. Stable, nodes of dst go before
+    // equal nodes of src. Links are only rewritten where the merged order
+    // switches between the two runs. If cmp throws, dst still owns every node
+    // of both runs, but only their next links are valid.
     template <typename Cmp>
-    iterator sortAux(iterator first, iterator last, Cmp& cmp, size_type size) {
-        if (size < 2)
-            return first;
-
-        size_type mid_size = size >> 1;
-
-        iterator mid = first;
-        tiny_stl::advance(mid, mid_size);
-
-        first = sortAux(first, mid, cmp, mid_size);
-        mid = sortAux(mid, last, cmp, size - mid_size);
-        iterator ret = first; // return iter of min *iter
-
-        bool is_once = true;
-
-        while (true) {
-            if (cmp(*mid, *first)) { // *mid < *first
-                if (is_once)
-                    ret = mid;
-                iterator next = mid;
-                ++next;
-                this->transfer(first, mid, next);
-                mid = next;
-                if (mid == last)
-                    return ret;
-            } else { // *mid >= *first
-                ++first;
-                if (first == mid)
-                    return ret;
+    static void mergeRuns(NodePtr& dst, NodePtr src, Cmp& cmp) {
+        if (src == nullptr)
+            return;
+        if (dst == nullptr) {
+            dst = src;
+            return;
+        }
+
+        NodePtr first = dst;
+        const NodePtr firstLast = first->prev;
+        const NodePtr srcLast = src->prev;
+        NodePtr tail = nullptr; // last node of the merged part
+        bool fromSrc = false;   // the run being consumed, still linked to tail
+
+        try {
+            fromSrc = cmp(src->data, first->data);
+            if (fromSrc)
+                dst = src;
+
+            for (;;) {
+                if (fromSrc) {
+                    do {
+                        tail = src;
+                        src = src->next;
+                    } while (src != nullptr && cmp(src->data, first->data));
+
+                    tail->next = first;
+                    first->prev = tail;
+                    if (src == nullptr) {
+                        dst->prev = firstLast;
+                        return;
+                    }
+                } else {
+                    do {
+                        tail = first;
+                        first = first->next;
+                    } while (first != nullptr && !cmp(src->data, first->data));
+
+                    tail->next = src;
+                    src->prev = tail;
+                    if (first == nullptr) {
+                        dst->prev = srcLast;
+                        return;
+                    }
+                }
+
+                fromSrc = !fromSrc;
+            }
+        } catch (...) {
+            dst = appendChain(dst, fromSrc ? first : src);
+            throw;
+        }
+    }
+
+    static NodePtr appendChain(NodePtr first, NodePtr second) noexcept {
+        if (first == nullptr)
+            return second;
+
+        NodePtr p = first;
+        while (p->next != nullptr)
+            p = p->next;
+        p->next = second;
+
+        return first;
+    }
+
+    // link a null-terminated chain back into the cycle, fixing prev pointers
+    void relinkChain(NodePtr first) noexcept {
+        NodePtr prev = this->head;
+
+        for (; first != nullptr; prev = first, first = first->next) {
+            prev->next = first;
+            first->prev = prev;
+        }
+
+        prev->next = this->head;
+        this->head->prev = prev;
+    }
+
+    // Bottom-up merge sort without recursion or allocation. bins[i] holds a
+    // run of 2^i nodes (or is empty), every new node is carried up through
+    // the occupied bins like a binary counter.
+    template <typename Cmp>
+    void sortAux(Cmp& cmp) {
+        if (Base::count < 2)
+            return;
+
+        const NodePtr head = this->head;
+        head->prev->next = nullptr;
+        NodePtr rest = head->next;
+        NodePtr result = nullptr;
+        NodePtr bins[sizeof(size_type) * CHAR_BIT] = {};
+        size_type fill = 0; // bins in use are [0, fill)
+
+        try {
+            while (rest != nullptr) {
+                NodePtr carry = rest;
+                rest = rest->next;
+                carry->next = nullptr;
+                carry->prev = carry;
+
+                size_type i = 0;
+                for (; bins[i] != nullptr; ++i) {
+                    mergeRuns(bins[i], carry, cmp); // bins[i] is older
+                    carry = bins[i];
+                    bins[i] = nullptr;
+                }
+
+                bins[i] = carry;
+                if (i == fill)
+                    ++fill;
             }
 
-            is_once = false;
+            for (size_type i = 0; i < fill; ++i) {
+                if (bins[i] != nullptr) {
+                    NodePtr newer = result;
+                    result = nullptr;
+                    mergeRuns(bins[i], newer, cmp);
+                    result = bins[i];
+                    bins[i] = nullptr;
+                }
+            }
+        } catch (...) {
+            // no node is lost, but their order is unspecified
+            result = appendChain(result, rest);
+            for (size_type i = 0; i < fill; ++i)
+                result = appendChain(bins[i], result);
+            relinkChain(result);
+            throw;
         }
+
+        const NodePtr last = result->prev;
+        head->next = result;
+        result->prev = head;
+        last->next = head;
+        head->prev = last;
     }
 
 public:
@@ -908,7 +1052,7 @@ public:
 
     template <typename Cmp>
     void sort(Cmp cmp) {
-        sortAux(begin(), end(), cmp, Base::count);
+        sortAux(cmp);
     }
 
 private:
@@ -134,7 +134,7 @@ public:
     T& operator[](const Key& key) {
         iterator pos = this->find(key);
         if (pos == this->end())
-            return this->insert(make_pair(key, T{})).first->second;
+            return this->insert(tiny_stl::make_pair(key, T{})).first->second;
 
         return pos->second;
     }
@@ -142,7 +142,7 @@ public:
     T& operator[](Key&& key) {
         iterator pos = this->find(key);
         if (pos == this->end())
-            return this->insert(make_pair(tiny_stl::move(key), T{}))
+            return this->insert(tiny_stl::make_pair(tiny_stl::move(key), T{}))
                 .first->second;
 
         return pos->second;
@@ -43,11 +43,8 @@ inline FwdIt uninitializedCopyAux(InIt first, InIt last, FwdIt dst,
 
 template <typename InIt, typename FwdIt>
 inline FwdIt uninitializedCopyAux(InIt first, InIt last, FwdIt dst,
-                                  true_type /* is pod -- assign */) {
-    for (; first != last; ++first, ++dst)
-        *dst = *first;
-
-    return dst;
+                                  true_type /* is pod -- copy */) {
+    return tiny_stl::copy(first, last, dst);
 }
 
 template <typename InIt, typename Size, typename FwdIt>
@@ -78,9 +75,8 @@ inline void uninitializedFillAux(FwdIt first, FwdIt last, const T& x,
 
 template <typename FwdIt, typename T>
 inline void uninitializedFillAux(FwdIt first, FwdIt last, const T& x,
-                                 true_type /* is pod -- assign */) {
-    for (; first != last; ++first)
-        *first = x;
+                                 true_type /* is pod -- fill */) {
+    tiny_stl::fill(first, last, x);
 }
 
 template <typename FwdIt, typename Size, typename T>
@@ -98,15 +94,60 @@ inline void uninitializedFillNAux(FwdIt first, Size n, const T& x,
         *first = x;
 }
 
-} // namespace
-
 template <typename InIter, typename FwdIter>
-inline FwdIter uninitialized_copy(InIter first, InIter last, FwdIter dst) {
+inline FwdIter uninitializedCopyDispatch(InIter first, InIter last,
+                                         FwdIter dst, false_type, false_type) {
     using T = typename iterator_traits<InIter>::value_type;
     return uninitializedCopyAux(first, last, dst,
                                 bool_constant<is_pod<T>::value>{});
 }
 
+template <typename InIter, typename FwdIter>
+inline FwdIter uninitializedCopyDispatch(InIter first, InIter last,
+                                         FwdIter dst, false_type, true_type) {
+    return details::segmentedOutput(
+        first, last, dst, [](auto f, auto l, auto d) {
+            return uninitializedCopyDispatch(f, l, d, false_type{},
+                                             false_type{});
+        });
+}
+
+// a block of a segmented range at a time, see SegmentedIteratorTraits
+template <typename InIter, typename FwdIter, typename AnyTag>
+inline FwdIter uninitializedCopyDispatch(InIter first, InIter last,
+                                         FwdIter dst, true_type, AnyTag) {
+    details::forEachSegment(first, last, [&dst](auto lfirst, auto llast) {
+        dst = uninitializedCopyDispatch(
+            lfirst, llast, dst, false_type{},
+            details::SegmentedOutputTag<decltype(lfirst), FwdIter>{});
+    });
+    return dst;
+}
+
+template <typename FwdIt, typename T>
+inline void uninitializedFillDispatch(FwdIt first, FwdIt last, const T& x,
+                                      false_type) {
+    uninitializedFillAux(first, last, x,
+                         integral_constant<bool, is_pod_v<T>>{});
+}
+
+template <typename FwdIt, typename T>
+inline void uninitializedFillDispatch(FwdIt first, FwdIt last, const T& x,
+                                      true_type /* segmented */) {
+    details::forEachSegment(first, last, [&x](auto lfirst, auto llast) {
+        uninitializedFillDispatch(lfirst, llast, x, false_type{});
+    });
+}
+
+} // namespace
+
+template <typename InIter, typename FwdIter>
+inline FwdIter uninitialized_copy(InIter first, InIter last, FwdIter dst) {
+    return uninitializedCopyDispatch(
+        first, last, dst, IsSegmentedIterator<InIter>{},
+        details::SegmentedOutputTag<InIter, FwdIter>{});
+}
+
 // const char* and const wchar_t* version
 inline char* uninitialized_copy(const char* first, const char* last,
                                 char* dst) {
@@ -141,8 +182,7 @@ inline wchar_t* uninitialized_copy_n(const wchar_t* first, std::size_t n,
 // use x to construct [first, last)
 template <typename FwdIter, typename T>
 inline void uninitialized_fill(FwdIter first, FwdIter last, const T& x) {
-    uninitializedFillAux(first, last, x,
-                         integral_constant<bool, is_pod_v<T>>{});
+    uninitializedFillDispatch(first, last, x, IsSegmentedIterator<FwdIter>{});
 }
 
 // use x to construct [first, first + n)
@@ -290,7 +330,9 @@ inline FwdIter uninitAllocDefaultNAux(FwdIter first, Size n, Alloc&,
 template <typename FwdIter, typename Size, typename Alloc>
 inline FwdIter uninitAllocDefaultNAux(FwdIter first, Size n, Alloc& alloc,
                                       false_type) {
-    alloc.construct(tiny_stl::addressof(*first));
+    for (; n > 0; --n, ++first)
+        alloc.construct(tiny_stl::addressof(*first));
+
     return first;
 }
 
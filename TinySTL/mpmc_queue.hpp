@@ -0,0 +1,318 @@
+// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <atomic>
+#include <climits>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "memory.hpp"
+
+namespace tiny_stl {
+
+namespace details {
+
+static_assert(sizeof(std::atomic<unsigned>) == sizeof(unsigned),
+              "futex needs a plain 32-bit word");
+
+// block while word == old, spurious wake-ups are allowed
+inline void futexWait(std::atomic<unsigned>& word, unsigned old) noexcept {
+#if defined(__linux__)
+    ::syscall(SYS_futex, reinterpret_cast<unsigned*>(&word),
+              FUTEX_WAIT_PRIVATE, old, nullptr, nullptr, 0);
+#else
+    if (word.load(std::memory_order_relaxed) == old)
+        std::this_thread::yield();
+#endif
+}
+
+inline void futexWakeAll(std::atomic<unsigned>& word) noexcept {
+#if defined(__linux__)
+    ::syscall(SYS_futex, reinterpret_cast<unsigned*>(&word),
+              FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+    (void)word;
+#endif
+}
+
+} // namespace details
+
+// Bounded multi-producer/multi-consumer queue (D. Vyukov's design).
+// Every slot carries a sequence number telling whose turn it is: a
+// producer may fill slot `pos & mask` when seq == pos, a consumer may
+// empty it when seq == pos + 1, after which seq becomes pos + capacity.
+// A push or pop claims its position with one CAS and never waits for
+// another thread, except that a slot claimed but not yet filled (emptied)
+// delays the consumer (producer) of that very slot.
+//
+// try_* never block. push/pop spin for a while and then sleep on a futex
+// (Linux, yield elsewhere) until the other side makes progress.
+//
+// A claimed slot has to be completed, so moving an element must not
+// throw. If constructing T from the arguments may throw, it is built
+// outside the queue first and then moved in.
+template <typename T, typename Alloc = allocator<T>>
+class mpmc_queue {
+public:
+    static_assert(is_same<T, typename Alloc::value_type>::value,
+                  "Allocator::value_type is not the same as T");
+    static_assert(is_nothrow_move_constructible<T>::value &&
+                      is_nothrow_move_assignable<T>::value,
+                  "mpmc_queue requires T to move without throwing");
+
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using reference = T&;
+    using const_reference = const T&;
+
+private:
+    struct Slot {
+        std::atomic<size_type> seq;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* elem() noexcept {
+            return reinterpret_cast<T*>(storage);
+        }
+    };
+
+    using AlSlot =
+        typename allocator_traits<Alloc>::template rebind_alloc<Slot>;
+
+    constexpr static const int kSpinCount = 128;
+
+private:
+    // read-only after construction
+    Slot* slots;
+    size_type mask;
+    Alloc alloc;
+    AlSlot alloc_slot;
+
+    alignas(TINY_STL_CACHE_LINE_SIZE) std::atomic<size_type> enqueue_pos;
+    alignas(TINY_STL_CACHE_LINE_SIZE) std::atomic<size_type> dequeue_pos;
+
+    // bumped after a push (pop) when a consumer (producer) may sleep
+    alignas(TINY_STL_CACHE_LINE_SIZE) std::atomic<unsigned> not_empty;
+    std::atomic<bool> consumers_waiting;
+    alignas(TINY_STL_CACHE_LINE_SIZE) std::atomic<unsigned> not_full;
+    std::atomic<bool> producers_waiting;
+
+private:
+    static size_type roundUpCapacity(size_type n) {
+        size_type cap = 2; // with one slot "full" and "empty" look the same
+        while (cap < n)
+            cap <<= 1;
+        return cap;
+    }
+
+    // The flag is cleared by the first notifier, which wakes everybody
+    // sleeping on the event, so a burst of pushes (pops) makes one system
+    // call instead of one per element while the sleeper isn't running yet.
+    static void notify(std::atomic<unsigned>& event,
+                       std::atomic<bool>& waiting) noexcept {
+        // pairs with the fence in waitFor, either the waiter sees our
+        // slot or we see the flag
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting.load(std::memory_order_relaxed) &&
+            waiting.exchange(false, std::memory_order_relaxed)) {
+            event.fetch_add(1, std::memory_order_release);
+            details::futexWakeAll(event);
+        }
+    }
+
+    template <typename TryOp>
+    static void waitFor(TryOp op, std::atomic<unsigned>& event,
+                        std::atomic<bool>& waiting) {
+        for (int i = 0; i < kSpinCount; ++i) {
+            if (op())
+                return;
+            TINY_STL_CPU_RELAX();
+        }
+
+        for (;;) {
+            const unsigned old = event.load(std::memory_order_acquire);
+            waiting.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (op())
+                return;
+
+            details::futexWait(event, old);
+        }
+    }
+
+    // claim a slot to fill, nullptr if the queue is full
+    Slot* claimPush(size_type& pos) noexcept {
+        pos = enqueue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot* s = slots + (pos & mask);
+            const size_type seq = s->seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed))
+                    return s;
+            } else if (diff < 0) {
+                return nullptr;
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // claim a slot to empty, nullptr if the queue is empty
+    Slot* claimPop(size_type& pos) noexcept {
+        pos = dequeue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot* s = slots + (pos & mask);
+            const size_type seq = s->seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed))
+                    return s;
+            } else if (diff < 0) {
+                return nullptr;
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    template <typename... Args>
+    bool tryEmplace(true_type /* nothrow */, Args&&... args) {
+        size_type pos;
+        Slot* s = claimPush(pos);
+        if (s == nullptr)
+            return false;
+
+        alloc.construct(s->elem(), tiny_stl::forward<Args>(args)...);
+        s->seq.store(pos + 1, std::memory_order_release);
+        notify(not_empty, consumers_waiting);
+        return true;
+    }
+
+    template <typename... Args>
+    bool tryEmplace(false_type, Args&&... args) {
+        T tmp(tiny_stl::forward<Args>(args)...);
+        return tryEmplace(true_type{}, tiny_stl::move(tmp));
+    }
+
+    template <typename... Args>
+    void emplaceAux(true_type, Args&&... args) {
+        // the arguments are consumed only by the attempt that succeeds
+        waitFor(
+            [&] {
+                return tryEmplace(true_type{},
+                                  tiny_stl::forward<Args>(args)...);
+            },
+            not_full, producers_waiting);
+    }
+
+    template <typename... Args>
+    void emplaceAux(false_type, Args&&... args) {
+        T tmp(tiny_stl::forward<Args>(args)...);
+        emplaceAux(true_type{}, tiny_stl::move(tmp));
+    }
+
+public:
+    // the capacity is rounded up to a power of two, at least 2
+    explicit mpmc_queue(size_type cap, const Alloc& a = Alloc())
+        : slots(nullptr), mask(roundUpCapacity(cap) - 1), alloc(a),
+          alloc_slot(), enqueue_pos(0), dequeue_pos(0), not_empty(0),
+          consumers_waiting(false), not_full(0), producers_waiting(false) {
+        slots = alloc_slot.allocate(mask + 1);
+        for (size_type i = 0; i <= mask; ++i)
+            ::new (static_cast<void*>(&slots[i].seq))
+                std::atomic<size_type>(i);
+    }
+
+    mpmc_queue(const mpmc_queue&) = delete;
+    mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+    ~mpmc_queue() {
+        const size_type last = enqueue_pos.load(std::memory_order_relaxed);
+        for (size_type pos = dequeue_pos.load(std::memory_order_relaxed);
+             pos != last; ++pos)
+            alloc.destroy(slots[pos & mask].elem());
+        alloc_slot.deallocate(slots, mask + 1);
+    }
+
+public:
+    size_type capacity() const noexcept {
+        return mask + 1;
+    }
+
+    // only a snapshot while other threads are running
+    size_type size() const noexcept {
+        const size_type head = dequeue_pos.load(std::memory_order_acquire);
+        const size_type tail = enqueue_pos.load(std::memory_order_acquire);
+        return tiny_stl::min(tail - head, capacity());
+    }
+
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    allocator_type get_allocator() const {
+        return alloc;
+    }
+
+public:
+    template <typename... Args>
+    bool try_emplace(Args&&... args) {
+        return tryEmplace(is_nothrow_constructible<T, Args...>{},
+                          tiny_stl::forward<Args>(args)...);
+    }
+
+    bool try_push(const T& val) {
+        return try_emplace(val);
+    }
+
+    bool try_push(T&& val) {
+        return try_emplace(tiny_stl::move(val));
+    }
+
+    bool try_pop(T& val) noexcept {
+        size_type pos;
+        Slot* s = claimPop(pos);
+        if (s == nullptr)
+            return false;
+
+        T* p = s->elem();
+        val = tiny_stl::move(*p);
+        alloc.destroy(p);
+        s->seq.store(pos + mask + 1, std::memory_order_release);
+        notify(not_full, producers_waiting);
+        return true;
+    }
+
+    // block while the queue is full
+    template <typename... Args>
+    void emplace(Args&&... args) {
+        emplaceAux(is_nothrow_constructible<T, Args...>{},
+                   tiny_stl::forward<Args>(args)...);
+    }
+
+    void push(const T& val) {
+        emplace(val);
+    }
+
+    void push(T&& val) {
+        emplace(tiny_stl::move(val));
+    }
+
+    // block while the queue is empty
+    void pop(T& val) noexcept {
+        waitFor([&] { return try_pop(val); }, not_empty, consumers_waiting);
+    }
+}; // class mpmc_queue<T, Alloc>
+
+} // namespace tiny_stl
@@ -0,0 +1,725 @@
+// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <thread>
+
+#include "algorithm.hpp"
+#include "vector.hpp"
+
+// Number of threads of the parallel algorithms, 0 means
+// std::thread::hardware_concurrency().
+#ifndef TINY_STL_PARALLEL_THREADS
+#define TINY_STL_PARALLEL_THREADS 0
+#endif
+
+namespace tiny_stl {
+
+namespace execution {
+
+struct sequenced_policy {};
+struct parallel_policy {};
+
+constexpr sequenced_policy seq{};
+constexpr parallel_policy par{};
+
+} // namespace execution
+
+template <typename T>
+struct is_execution_policy : false_type {};
+
+template <>
+struct is_execution_policy<execution::sequenced_policy> : true_type {};
+
+template <>
+struct is_execution_policy<execution::parallel_policy> : true_type {};
+
+template <typename ExecPolicy, typename R>
+using EnableIfExecPolicy =
+    enable_if_t<is_execution_policy<decay_t<ExecPolicy>>::value, R>;
+
+// accumulate and inner_product are left folds in the order of the range,
+// like the standard ones. reduce and transform_reduce may regroup and
+// reorder the operands, which is what lets them run several chains at
+// once.
+
+template <typename InIter, typename T>
+inline T accumulate(InIter first, InIter last, T init) {
+    for (; first != last; ++first)
+        init = tiny_stl::move(init) + *first;
+    return init;
+}
+
+template <typename InIter, typename T, typename BinOp>
+inline T accumulate(InIter first, InIter last, T init, BinOp op) {
+    for (; first != last; ++first)
+        init = op(tiny_stl::move(init), *first);
+    return init;
+}
+
+template <typename InIter1, typename InIter2, typename T>
+inline T inner_product(InIter1 first1, InIter1 last1, InIter2 first2,
+                       T init) {
+    for (; first1 != last1; ++first1, ++first2)
+        init = tiny_stl::move(init) + *first1 * *first2;
+    return init;
+}
+
+template <typename InIter1, typename InIter2, typename T, typename BinOp1,
+          typename BinOp2>
+inline T inner_product(InIter1 first1, InIter1 last1, InIter2 first2, T init,
+                       BinOp1 op1, BinOp2 op2) {
+    for (; first1 != last1; ++first1, ++first2)
+        init = op1(tiny_stl::move(init), op2(*first1, *first2));
+    return init;
+}
+
+namespace details {
+
+template <typename Iter>
+using IsRanIter =
+    is_convertible<typename iterator_traits<Iter>::iterator_category,
+                   random_access_iterator_tag>;
+
+// independent chains of reduce, 8 keep two SSE vectors of float or one
+// AVX vector busy, which a single chain can't because of the add latency
+constexpr std::ptrdiff_t REDUCE_LANES = 8;
+
+// op over init and load(0), ..., load(n - 1) in 8 chains, the chains
+// are seeded with the first 16 operands and combined pairwise
+template <typename T, typename Diff, typename BinOp, typename Load>
+inline T reduceLanes(T init, Diff n, BinOp& op, Load load) {
+    Diff i = 0;
+    if (n >= 2 * REDUCE_LANES) {
+        T a0 = op(load(0), load(8));
+        T a1 = op(load(1), load(9));
+        T a2 = op(load(2), load(10));
+        T a3 = op(load(3), load(11));
+        T a4 = op(load(4), load(12));
+        T a5 = op(load(5), load(13));
+        T a6 = op(load(6), load(14));
+        T a7 = op(load(7), load(15));
+        for (i = 2 * REDUCE_LANES; i + REDUCE_LANES <= n; i += REDUCE_LANES) {
+            a0 = op(a0, load(i));
+            a1 = op(a1, load(i + 1));
+            a2 = op(a2, load(i + 2));
+            a3 = op(a3, load(i + 3));
+            a4 = op(a4, load(i + 4));
+            a5 = op(a5, load(i + 5));
+            a6 = op(a6, load(i + 6));
+            a7 = op(a7, load(i + 7));
+        }
+        init = op(init, op(op(op(a0, a1), op(a2, a3)),
+                           op(op(a4, a5), op(a6, a7))));
+    }
+    for (; i < n; ++i)
+        init = op(init, load(i));
+    return init;
+}
+
+template <typename InIter, typename T, typename BinOp, typename Trans>
+inline T transformReduceAux(InIter first, InIter last, T init, BinOp& op,
+                            Trans& trans, false_type) {
+    for (; first != last; ++first)
+        init = op(tiny_stl::move(init), trans(*first));
+    return init;
+}
+
+template <typename RanIter, typename T, typename BinOp, typename Trans>
+inline T transformReduceAux(RanIter first, RanIter last, T init, BinOp& op,
+                            Trans& trans, true_type) {
+    return reduceLanes(init, last - first, op,
+                       [&](IterDiffType<RanIter> i) -> decltype(auto) {
+                           return trans(first[i]);
+                       });
+}
+
+template <typename InIter1, typename InIter2, typename T, typename BinOp1,
+          typename BinOp2>
+inline T transformReduceAux(InIter1 first1, InIter1 last1, InIter2 first2,
+                            T init, BinOp1& op1, BinOp2& op2, false_type) {
+    for (; first1 != last1; ++first1, ++first2)
+        init = op1(tiny_stl::move(init), op2(*first1, *first2));
+    return init;
+}
+
+template <typename RanIter1, typename RanIter2, typename T, typename BinOp1,
+          typename BinOp2>
+inline T transformReduceAux(RanIter1 first1, RanIter1 last1, RanIter2 first2,
+                            T init, BinOp1& op1, BinOp2& op2, true_type) {
+    return reduceLanes(init, last1 - first1, op1,
+                       [&](IterDiffType<RanIter1> i) -> decltype(auto) {
+                           return op2(first1[i], first2[i]);
+                       });
+}
+
+// the chains pay off for arithmetic sums, other types keep one
+template <typename Iter, typename T>
+using ReduceLanesTag =
+    typename conjunction<IsRanIter<Iter>, is_arithmetic<T>>::type;
+
+template <typename Iter1, typename Iter2, typename T>
+using ReduceLanesTag2 =
+    typename conjunction<IsRanIter<Iter1>, IsRanIter<Iter2>,
+                         is_arithmetic<T>>::type;
+
+struct IdentityTransform {
+    template <typename T>
+    T&& operator()(T&& val) const noexcept {
+        return tiny_stl::forward<T>(val);
+    }
+};
+
+} // namespace details
+
+template <typename InIter, typename T, typename BinOp, typename UnaryOp>
+inline T transform_reduce(InIter first, InIter last, T init, BinOp op,
+                          UnaryOp trans) {
+    return details::transformReduceAux(first, last, init, op, trans,
+                                       details::ReduceLanesTag<InIter, T>{});
+}
+
+template <typename InIter1, typename InIter2, typename T, typename BinOp1,
+          typename BinOp2>
+inline T transform_reduce(InIter1 first1, InIter1 last1, InIter2 first2,
+                          T init, BinOp1 op1, BinOp2 op2) {
+    return details::transformReduceAux(
+        first1, last1, first2, init, op1, op2,
+        details::ReduceLanesTag2<InIter1, InIter2, T>{});
+}
+
+template <typename InIter1, typename InIter2, typename T>
+inline T transform_reduce(InIter1 first1, InIter1 last1, InIter2 first2,
+                          T init) {
+    return tiny_stl::transform_reduce(first1, last1, first2, init,
+                                      tiny_stl::plus<>{},
+                                      tiny_stl::multiplies<>{});
+}
+
+template <typename InIter, typename T, typename BinOp>
+inline T reduce(InIter first, InIter last, T init, BinOp op) {
+    return tiny_stl::transform_reduce(first, last, init, op,
+                                      details::IdentityTransform{});
+}
+
+template <typename InIter, typename T>
+inline T reduce(InIter first, InIter last, T init) {
+    return tiny_stl::reduce(first, last, init, tiny_stl::plus<>{});
+}
+
+template <typename InIter>
+inline details::IteratorValueType<InIter> reduce(InIter first, InIter last) {
+    return tiny_stl::reduce(first, last, details::IteratorValueType<InIter>{});
+}
+
+namespace details {
+
+// Scans of arithmetic values in blocks of 4: the sums inside a block
+// don't depend on the carry, so the chain through the carry is one op
+// per block instead of one per element, and the blocks overlap. The
+// block is read before it's written, so dst may be first.
+template <typename RanIter, typename OutIter, typename T, typename BinOp>
+inline OutIter blockInclusiveScan(RanIter first, RanIter last, OutIter dst,
+                                  T& carry, BinOp& op) {
+    const IterDiffType<RanIter> n = last - first;
+    IterDiffType<RanIter> i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const T s0 = first[i];
+        const T s1 = op(s0, first[i + 1]);
+        const T s2 = op(s1, first[i + 2]);
+        const T s3 = op(s2, first[i + 3]);
+        *dst = op(carry, s0);
+        *++dst = op(carry, s1);
+        *++dst = op(carry, s2);
+        *++dst = op(carry, s3);
+        ++dst;
+        carry = op(carry, s3);
+    }
+    for (; i < n; ++i, ++dst) {
+        carry = op(carry, first[i]);
+        *dst = carry;
+    }
+    return dst;
+}
+
+template <typename RanIter, typename OutIter, typename T, typename BinOp>
+inline OutIter blockExclusiveScan(RanIter first, RanIter last, OutIter dst,
+                                  T& carry, BinOp& op) {
+    const IterDiffType<RanIter> n = last - first;
+    IterDiffType<RanIter> i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const T s0 = first[i];
+        const T s1 = op(s0, first[i + 1]);
+        const T s2 = op(s1, first[i + 2]);
+        const T s3 = op(s2, first[i + 3]);
+        *dst = carry;
+        *++dst = op(carry, s0);
+        *++dst = op(carry, s1);
+        *++dst = op(carry, s2);
+        ++dst;
+        carry = op(carry, s3);
+    }
+    for (; i < n; ++i, ++dst) {
+        T val = first[i];
+        *dst = carry;
+        carry = op(carry, val);
+    }
+    return dst;
+}
+
+template <typename InIter, typename OutIter, typename T, typename BinOp>
+inline OutIter inclusiveScanAux(InIter first, InIter last, OutIter dst,
+                                T& carry, BinOp& op, false_type) {
+    for (; first != last; ++first, ++dst) {
+        carry = op(carry, *first);
+        *dst = carry;
+    }
+    return dst;
+}
+
+template <typename RanIter, typename OutIter, typename T, typename BinOp>
+inline OutIter inclusiveScanAux(RanIter first, RanIter last, OutIter dst,
+                                T& carry, BinOp& op, true_type) {
+    return blockInclusiveScan(first, last, dst, carry, op);
+}
+
+template <typename InIter, typename OutIter, typename T, typename BinOp>
+inline OutIter exclusiveScanAux(InIter first, InIter last, OutIter dst,
+                                T& carry, BinOp& op, false_type) {
+    for (; first != last; ++first, ++dst) {
+        T val = op(carry, *first);
+        *dst = carry;
+        carry = tiny_stl::move(val);
+    }
+    return dst;
+}
+
+template <typename RanIter, typename OutIter, typename T, typename BinOp>
+inline OutIter exclusiveScanAux(RanIter first, RanIter last, OutIter dst,
+                                T& carry, BinOp& op, true_type) {
+    return blockExclusiveScan(first, last, dst, carry, op);
+}
+
+} // namespace details
+
+template <typename InIter, typename OutIter, typename BinOp, typename T>
+inline OutIter inclusive_scan(InIter first, InIter last, OutIter dst,
+                              BinOp op, T init) {
+    return details::inclusiveScanAux(first, last, dst, init, op,
+                                     details::ReduceLanesTag<InIter, T>{});
+}
+
+template <typename InIter, typename OutIter, typename BinOp>
+inline OutIter inclusive_scan(InIter first, InIter last, OutIter dst,
+                              BinOp op) {
+    if (first == last)
+        return dst;
+
+    details::IteratorValueType<InIter> init = *first;
+    *dst = init;
+    return tiny_stl::inclusive_scan(++first, last, ++dst, op,
+                                    tiny_stl::move(init));
+}
+
+template <typename InIter, typename OutIter>
+inline OutIter inclusive_scan(InIter first, InIter last, OutIter dst) {
+    return tiny_stl::inclusive_scan(first, last, dst, tiny_stl::plus<>{});
+}
+
+template <typename InIter, typename OutIter, typename T, typename BinOp>
+inline OutIter exclusive_scan(InIter first, InIter last, OutIter dst, T init,
+                              BinOp op) {
+    return details::exclusiveScanAux(first, last, dst, init, op,
+                                     details::ReduceLanesTag<InIter, T>{});
+}
+
+template <typename InIter, typename OutIter, typename T>
+inline OutIter exclusive_scan(InIter first, InIter last, OutIter dst,
+                              T init) {
+    return tiny_stl::exclusive_scan(first, last, dst, init,
+                                    tiny_stl::plus<>{});
+}
+
+namespace details {
+
+template <typename InIter, typename OutIter, typename BinOp>
+inline OutIter adjacentDifferenceAux(InIter first, InIter last, OutIter dst,
+                                     BinOp& op, false_type) {
+    if (first == last)
+        return dst;
+
+    IteratorValueType<InIter> prev = *first;
+    *dst = prev;
+    while (++first != last) {
+        IteratorValueType<InIter> val = *first;
+        *++dst = op(val, prev);
+        prev = tiny_stl::move(val);
+    }
+    return ++dst;
+}
+
+// Backward, each element is read before the one after it is written, so
+// dst may be first, and there is no chain through prev to keep the loop
+// from vectorizing.
+template <typename RanIter1, typename RanIter2, typename BinOp>
+inline RanIter2 adjacentDifferenceAux(RanIter1 first, RanIter1 last,
+                                      RanIter2 dst, BinOp& op, true_type) {
+    const IterDiffType<RanIter1> n = last - first;
+    for (IterDiffType<RanIter1> i = n - 1; i > 0; --i)
+        dst[i] = op(first[i], first[i - 1]);
+    if (n > 0)
+        dst[0] = first[0];
+    return dst + n;
+}
+
+} // namespace details
+
+template <typename InIter, typename OutIter, typename BinOp>
+inline OutIter adjacent_difference(InIter first, InIter last, OutIter dst,
+                                   BinOp op) {
+    using Tag = typename conjunction<
+        details::IsRanIter<InIter>, details::IsRanIter<OutIter>,
+        is_arithmetic<details::IteratorValueType<InIter>>>::type;
+    return details::adjacentDifferenceAux(first, last, dst, op, Tag{});
+}
+
+template <typename InIter, typename OutIter>
+inline OutIter adjacent_difference(InIter first, InIter last, OutIter dst) {
+    return tiny_stl::adjacent_difference(first, last, dst,
+                                         tiny_stl::minus<>{});
+}
+
+namespace details {
+
+// the smallest range a thread of its own is worth starting for
+constexpr std::ptrdiff_t PARALLEL_MIN_CHUNK = 1 << 16;
+
+inline std::size_t parallelThreads() {
+    // hardware_concurrency() asks the system every time
+    static const std::size_t threads =
+        TINY_STL_PARALLEL_THREADS != 0 ? TINY_STL_PARALLEL_THREADS
+                                       : std::thread::hardware_concurrency();
+    return threads;
+}
+
+inline std::size_t parallelChunks(std::ptrdiff_t n) {
+    if (n < 2 * PARALLEL_MIN_CHUNK)
+        return 1;
+    const std::size_t most = static_cast<std::size_t>(n / PARALLEL_MIN_CHUNK);
+    return tiny_stl::max<std::size_t>(1,
+                                      tiny_stl::min(parallelThreads(), most));
+}
+
+// [begin, end) of chunk i of n elements
+template <typename Diff>
+inline Diff chunkBegin(Diff n, std::size_t chunks, std::size_t i) {
+    return static_cast<Diff>(static_cast<std::size_t>(n) * i / chunks);
+}
+
+// f(i) for every i in [0, chunks), chunk 0 on the calling thread. An
+// exception in a worker ends the program, like in the standard parallel
+// algorithms.
+template <typename Func>
+inline void parallelFor(std::size_t chunks, Func f) {
+    vector<std::thread> workers;
+    workers.reserve(chunks - 1);
+    try {
+        for (std::size_t i = 1; i < chunks; ++i)
+            workers.emplace_back(f, i);
+    } catch (...) {
+        for (auto& worker : workers)
+            worker.join();
+        throw;
+    }
+    f(0);
+    for (auto& worker : workers)
+        worker.join();
+}
+
+// a wrapper, vector<bool> can't be written by several threads
+template <typename T>
+struct Partial {
+    T value;
+};
+
+template <typename T, typename Diff, typename BinOp, typename Load>
+inline T parallelReduce(T init, Diff n, BinOp& op, Load load) {
+    const std::size_t chunks = parallelChunks(n);
+    if (chunks == 1)
+        return reduceLanes(init, n, op, load);
+
+    // every chunk has at least two elements to seed its sum
+    vector<Partial<T>> partial(chunks, Partial<T>{init});
+    parallelFor(chunks, [&](std::size_t c) {
+        const Diff b = chunkBegin(n, chunks, c);
+        const Diff e = chunkBegin(n, chunks, c + 1);
+        partial[c].value =
+            reduceLanes(static_cast<T>(op(load(b), load(b + 1))), e - b - 2,
+                        op, [&](Diff i) -> decltype(auto) {
+                            return load(b + 2 + i);
+                        });
+    });
+    for (const auto& p : partial)
+        init = op(init, p.value);
+    return init;
+}
+
+template <typename RanIter, typename T, typename BinOp, typename Trans>
+inline T parallelTransformReduce(RanIter first, RanIter last, T init,
+                                 BinOp& op, Trans& trans, true_type) {
+    return parallelReduce(init, last - first, op,
+                          [&](IterDiffType<RanIter> i) -> decltype(auto) {
+                              return trans(first[i]);
+                          });
+}
+
+template <typename InIter, typename T, typename BinOp, typename Trans>
+inline T parallelTransformReduce(InIter first, InIter last, T init,
+                                 BinOp& op, Trans& trans, false_type) {
+    return tiny_stl::transform_reduce(first, last, init, op, trans);
+}
+
+template <typename RanIter1, typename RanIter2, typename T, typename BinOp1,
+          typename BinOp2>
+inline T parallelTransformReduce(RanIter1 first1, RanIter1 last1,
+                                 RanIter2 first2, T init, BinOp1& op1,
+                                 BinOp2& op2, true_type) {
+    return parallelReduce(init, last1 - first1, op1,
+                          [&](IterDiffType<RanIter1> i) -> decltype(auto) {
+                              return op2(first1[i], first2[i]);
+                          });
+}
+
+template <typename InIter1, typename InIter2, typename T, typename BinOp1,
+          typename BinOp2>
+inline T parallelTransformReduce(InIter1 first1, InIter1 last1,
+                                 InIter2 first2, T init, BinOp1& op1,
+                                 BinOp2& op2, false_type) {
+    return tiny_stl::transform_reduce(first1, last1, first2, init, op1, op2);
+}
+
+// The parallel scans write the scan of every chunk on its own, then add
+// the sum of the chunks before it to each element. The second pass has
+// no chain, but it reads dst back, so dst holds T.
+template <typename RanIter1, typename RanIter2, typename T>
+using ParallelScanTag = typename conjunction<
+    IsRanIter<RanIter1>, IsRanIter<RanIter2>, is_arithmetic<T>,
+    is_same<T, IteratorValueType<RanIter2>>>::type;
+
+template <typename RanIter1, typename RanIter2, typename BinOp, typename T>
+inline RanIter2 parallelInclusiveScan(RanIter1 first, RanIter1 last,
+                                      RanIter2 dst, BinOp& op, T init,
+                                      true_type) {
+    using Diff = IterDiffType<RanIter1>;
+    const Diff n = last - first;
+    const std::size_t chunks = parallelChunks(n);
+    if (chunks == 1)
+        return blockInclusiveScan(first, last, dst, init, op);
+
+    parallelFor(chunks, [&](std::size_t c) {
+        const Diff b = chunkBegin(n, chunks, c);
+        const Diff e = chunkBegin(n, chunks, c + 1);
+        if (c == 0) {
+            T carry = init;
+            blockInclusiveScan(first, first + e, dst, carry, op);
+        } else {
+            T carry = first[b];
+            dst[b] = carry;
+            blockInclusiveScan(first + b + 1, first + e, dst + b + 1, carry,
+                               op);
+        }
+    });
+
+    // the last sum of every chunk, then the sum before every chunk
+    vector<Partial<T>> carry(chunks, Partial<T>{init});
+    for (std::size_t c = 1; c < chunks; ++c) {
+        const Diff e = chunkBegin(n, chunks, c);
+        carry[c].value =
+            c == 1 ? dst[e - 1] : op(carry[c - 1].value, dst[e - 1]);
+    }
+    parallelFor(chunks, [&](std::size_t c) {
+        if (c == 0)
+            return;
+        const Diff b = chunkBegin(n, chunks, c);
+        const Diff e = chunkBegin(n, chunks, c + 1);
+        const T add = carry[c].value;
+        for (Diff i = b; i < e; ++i)
+            dst[i] = op(add, dst[i]);
+    });
+    return dst + n;
+}
+
+template <typename InIter, typename OutIter, typename BinOp, typename T>
+inline OutIter parallelInclusiveScan(InIter first, InIter last, OutIter dst,
+                                     BinOp& op, T init, false_type) {
+    return tiny_stl::inclusive_scan(first, last, dst, op, init);
+}
+
+template <typename RanIter1, typename RanIter2, typename T, typename BinOp>
+inline RanIter2 parallelExclusiveScan(RanIter1 first, RanIter1 last,
+                                      RanIter2 dst, T init, BinOp& op,
+                                      true_type) {
+    using Diff = IterDiffType<RanIter1>;
+    const Diff n = last - first;
+    const std::size_t chunks = parallelChunks(n);
+    if (chunks == 1)
+        return blockExclusiveScan(first, last, dst, init, op);
+
+    // dst[b] of every chunk but the first is left for the second pass, it
+    // still holds first[b] if dst is first
+    vector<Partial<T>> total(chunks, Partial<T>{init});
+    parallelFor(chunks, [&](std::size_t c) {
+        const Diff b = chunkBegin(n, chunks, c);
+        const Diff e = chunkBegin(n, chunks, c + 1);
+        T carry = init;
+        if (c == 0) {
+            blockExclusiveScan(first, first + e, dst, carry, op);
+        } else {
+            carry = first[b];
+            blockExclusiveScan(first + b + 1, first + e, dst + b + 1, carry,
+                               op);
+        }
+        total[c].value = carry;
+    });
+
+    for (std::size_t c = 1; c < chunks; ++c)
+        total[c].value = op(total[c - 1].value, total[c].value);
+    parallelFor(chunks, [&](std::size_t c) {
+        if (c == 0)
+            return;
+        const Diff b = chunkBegin(n, chunks, c);
+        const Diff e = chunkBegin(n, chunks, c + 1);
+        const T add = total[c - 1].value;
+        dst[b] = add;
+        for (Diff i = b + 1; i < e; ++i)
+            dst[i] = op(add, dst[i]);
+    });
+    return dst + n;
+}
+
+template <typename InIter, typename OutIter, typename T, typename BinOp>
+inline OutIter parallelExclusiveScan(InIter first, InIter last, OutIter dst,
+                                     T init, BinOp& op, false_type) {
+    return tiny_stl::exclusive_scan(first, last, dst, init, op);
+}
+
+} // namespace details
+
+// The parallel overloads split random access ranges of arithmetic values
+// into one chunk per thread, ranges shorter than two chunks of
+// PARALLEL_MIN_CHUNK elements and other ranges run on the calling thread.
+
+template <typename ExecPolicy, typename FwdIter, typename T, typename BinOp,
+          typename UnaryOp>
+inline EnableIfExecPolicy<ExecPolicy, T>
+transform_reduce(ExecPolicy&&, FwdIter first, FwdIter last, T init, BinOp op,
+                 UnaryOp trans) {
+    using Tag = typename conjunction<
+        is_same<decay_t<ExecPolicy>, execution::parallel_policy>,
+        details::ReduceLanesTag<FwdIter, T>>::type;
+    return details::parallelTransformReduce(first, last, init, op, trans,
+                                            Tag{});
+}
+
+template <typename ExecPolicy, typename FwdIter1, typename FwdIter2,
+          typename T, typename BinOp1, typename BinOp2>
+inline EnableIfExecPolicy<ExecPolicy, T>
+transform_reduce(ExecPolicy&&, FwdIter1 first1, FwdIter1 last1,
+                 FwdIter2 first2, T init, BinOp1 op1, BinOp2 op2) {
+    using Tag = typename conjunction<
+        is_same<decay_t<ExecPolicy>, execution::parallel_policy>,
+        details::ReduceLanesTag2<FwdIter1, FwdIter2, T>>::type;
+    return details::parallelTransformReduce(first1, last1, first2, init, op1,
+                                            op2, Tag{});
+}
+
+template <typename ExecPolicy, typename FwdIter1, typename FwdIter2,
+          typename T>
+inline EnableIfExecPolicy<ExecPolicy, T>
+transform_reduce(ExecPolicy&& policy, FwdIter1 first1, FwdIter1 last1,
+                 FwdIter2 first2, T init) {
+    return tiny_stl::transform_reduce(
+        tiny_stl::forward<ExecPolicy>(policy), first1, last1, first2, init,
+        tiny_stl::plus<>{}, tiny_stl::multiplies<>{});
+}
+
+template <typename ExecPolicy, typename FwdIter, typename T, typename BinOp>
+inline EnableIfExecPolicy<ExecPolicy, T>
+reduce(ExecPolicy&& policy, FwdIter first, FwdIter last, T init, BinOp op) {
+    return tiny_stl::transform_reduce(tiny_stl::forward<ExecPolicy>(policy),
+                                      first, last, init, op,
+                                      details::IdentityTransform{});
+}
+
+template <typename ExecPolicy, typename FwdIter, typename T>
+inline EnableIfExecPolicy<ExecPolicy, T>
+reduce(ExecPolicy&& policy, FwdIter first, FwdIter last, T init) {
+    return tiny_stl::reduce(tiny_stl::forward<ExecPolicy>(policy), first,
+                            last, init, tiny_stl::plus<>{});
+}
+
+template <typename ExecPolicy, typename FwdIter>
+inline EnableIfExecPolicy<ExecPolicy, details::IteratorValueType<FwdIter>>
+reduce(ExecPolicy&& policy, FwdIter first, FwdIter last) {
+    return tiny_stl::reduce(tiny_stl::forward<ExecPolicy>(policy), first,
+                            last, details::IteratorValueType<FwdIter>{});
+}
+
+template <typename ExecPolicy, typename FwdIter1, typename FwdIter2,
+          typename BinOp, typename T>
+inline EnableIfExecPolicy<ExecPolicy, FwdIter2>
+inclusive_scan(ExecPolicy&&, FwdIter1 first, FwdIter1 last, FwdIter2 dst,
+               BinOp op, T init) {
+    using Tag = typename conjunction<
+        is_same<decay_t<ExecPolicy>, execution::parallel_policy>,
+        details::ParallelScanTag<FwdIter1, FwdIter2, T>>::type;
+    return details::parallelInclusiveScan(first, last, dst, op, init, Tag{});
+}
+
+template <typename ExecPolicy, typename FwdIter1, typename FwdIter2,
+          typename BinOp>
+inline EnableIfExecPolicy<ExecPolicy, FwdIter2>
+inclusive_scan(ExecPolicy&& policy, FwdIter1 first, FwdIter1 last,
+               FwdIter2 dst, BinOp op) {
+    if (first == last)
+        return dst;
+
+    details::IteratorValueType<FwdIter1> init = *first;
+    *dst = init;
+    return tiny_stl::inclusive_scan(tiny_stl::forward<ExecPolicy>(policy),
+                                    ++first, last, ++dst, op,
+                                    tiny_stl::move(init));
+}
+
+template <typename ExecPolicy, typename FwdIter1, typename FwdIter2>
+inline EnableIfExecPolicy<ExecPolicy, FwdIter2>
+inclusive_scan(ExecPolicy&& policy, FwdIter1 first, FwdIter1 last,
+               FwdIter2 dst) {
+    return tiny_stl::inclusive_scan(tiny_stl::forward<ExecPolicy>(policy),
+                                    first, last, dst, tiny_stl::plus<>{});
+}
+
+template <typename ExecPolicy, typename FwdIter1, typename FwdIter2,
+          typename T, typename BinOp>
+inline EnableIfExecPolicy<ExecPolicy, FwdIter2>
+exclusive_scan(ExecPolicy&&, FwdIter1 first, FwdIter1 last, FwdIter2 dst,
+               T init, BinOp op) {
+    using Tag = typename conjunction<
+        is_same<decay_t<ExecPolicy>, execution::parallel_policy>,
+        details::ParallelScanTag<FwdIter1, FwdIter2, T>>::type;
+    return details::parallelExclusiveScan(first, last, dst, init, op, Tag{});
+}
+
+template <typename ExecPolicy, typename FwdIter1, typename FwdIter2,
+          typename T>
+inline EnableIfExecPolicy<ExecPolicy, FwdIter2>
+exclusive_scan(ExecPolicy&& policy, FwdIter1 first, FwdIter1 last,
+               FwdIter2 dst, T init) {
+    return tiny_stl::exclusive_scan(tiny_stl::forward<ExecPolicy>(policy),
+                                    first, last, dst, init,
+                                    tiny_stl::plus<>{});
+}
+
+} // namespace tiny_stl
@@ -0,0 +1,345 @@
+// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include "functional.hpp"
+#include "memory.hpp"
+
+namespace tiny_stl {
+
+// Pairing heap, a heap-ordered multiway tree of nodes. push, decrease_key
+// and merge are O(1), pop is amortized O(log n) by melding the children of
+// the root in two passes. Compared with indexed_priority_queue it needs
+// no handle table and merges in O(1), at the cost of one allocation per
+// element and pointer chasing on pop.
+//
+// A handle stays valid until its element is popped or erased.
+template <typename T, typename Compare = tiny_stl::less<T>,
+          typename Alloc = allocator<T>>
+class pairing_heap {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using value_compare = Compare;
+    using allocator_type = Alloc;
+    using reference = T&;
+    using const_reference = const T&;
+
+private:
+    struct Node {
+        T value;
+        Node* child; // first child
+        Node* next;  // next sibling
+        Node* prev;  // previous sibling, the parent for a first child
+    };
+
+    using AlTraits = allocator_traits<Alloc>;
+    using AlNode = typename AlTraits::template rebind_alloc<Node>;
+
+public:
+    class handle_type {
+        friend pairing_heap;
+
+    private:
+        Node* node;
+
+        explicit handle_type(Node* p) noexcept : node(p) {
+        }
+
+    public:
+        handle_type() noexcept : node(nullptr) {
+        }
+
+        const_reference operator*() const noexcept {
+            return node->value;
+        }
+
+        friend bool operator==(handle_type lhs, handle_type rhs) noexcept {
+            return lhs.node == rhs.node;
+        }
+
+        friend bool operator!=(handle_type lhs, handle_type rhs) noexcept {
+            return lhs.node != rhs.node;
+        }
+    };
+
+private:
+    AlNode alloc;
+    Compare comp;
+    Node* root;
+    size_type count;
+
+private:
+    template <typename... Args>
+    Node* allocAndConstruct(Args&&... args) {
+        Node* p = alloc.allocate(1);
+        try {
+            alloc.construct(tiny_stl::addressof(p->value),
+                            tiny_stl::forward<Args>(args)...);
+        } catch (...) {
+            alloc.deallocate(p, 1);
+            throw;
+        }
+
+        p->child = p->next = p->prev = nullptr;
+        return p;
+    }
+
+    void destroyAndFree(Node* p) noexcept {
+        alloc.destroy(tiny_stl::addressof(p->value));
+        alloc.deallocate(p, 1);
+    }
+
+    // a and b are roots without siblings, the one that goes first takes
+    // the other as its first child
+    Node* meld(Node* a, Node* b) noexcept {
+        if (a == nullptr)
+            return b;
+        if (b == nullptr)
+            return a;
+
+        if (comp(a->value, b->value))
+            tiny_stl::swap(a, b);
+
+        b->prev = a;
+        b->next = a->child;
+        if (a->child != nullptr)
+            a->child->prev = b;
+        a->child = b;
+        return a;
+    }
+
+    // the two-pass pairing of a sibling list: meld pairs from left to
+    // right, then meld the results from right to left
+    Node* combine(Node* first) noexcept {
+        if (first == nullptr)
+            return nullptr;
+
+        Node* pairs = nullptr; // melded pairs, the last one first
+        while (first != nullptr) {
+            Node* a = first;
+            Node* b = a->next;
+            first = b == nullptr ? nullptr : b->next;
+
+            a->next = a->prev = nullptr;
+            if (b != nullptr)
+                b->next = b->prev = nullptr;
+
+            Node* m = meld(a, b);
+            m->next = pairs;
+            pairs = m;
+        }
+
+        Node* result = pairs;
+        pairs = pairs->next;
+        result->next = nullptr;
+        while (pairs != nullptr) {
+            Node* p = pairs;
+            pairs = pairs->next;
+            p->next = nullptr;
+            result = meld(p, result);
+        }
+
+        return result;
+    }
+
+    // detach the subtree of p, which isn't the root
+    static void cut(Node* p) noexcept {
+        if (p->prev->child == p)
+            p->prev->child = p->next;
+        else
+            p->prev->next = p->next;
+
+        if (p->next != nullptr)
+            p->next->prev = p->prev;
+        p->next = p->prev = nullptr;
+    }
+
+    // p no longer has a parent, sift it up by cutting and melding
+    void promote(Node* p) noexcept {
+        if (p != root) {
+            cut(p);
+            root = meld(root, p);
+        }
+    }
+
+    // p got a worse priority, its children may now belong above it
+    void demote(Node* p) noexcept {
+        Node* children = combine(p->child);
+        p->child = nullptr;
+        if (p == root) {
+            root = meld(children, p);
+        } else {
+            cut(p);
+            root = meld(meld(root, children), p);
+        }
+    }
+
+    void destroyAll() noexcept {
+        // splice the children of each node in front of its siblings
+        Node* p = root;
+        while (p != nullptr) {
+            Node* next = p->next;
+            if (p->child != nullptr) {
+                Node* last = p->child;
+                while (last->next != nullptr)
+                    last = last->next;
+                last->next = next;
+                next = p->child;
+            }
+
+            destroyAndFree(p);
+            p = next;
+        }
+    }
+
+public:
+    explicit pairing_heap(const Compare& cmp = Compare(),
+                          const Alloc& a = Alloc())
+        : alloc(a), comp(cmp), root(nullptr), count(0) {
+    }
+
+    pairing_heap(const pairing_heap&) = delete;
+    pairing_heap& operator=(const pairing_heap&) = delete;
+
+    pairing_heap(pairing_heap&& rhs) noexcept
+        : alloc(tiny_stl::move(rhs.alloc)), comp(tiny_stl::move(rhs.comp)),
+          root(rhs.root), count(rhs.count) {
+        rhs.root = nullptr;
+        rhs.count = 0;
+    }
+
+    pairing_heap& operator=(pairing_heap&& rhs) noexcept {
+        if (this != &rhs) {
+            destroyAll();
+            alloc = tiny_stl::move(rhs.alloc);
+            comp = tiny_stl::move(rhs.comp);
+            root = rhs.root;
+            count = rhs.count;
+            rhs.root = nullptr;
+            rhs.count = 0;
+        }
+        return *this;
+    }
+
+    ~pairing_heap() {
+        destroyAll();
+    }
+
+public:
+    bool empty() const noexcept {
+        return root == nullptr;
+    }
+
+    size_type size() const noexcept {
+        return count;
+    }
+
+    const_reference top() const {
+        return root->value;
+    }
+
+    handle_type top_handle() const noexcept {
+        return handle_type(root);
+    }
+
+public:
+    handle_type push(const T& val) {
+        return emplace(val);
+    }
+
+    handle_type push(T&& val) {
+        return emplace(tiny_stl::move(val));
+    }
+
+    template <typename... Args>
+    handle_type emplace(Args&&... args) {
+        Node* p = allocAndConstruct(tiny_stl::forward<Args>(args)...);
+        root = meld(root, p);
+        ++count;
+        return handle_type(p);
+    }
+
+    void pop() {
+        Node* old = root;
+        root = combine(old->child);
+        destroyAndFree(old);
+        --count;
+    }
+
+    void erase(handle_type h) {
+        Node* p = h.node;
+        if (p == root) {
+            pop();
+            return;
+        }
+
+        cut(p);
+        root = meld(root, combine(p->child));
+        destroyAndFree(p);
+        --count;
+    }
+
+    // replace the value of h, it may move either way
+    void update(handle_type h, const T& val) {
+        Node* p = h.node;
+        const bool worse = comp(val, p->value);
+        p->value = val;
+        worse ? demote(p) : promote(p);
+    }
+
+    void update(handle_type h, T&& val) {
+        Node* p = h.node;
+        const bool worse = comp(val, p->value);
+        p->value = tiny_stl::move(val);
+        worse ? demote(p) : promote(p);
+    }
+
+    // replace the value of h with one that doesn't compare less, i.e. a
+    // smaller key in a min-heap (Compare = greater), O(1)
+    void decrease_key(handle_type h, const T& val) {
+        assert(!comp(val, *h));
+        h.node->value = val;
+        promote(h.node);
+    }
+
+    void decrease_key(handle_type h, T&& val) {
+        assert(!comp(val, *h));
+        h.node->value = tiny_stl::move(val);
+        promote(h.node);
+    }
+
+    // take all elements of rhs in O(1), its handles stay valid for *this
+    void merge(pairing_heap& rhs) noexcept {
+        if (this == &rhs)
+            return;
+
+        root = meld(root, rhs.root);
+        count += rhs.count;
+        rhs.root = nullptr;
+        rhs.count = 0;
+    }
+
+    void clear() noexcept {
+        destroyAll();
+        root = nullptr;
+        count = 0;
+    }
+
+    void swap(pairing_heap& rhs) noexcept {
+        swapADL(alloc, rhs.alloc);
+        swapADL(comp, rhs.comp);
+        tiny_stl::swap(root, rhs.root);
+        tiny_stl::swap(count, rhs.count);
+    }
+}; // class pairing_heap<T, Compare, Alloc>
+
+template <typename T, typename Compare, typename Alloc>
+void swap(pairing_heap<T, Compare, Alloc>& lhs,
+          pairing_heap<T, Compare, Alloc>& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+} // namespace tiny_stl
@@ -171,8 +171,12 @@ template <typename T, typename Container, typename Alloc>
 struct uses_allocator<queue<T, Container>, Alloc>
     : uses_allocator<Container, Alloc>::type {};
 
+// Arity is the number of children of a heap node. 4 or 8 make a
+// shallower heap whose sibling groups share cache lines, which is faster
+// for large queues.
 template <typename T, typename Container = tiny_stl::vector<T>,
-          typename Compare = tiny_stl::less<typename Container::value_type>>
+          typename Compare = tiny_stl::less<typename Container::value_type>,
+          std::size_t Arity = 2>
 class priority_queue {
 public:
     using container_type = Container;
@@ -185,6 +189,7 @@ public:
 public:
     static_assert(is_same<T, value_type>::value,
                   "container_type::value_type error");
+    static_assert(Arity >= 2, "a heap node needs at least two children");
 
 private:
     value_compare comp;
@@ -194,14 +199,14 @@ public:
     // (1)
     priority_queue(const value_compare& cmp, const container_type& c)
         : comp(cmp), cont(c) {
-        tiny_stl::make_heap(cont.begin(), cont.end(), comp);
+        details::makeDHeap<Arity>(cont.begin(), cont.end(), comp);
     }
 
     // (2)
     explicit priority_queue(const value_compare& cmp = value_compare{},
                             container_type&& c = container_type{})
         : comp(cmp), cont(tiny_stl::move(c)) {
-        tiny_stl::make_heap(cont.begin(), cont.end(), comp);
+        details::makeDHeap<Arity>(cont.begin(), cont.end(), comp);
     }
 
     // (3)
@@ -232,7 +237,7 @@ public:
     priority_queue(const value_compare& cmp, const container_type& c,
                    const Alloc& alloc)
         : comp(cmp), cont(c, alloc) {
-        tiny_stl::make_heap(cont.begin(), cont.end(), comp);
+        details::makeDHeap<Arity>(cont.begin(), cont.end(), comp);
     }
 
     // (8)
@@ -241,7 +246,7 @@ public:
     priority_queue(const value_compare& cmp, container_type&& c,
                    const Alloc& alloc)
         : comp(cmp), cont(tiny_stl::move(c), alloc) {
-        tiny_stl::make_heap(cont.begin(), cont.end(), comp);
+        details::makeDHeap<Arity>(cont.begin(), cont.end(), comp);
     }
 
     // (9)
@@ -265,7 +270,7 @@ public:
                    const container_type& c)
         : comp(cmp), cont(c) {
         cont.insert(cont.end(), first, last);
-        tiny_stl::make_heap(cont.begin(), cont.end(), comp);
+        details::makeDHeap<Arity>(cont.begin(), cont.end(), comp);
     }
 
     // (12)
@@ -275,7 +280,7 @@ public:
                    container_type&& c = container_type{})
         : comp(cmp), cont(tiny_stl::move(c)) {
         cont.insert(cont.end(), first, last);
-        tiny_stl::make_heap(cont.begin(), cont.end(), comp);
+        details::makeDHeap<Arity>(cont.begin(), cont.end(), comp);
     }
 
     const_reference top() const {
@@ -292,22 +297,44 @@ public:
 
     void push(const value_type& val) {
         cont.push_back(val);
-        tiny_stl::push_heap(cont.begin(), cont.end(), comp);
+        details::pushDHeap<Arity>(cont.begin(), cont.end(), comp);
     }
 
     void push(value_type&& val) {
         cont.push_back(tiny_stl::move(val));
-        tiny_stl::push_heap(cont.begin(), cont.end(), comp);
+        details::pushDHeap<Arity>(cont.begin(), cont.end(), comp);
     }
 
     template <typename... Args>
     void emplace(Args&&... args) {
         cont.emplace_back(tiny_stl::forward<Args>(args)...);
-        tiny_stl::push_heap(cont.begin(), cont.end(), comp);
+        details::pushDHeap<Arity>(cont.begin(), cont.end(), comp);
+    }
+
+    // Appends [first, last) and rebuilds the heap in O(size()) when that
+    // is cheaper than sifting up every new element, which costs up to the
+    // height of the heap each.
+    template <typename InIter>
+    void push_range(InIter first, InIter last) {
+        const size_type old = cont.size();
+        cont.insert(cont.end(), first, last);
+        const size_type len = cont.size();
+
+        size_type height = 0;
+        for (size_type n = len; n != 0; n /= Arity)
+            ++height;
+
+        if ((len - old) * height >= len) {
+            details::makeDHeap<Arity>(cont.begin(), cont.end(), comp);
+        } else {
+            for (size_type i = old; i != len; ++i)
+                details::pushDHeap<Arity>(cont.begin(), cont.begin() + (i + 1),
+                                          comp);
+        }
     }
 
     void pop() {
-        tiny_stl::pop_heap(cont.begin(), cont.end(), comp);
+        details::popDHeap<Arity>(cont.begin(), cont.end(), comp);
         cont.pop_back();
     }
 
@@ -317,17 +344,149 @@ public:
         swapADL(comp, rhs.comp);
         swapADL(cont, rhs.cont);
     }
-}; // class priority_queue<T, Container>
+}; // class priority_queue<T, Container, Compare, Arity>
 
-template <typename T, typename Container, typename Compare>
-void swap(priority_queue<T, Container, Compare>& lhs,
-          priority_queue<T, Container, Compare>&
+template <typename T, typename Container, typename Compare,
+          std::size_t Arity>
+void swap(priority_queue<T, Container, Compare, Arity>& lhs,
+          priority_queue<T, Container, Compare, Arity>&
               rhs) noexcept(noexcept(lhs.swap(rhs))) {
     lhs.swap(rhs);
 }
 
-template <typename T, typename Container, typename Compare, typename Alloc>
-struct uses_allocator<priority_queue<T, Container, Compare>, Alloc>
+template <typename T, typename Container, typename Compare,
+          std::size_t Arity, typename Alloc>
+struct uses_allocator<priority_queue<T, Container, Compare, Arity>, Alloc>
     : tiny_stl::uses_allocator<Container, Alloc>::type {};
 
+// Keeps the k greatest values pushed into it, for a top-k query over a
+// stream that needn't be stored. The kept values are a min-heap, so a push
+// costs one comparison against the smallest of them, and O(log k) only when
+// it replaces that one. With Compare = greater it keeps the k smallest.
+template <typename T, typename Compare = tiny_stl::less<T>,
+          typename Alloc = allocator<T>>
+class top_k {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using value_compare = Compare;
+    using allocator_type = Alloc;
+    using reference = T&;
+    using const_reference = const T&;
+
+private:
+    constexpr static const std::size_t kArity = 4;
+
+    // the heap order, the smallest kept value goes on top
+    struct HeapCompare {
+        const Compare& comp;
+
+        bool operator()(const T& lhs, const T& rhs) const {
+            return comp(rhs, lhs);
+        }
+    };
+
+private:
+    vector<T, Alloc> heap;
+    size_type limit;
+    Compare comp;
+
+private:
+    template <typename U>
+    void pushAux(U&& val) {
+        HeapCompare cmp{comp};
+        if (heap.size() < limit) {
+            heap.push_back(tiny_stl::forward<U>(val));
+            details::pushDHeap<kArity>(heap.begin(), heap.end(), cmp);
+        } else if (limit != 0 && comp(heap.front(), val)) {
+            T tmp(tiny_stl::forward<U>(val));
+            details::adjustDHeap<kArity>(
+                heap.begin(), std::ptrdiff_t(0),
+                static_cast<std::ptrdiff_t>(heap.size()), tiny_stl::move(tmp),
+                cmp, details::NotTracked{});
+        }
+    }
+
+public:
+    explicit top_k(size_type k, const Compare& cmp = Compare(),
+                   const Alloc& alloc = Alloc())
+        : heap(alloc), limit(k), comp(cmp) {
+        heap.reserve(k);
+    }
+
+public:
+    bool empty() const noexcept {
+        return heap.empty();
+    }
+
+    size_type size() const noexcept {
+        return heap.size();
+    }
+
+    // the number of values kept at most
+    size_type k() const noexcept {
+        return limit;
+    }
+
+    // the smallest kept value, the k-th greatest once size() == k()
+    const_reference threshold() const {
+        return heap.front();
+    }
+
+public:
+    void push(const T& val) {
+        pushAux(val);
+    }
+
+    void push(T&& val) {
+        pushAux(tiny_stl::move(val));
+    }
+
+    template <typename InIter>
+    void push(InIter first, InIter last) {
+        for (; first != last; ++first)
+            pushAux(*first);
+    }
+
+    // the kept values, the greatest first
+    vector<T, Alloc> sorted() const& {
+        vector<T, Alloc> result(heap);
+        sortDescending(result);
+        return result;
+    }
+
+    vector<T, Alloc> sorted() && {
+        vector<T, Alloc> result(tiny_stl::move(heap));
+        heap.clear();
+        sortDescending(result);
+        return result;
+    }
+
+    void clear() noexcept {
+        heap.clear();
+    }
+
+    void swap(top_k& rhs) noexcept(is_nothrow_swappable<Compare>::value) {
+        heap.swap(rhs.heap);
+        tiny_stl::swap(limit, rhs.limit);
+        swapADL(comp, rhs.comp);
+    }
+
+private:
+    void sortDescending(vector<T, Alloc>& v) const {
+        HeapCompare cmp{comp};
+        for (auto last = v.end(); last - v.begin() > 1; --last)
+            details::popDHeap<kArity>(v.begin(), last, cmp);
+    }
+}; // class top_k<T, Compare, Alloc>
+
+template <typename T, typename Compare, typename Alloc>
+constexpr const std::size_t top_k<T, Compare, Alloc>::kArity;
+
+template <typename T, typename Compare, typename Alloc>
+void swap(top_k<T, Compare, Alloc>& lhs,
+          top_k<T, Compare, Alloc>& rhs) noexcept(noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
 } // namespace tiny_stl
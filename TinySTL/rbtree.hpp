@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <initializer_list>
 
 #include "memory.hpp"
@@ -14,20 +15,105 @@ namespace {
 
 enum class Color : uint16_t { RED, BLACK };
 
+#ifdef TINY_STL_RBTREE_UNPACKED_NODE
+
+// Plain layout, every link and flag is a separate field. Easier to inspect in
+// a debugger, but the flags leave a padding hole before the pointers.
 template <typename T>
 struct RBTNode {
     using IsNil = uint16_t;
     Color color;
-    IsNil isNil; // 1 is nil, 0 is not nil
+    IsNil nil; // 1 is nil, 0 is not nil
     RBTNode* parent;
     RBTNode* left;
     RBTNode* right;
     T value;
+
+    void init(RBTNode* link, Color c, bool isNilNode) noexcept {
+        color = c;
+        nil = isNilNode ? 1 : 0;
+        parent = link;
+        left = link;
+        right = link;
+    }
+
+    RBTNode* getParent() const noexcept {
+        return parent;
+    }
+
+    void setParent(RBTNode* p) noexcept {
+        parent = p;
+    }
+
+    Color getColor() const noexcept {
+        return color;
+    }
+
+    void setColor(Color c) noexcept {
+        color = c;
+    }
+
+    bool isNil() const noexcept {
+        return nil != 0;
+    }
+};
+
+#else // !TINY_STL_RBTREE_UNPACKED_NODE
+
+// Compact layout, the color and the nil flag live in the low bits of the
+// parent pointer (nodes are at least pointer-aligned), so a node is three
+// pointers plus the value with no padding in between.
+template <typename T>
+struct RBTNode {
+    enum : std::uintptr_t { colorBit = 1, nilBit = 2, flagBits = 3 };
+    static_assert(alignof(RBTNode*) > flagBits,
+                  "node pointers have no spare low bits");
+
+    std::uintptr_t parentAndFlags;
+    RBTNode* left;
+    RBTNode* right;
+    T value;
+
+    void init(RBTNode* link, Color c, bool isNilNode) noexcept {
+        const std::uintptr_t flags =
+            (c == Color::BLACK ? std::uintptr_t(colorBit) : 0) |
+            (isNilNode ? std::uintptr_t(nilBit) : 0);
+        parentAndFlags = reinterpret_cast<std::uintptr_t>(link) | flags;
+        left = link;
+        right = link;
+    }
+
+    RBTNode* getParent() const noexcept {
+        return reinterpret_cast<RBTNode*>(parentAndFlags &
+                                          ~std::uintptr_t(flagBits));
+    }
+
+    void setParent(RBTNode* p) noexcept {
+        parentAndFlags = reinterpret_cast<std::uintptr_t>(p) |
+                         (parentAndFlags & flagBits);
+    }
+
+    Color getColor() const noexcept {
+        return (parentAndFlags & colorBit) ? Color::BLACK : Color::RED;
+    }
+
+    void setColor(Color c) noexcept {
+        if (c == Color::BLACK)
+            parentAndFlags |= colorBit;
+        else
+            parentAndFlags &= ~std::uintptr_t(colorBit);
+    }
+
+    bool isNil() const noexcept {
+        return (parentAndFlags & nilBit) != 0;
+    }
 };
 
+#endif // TINY_STL_RBTREE_UNPACKED_NODE
+
 template <typename T>
 inline RBTNode<T>* rbTreeMinValue(RBTNode<T>* ptr) {
-    while (!ptr->left->isNil)
+    while (!ptr->left->isNil())
         ptr = ptr->left;
 
     return ptr;
@@ -35,7 +121,7 @@ inline RBTNode<T>* rbTreeMinValue(RBTNode<T>* ptr) {
 
 template <typename T>
 inline RBTNode<T>* rbTreeMaxValue(RBTNode<T>* ptr) {
-    while (!ptr->right->isNil)
+    while (!ptr->right->isNil())
         ptr = ptr->right;
 
     return ptr;
@@ -49,24 +135,26 @@ inline RBTNode<T>* rbTreeMaxValue(RBTNode<T>* ptr) {
 //         ↙  ↘                       ↙ ↘
 //         b    c                      a    b
 //
+// header is the nil node, its parent is the root
 template <typename T>
-inline void rbTreeLeftRotate(RBTNode<T>*& root, RBTNode<T>* x) {
+inline void rbTreeLeftRotate(RBTNode<T>* header, RBTNode<T>* x) {
     RBTNode<T>* y = x->right;
+    RBTNode<T>* xp = x->getParent();
 
     x->right = y->left;
-    if (!y->left->isNil)
-        y->left->parent = x;
+    if (!y->left->isNil())
+        y->left->setParent(x);
 
-    y->parent = x->parent;
+    y->setParent(xp);
 
-    if (x->parent->isNil)
-        root = y;
-    else if (x == x->parent->left) // x is the left child of x.p
-        x->parent->left = y;
+    if (xp->isNil())
+        header->setParent(y);
+    else if (x == xp->left) // x is the left child of x.p
+        xp->left = y;
     else
-        x->parent->right = y;
+        xp->right = y;
 
-    x->parent = y;
+    x->setParent(y);
     y->left = x;
 }
 
@@ -78,24 +166,25 @@ inline void rbTreeLeftRotate(RBTNode<T>*& root, RBTNode<T>* x) {
 //  a    b                                  b    c
 //
 template <typename T>
-inline void rbTreeRightRotate(RBTNode<T>*& root, RBTNode<T>* y) {
+inline void rbTreeRightRotate(RBTNode<T>* header, RBTNode<T>* y) {
     RBTNode<T>* x = y->left;
+    RBTNode<T>* yp = y->getParent();
 
     y->left = x->right;
-    if (!x->right->isNil)
-        x->right->parent = y;
+    if (!x->right->isNil())
+        x->right->setParent(y);
 
-    x->parent = y->parent;
+    x->setParent(yp);
 
-    if (y->parent->isNil)
-        root = x;
-    else if (y == y->parent->left)
-        y->parent->left = x;
+    if (yp->isNil())
+        header->setParent(x);
+    else if (y == yp->left)
+        yp->left = x;
     else
-        y->parent->right = x;
+        yp->right = x;
 
     x->right = y;
-    y->parent = x;
+    y->setParent(x);
 }
 
 } // namespace
@@ -128,14 +217,14 @@ struct RBTreeConstIterator {
     }
 
     RBTreeConstIterator& operator++() {
-        if (!ptr->right->isNil) {
+        if (!ptr->right->isNil()) {
             ptr = ptr->right;
             ptr = rbTreeMinValue(ptr);
         } else {
-            Ptr x = ptr->parent;
-            while (!x->isNil && ptr == x->right) {
+            Ptr x = ptr->getParent();
+            while (!x->isNil() && ptr == x->right) {
                 ptr = x;
-                x = x->parent;
+                x = x->getParent();
             }
             ptr = x;
         }
@@ -151,16 +240,16 @@ struct RBTreeConstIterator {
     }
 
     RBTreeConstIterator& operator--() {
-        if (ptr->isNil)
+        if (ptr->isNil())
             ptr = ptr->right;
-        else if (!ptr->left->isNil) {
+        else if (!ptr->left->isNil()) {
             ptr = ptr->left;
             ptr = rbTreeMaxValue(ptr);
         } else {
-            Ptr x = ptr->parent;
-            while (!x->isNil && ptr == x->left) {
+            Ptr x = ptr->getParent();
+            while (!x->isNil() && ptr == x->left) {
                 ptr = x;
-                x = x->parent;
+                x = x->getParent();
             }
             ptr = x;
         }
@@ -277,11 +366,7 @@ private:
     void createHeaderNode() {
         try {
             header = alloc.allocate(1);
-            header->left = header;
-            header->right = header;
-            header->parent = header;
-            header->isNil = 1;
-            header->color = Color::BLACK;
+            header->init(header, Color::BLACK, true);
         } catch (...) {
             alloc.deallocate(header, 1);
             throw;
@@ -321,11 +406,7 @@ private:
     NodePtr allocAndConstruct(Args&&... args) {
         NodePtr p = this->alloc.allocate(1);
 
-        p->color = Color::RED;
-        p->isNil = 0;
-        p->parent = this->header;
-        p->left = this->header;
-        p->right = this->header;
+        p->init(this->header, Color::RED, false);
 
         try {
             this->alloc.construct(tiny_stl::addressof(p->value),
@@ -345,8 +426,8 @@ private:
         }
     }
 
-    NodePtr& getRoot() const noexcept {
-        return this->header->parent;
+    NodePtr getRoot() const noexcept {
+        return this->header->getParent();
     }
 
     // map
@@ -380,9 +461,9 @@ private:
     template <typename K>
     NodePtr lowBoundAux(const K& val) const {
         NodePtr pos = this->header;
-        NodePtr p = pos->parent;
+        NodePtr p = pos->getParent();
 
-        while (!p->isNil) {
+        while (!p->isNil()) {
             if (this->compare(get_key(p), val)) {
                 p = p->right;
             } else {
@@ -397,9 +478,9 @@ private:
     template <typename K>
     NodePtr uppBoundAux(const K& val) const {
         NodePtr pos = this->header;
-        NodePtr p = pos->parent;
+        NodePtr p = pos->getParent();
 
-        while (!p->isNil) {
+        while (!p->isNil()) {
             if (!this->compare(val, get_key(p))) {
                 p = p->right;
             } else {
@@ -414,19 +495,18 @@ private:
     NodePtr copyNodes(NodePtr rhsRoot, NodePtr thisPos) {
         NodePtr newheader = this->header;
 
-        if (!rhsRoot->isNil) {
+        if (!rhsRoot->isNil()) {
             NodePtr p = this->alloc.allocate(1);
-            p->color = rhsRoot->color;
-            p->isNil = 0;
-            p->parent = thisPos;
+            p->init(thisPos, rhsRoot->getColor(), false);
             try {
-                p->value = rhsRoot->value;
+                this->alloc.construct(tiny_stl::addressof(p->value),
+                                      rhsRoot->value);
             } catch (...) {
                 this->alloc.deallocate(p, 1);
                 throw;
             }
 
-            if (newheader->isNil)
+            if (newheader->isNil())
                 newheader = p;
 
             p->left = copyNodes(rhsRoot->left, p);
@@ -437,10 +517,10 @@ private:
     }
 
     void copyAux(const RBTree& rhs) {
-        getRoot() = copyNodes(rhs.getRoot(), this->header);
+        this->header->setParent(copyNodes(rhs.getRoot(), this->header));
         this->mCount = rhs.mCount;
 
-        if (!getRoot()->isNil) {
+        if (!getRoot()->isNil()) {
             this->header->left = rbTreeMinValue(getRoot());
             this->header->right = rbTreeMaxValue(getRoot());
         } else {
@@ -455,112 +535,125 @@ private:
         tiny_stl::swapADL(this->mCount, rhs.mCount);
     }
 
-    void rbTreeFixupForInsert(NodePtr& root, NodePtr z) {
-        while (z->parent->color == Color::RED) { // parent is red
+    void rbTreeFixupForInsert(NodePtr z) {
+        NodePtr header = this->header;
+
+        // parent is red
+        while (z->getParent()->getColor() == Color::RED) {
+            NodePtr zp = z->getParent();
+            NodePtr zpp = zp->getParent();
+
             // if parent is grandfather's left child
-            if (z->parent == z->parent->parent->left) {
-                NodePtr y = z->parent->parent->right; // y is z's uncle
-
-                if (y->color == Color::RED) { // case 1, z's uncle is red
-                    z->parent->color = Color::BLACK;
-                    y->color = Color::BLACK;
-                    z->parent->parent->color = Color::RED;
-                    z = z->parent->parent;
+            if (zp == zpp->left) {
+                NodePtr y = zpp->right; // y is z's uncle
+
+                if (y->getColor() == Color::RED) { // case 1, z's uncle is red
+                    zp->setColor(Color::BLACK);
+                    y->setColor(Color::BLACK);
+                    zpp->setColor(Color::RED);
+                    z = zpp;
                 } else {
-                    if (z == z->parent->right) {
+                    if (z == zp->right) {
                         // case 2, z is parent's right child
-                        z = z->parent;
-                        rbTreeLeftRotate(root, z);
+                        z = zp;
+                        rbTreeLeftRotate(header, z);
                     }
-                    z->parent->color =
-                        Color::BLACK; // case 3, z is parent's left child
-                    z->parent->parent->color = Color::RED;
-                    rbTreeRightRotate(root, z->parent->parent);
+                    // case 3, z is parent's left child
+                    z->getParent()->setColor(Color::BLACK);
+                    zpp->setColor(Color::RED);
+                    rbTreeRightRotate(header, zpp);
                 }
             } else { // parent is grandfather's right
-                NodePtr y = z->parent->parent->left; // y is z's uncle
+                NodePtr y = zpp->left; // y is z's uncle
 
-                if (y->color == Color::RED) { // case 1, z's uncle is red
-                    z->parent->color = Color::BLACK;
-                    y->color = Color::BLACK;
-                    z->parent->parent->color = Color::RED;
-                    z = z->parent->parent;
+                if (y->getColor() == Color::RED) { // case 1, z's uncle is red
+                    zp->setColor(Color::BLACK);
+                    y->setColor(Color::BLACK);
+                    zpp->setColor(Color::RED);
+                    z = zpp;
                 } else {
-                    if (z == z->parent->left) {
+                    if (z == zp->left) {
                         // case 2, z is parent's left child
-                        z = z->parent;
-                        rbTreeRightRotate(root, z);
+                        z = zp;
+                        rbTreeRightRotate(header, z);
                     }
-                    // case 3, z is parent's left child
-                    z->parent->color = Color::BLACK;
-                    z->parent->parent->color = Color::RED;
-                    rbTreeLeftRotate(root, z->parent->parent);
+                    // case 3, z is parent's right child
+                    z->getParent()->setColor(Color::BLACK);
+                    zpp->setColor(Color::RED);
+                    rbTreeLeftRotate(header, zpp);
                 }
             }
         }
 
-        root->color = Color::BLACK;
+        getRoot()->setColor(Color::BLACK);
     }
 
-    void rbTreeFixupForErase(NodePtr& root, NodePtr x) {
-        while (x != root && x->color == Color::BLACK) {
-            if (x == x->parent->left) {
-                NodePtr w = x->parent->right;
-                if (w->color == Color::RED) { // case 1, x's brother w is red
-                    w->color = Color::BLACK;
-                    x->parent->color = Color::RED;
-                    rbTreeLeftRotate(root, x->parent);
-                    w = x->parent->right;
+    // x may be the nil header, so its parent is passed in explicitly instead
+    // of being written to the header (whose parent is the root)
+    void rbTreeFixupForErase(NodePtr x, NodePtr xp) {
+        NodePtr header = this->header;
+
+        while (x != getRoot() && x->getColor() == Color::BLACK) {
+            if (x == xp->left) {
+                NodePtr w = xp->right;
+                if (w->getColor() == Color::RED) {
+                    // case 1, x's brother w is red
+                    w->setColor(Color::BLACK);
+                    xp->setColor(Color::RED);
+                    rbTreeLeftRotate(header, xp);
+                    w = xp->right;
                 }
-                if (w->left->color == Color::BLACK &&
-                    w->right->color == Color::BLACK) {
+                if (w->left->getColor() == Color::BLACK &&
+                    w->right->getColor() == Color::BLACK) {
                     // case 2, w's left and right child is black
-                    w->color = Color::RED;
-                    x = x->parent;
+                    w->setColor(Color::RED);
+                    x = xp;
+                    xp = xp->getParent();
                 } else { // case 3, w's right child is black
-                    if (w->right->color == Color::BLACK) {
-                        w->left->color = Color::BLACK;
-                        w->color = Color::RED;
-                        rbTreeRightRotate(root, w);
-                        w = x->parent->right;
+                    if (w->right->getColor() == Color::BLACK) {
+                        w->left->setColor(Color::BLACK);
+                        w->setColor(Color::RED);
+                        rbTreeRightRotate(header, w);
+                        w = xp->right;
                     }
-                    w->color = x->parent->color;
-                    x->parent->color = Color::BLACK;
-                    w->right->color = Color::BLACK;
-                    rbTreeLeftRotate(root, x->parent);
-                    x = root;
+                    // case 4
+                    w->setColor(xp->getColor());
+                    xp->setColor(Color::BLACK);
+                    w->right->setColor(Color::BLACK);
+                    rbTreeLeftRotate(header, xp);
+                    x = getRoot();
                 }
             } else {
-                NodePtr w = x->parent->left;
-                if (w->color == Color::RED) { // case 1
-                    w->color = Color::BLACK;
-                    x->parent->color = Color::RED;
-                    rbTreeRightRotate(root, x->parent);
-                    w = x->parent->left;
+                NodePtr w = xp->left;
+                if (w->getColor() == Color::RED) { // case 1
+                    w->setColor(Color::BLACK);
+                    xp->setColor(Color::RED);
+                    rbTreeRightRotate(header, xp);
+                    w = xp->left;
                 }
-                if (w->left->color == Color::BLACK &&
-                    w->right->color == Color::BLACK) { // case 2
-                    w->color = Color::RED;
-                    x = x->parent;
+                if (w->left->getColor() == Color::BLACK &&
+                    w->right->getColor() == Color::BLACK) { // case 2
+                    w->setColor(Color::RED);
+                    x = xp;
+                    xp = xp->getParent();
                 } else {
-                    if (w->left->color == Color::BLACK) { // case 3
-                        w->right->color = Color::BLACK;
-                        w->color = Color::RED;
-                        rbTreeLeftRotate(root, w);
-                        w = x->parent->left;
+                    if (w->left->getColor() == Color::BLACK) { // case 3
+                        w->right->setColor(Color::BLACK);
+                        w->setColor(Color::RED);
+                        rbTreeLeftRotate(header, w);
+                        w = xp->left;
                     }
                     // case 4
-                    w->color = x->parent->color;
-                    x->parent->color = Color::BLACK;
-                    w->left->color = Color::BLACK;
-                    rbTreeRightRotate(root, x->parent);
-                    x = root;
+                    w->setColor(xp->getColor());
+                    xp->setColor(Color::BLACK);
+                    w->left->setColor(Color::BLACK);
+                    rbTreeRightRotate(header, xp);
+                    x = getRoot();
                 }
             }
         }
 
-        x->color = Color::BLACK;
-        this->header->color = Color::BLACK;
+        x->setColor(Color::BLACK);
     }
 
 public:
@@ -728,13 +821,14 @@ private:
         NodePtr x = getRoot();
         NodePtr y = this->header;
 
-        if (y->left->isNil || this->compare(get_key(z), get_key(y->left)))
+        if (y->left->isNil() || this->compare(get_key(z), get_key(y->left)))
             y->left = z;
 
-        if (y->right->isNil || !this->compare(get_key(z), get_key(y->right)))
+        if (y->right->isNil() ||
+            !this->compare(get_key(z), get_key(y->right)))
             y->right = z;
 
-        while (!x->isNil) {
+        while (!x->isNil()) {
             y = x;
             if (this->compare(get_key(z), get_key(x)))
                 x = x->left;
@@ -742,10 +836,10 @@ private:
                 x = x->right;
         }
 
-        z->parent = y;
+        z->setParent(y);
 
-        if (y->isNil) {
-            getRoot() = z;
+        if (y->isNil()) {
+            this->header->setParent(z);
             this->header->left = z;
             this->header->right = z;
         } else if (this->compare(get_key(z), get_key(y))) {
@@ -758,7 +852,7 @@ private:
                 this->header->right = z; // z.key >= max_value
         }
 
-        rbTreeFixupForInsert(getRoot(), z);
+        rbTreeFixupForInsert(z);
 
         ++this->mCount;
 
@@ -777,11 +871,11 @@ private:
         iterator pos = find(getKeyFromValue(val));
 
         if (pos != end()) {
-            return make_pair(pos, false);
+            return tiny_stl::make_pair(pos, false);
         }
 
         NodePtr z = allocAndConstruct(tiny_stl::move(value));
-        return make_pair(insertAux(z), true);
+        return tiny_stl::make_pair(insertAux(z), true);
     }
 
 protected:
@@ -824,24 +918,28 @@ protected:
     }
 
 private:
-    // transplant v to the location of u
-    inline void transplantForErase(NodePtr& root, NodePtr u, NodePtr v) {
-        if (u->parent->isNil) // u is root
-            root = v;
-        else if (u == u->parent->left) // u is left child
-            u->parent->left = v;
+    // transplant v to the location of u, v may be the nil header
+    inline void transplantForErase(NodePtr u, NodePtr v) {
+        NodePtr up = u->getParent();
+
+        if (up->isNil()) // u is root
+            this->header->setParent(v);
+        else if (u == up->left) // u is left child
+            up->left = v;
         else // u is right child
-            u->parent->right = v;
+            up->right = v;
 
-        v->parent = u->parent;
+        if (!v->isNil())
+            v->setParent(up);
     }
 
     // erase node z
-    void eraseAux(NodePtr root, NodePtr z) {
+    void eraseAux(NodePtr z) {
         NodePtr y = z;
         NodePtr x = nullptr;
+        NodePtr xp = nullptr; // parent of x
 
-        Color yOriginColor = y->color;
+        Color yOriginColor = y->getColor();
 
         if (z == this->header->left)
             this->header->left = (++iterator(z)).ptr;
@@ -849,39 +947,39 @@ private:
         if (z == this->header->right)
             this->header->right = (--iterator(z)).ptr;
 
-        if (z->left->isNil) { // z has not left child
+        if (z->left->isNil()) { // z has not left child
             x = z->right;
-            transplantForErase(getRoot(), z, z->right);
-        } else if (z->right->isNil) { // z has not right child
+            xp = z->getParent();
+            transplantForErase(z, z->right);
+        } else if (z->right->isNil()) { // z has not right child
             x = z->left;
-            transplantForErase(getRoot(), z, z->left);
+            xp = z->getParent();
+            transplantForErase(z, z->left);
         } else { // z has left and right child
             y = rbTreeMinValue(z->right);
-            yOriginColor = y->color;
+            yOriginColor = y->getColor();
             x = y->right;
 
-            if (y->parent == z) {
-                x->parent = y;
+            if (y->getParent() == z) {
+                xp = y;
             } else {
-                transplantForErase(getRoot(), y, y->right);
+                xp = y->getParent();
+                transplantForErase(y, y->right);
                 y->right = z->right;
-                y->right->parent = y;
+                y->right->setParent(y);
             }
 
-            transplantForErase(getRoot(), z, y);
+            transplantForErase(z, y);
             y->left = z->left;
-            y->left->parent = y;
-            y->color = z->color;
+            y->left->setParent(y);
+            y->setColor(z->getColor());
         }
 
         if (yOriginColor == Color::BLACK)
-            rbTreeFixupForErase(root, x);
+            rbTreeFixupForErase(x, xp);
 
         destroyAndFree(z);
         --this->mCount;
-
-        this->header->parent = root;
-        root->parent = this->header;
     }
 
 public:
@@ -889,7 +987,7 @@ public:
         NodePtr z = pos.ptr;
 
         ++pos;
-        eraseAux(getRoot(), z);
+        eraseAux(z);
         return iterator(pos.ptr);
     }
 
@@ -965,7 +1063,7 @@ public:
 
 private:
     void clearAux(NodePtr root) {
-        for (NodePtr p = root; !p->isNil; root = p) {
+        for (NodePtr p = root; !p->isNil(); root = p) {
             clearAux(p->right);
             p = p->left;
             AlNodeTraits::destroy(this->alloc,
@@ -979,7 +1077,7 @@ public:
         clearAux(getRoot());
         this->header->left = this->header;
         this->header->right = this->header;
-        this->header->parent = this->header;
+        this->header->setParent(this->header);
         this->mCount = 0;
     }
 
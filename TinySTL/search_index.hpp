@@ -0,0 +1,772 @@
+// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+#include "algorithm.hpp"
+#include "vector.hpp"
+
+#if defined(TINY_STL_AVX2)
+#include <immintrin.h>
+#elif defined(TINY_STL_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace tiny_stl {
+
+namespace details {
+
+// n != 0
+inline unsigned floorLog2(std::uint64_t n) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - static_cast<unsigned>(__builtin_clzll(n));
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long idx;
+    _BitScanReverse64(&idx, n);
+    return static_cast<unsigned>(idx);
+#else
+    unsigned r = 0;
+    while (n >>= 1)
+        ++r;
+    return r;
+#endif
+}
+
+constexpr std::size_t floorPow2(std::size_t n) noexcept {
+    return n < 2 ? 1 : 2 * floorPow2(n / 2);
+}
+
+// Fixed size array whose first element starts a cache line. The
+// allocators have no alignment parameter, so one line more is allocated
+// and the start is rounded up. The elements are constructed one by one
+// with push_back after reset.
+template <typename T, typename Alloc>
+class CacheAlignedArray {
+public:
+    using size_type = std::size_t;
+
+private:
+    using AlTraits = allocator_traits<Alloc>;
+    using AlByte = typename AlTraits::template rebind_alloc<unsigned char>;
+
+    constexpr static const size_type kAlign =
+        TINY_STL_CACHE_LINE_SIZE > alignof(T) ? TINY_STL_CACHE_LINE_SIZE
+                                              : alignof(T);
+
+    Alloc alloc;
+    unsigned char* raw;
+    size_type rawSize;
+    T* first;
+    size_type len; // constructed elements
+    size_type cap;
+
+public:
+    explicit CacheAlignedArray(const Alloc& a) noexcept
+        : alloc(a), raw(nullptr), rawSize(0), first(nullptr), len(0),
+          cap(0) {
+    }
+
+    CacheAlignedArray(CacheAlignedArray&& rhs) noexcept
+        : alloc(tiny_stl::move(rhs.alloc)), raw(rhs.raw),
+          rawSize(rhs.rawSize), first(rhs.first), len(rhs.len),
+          cap(rhs.cap) {
+        rhs.raw = nullptr;
+        rhs.first = nullptr;
+        rhs.rawSize = rhs.len = rhs.cap = 0;
+    }
+
+    CacheAlignedArray(const CacheAlignedArray&) = delete;
+    CacheAlignedArray& operator=(const CacheAlignedArray&) = delete;
+
+    ~CacheAlignedArray() {
+        clear();
+    }
+
+    // destroys the elements and makes room for n new ones
+    void reset(size_type n) {
+        clear();
+        if (n == 0)
+            return;
+        if (n > (static_cast<size_type>(-1) - kAlign) / sizeof(T))
+            xLength();
+
+        AlByte al(alloc);
+        rawSize = n * sizeof(T) + kAlign - 1;
+        raw = al.allocate(rawSize);
+        const std::uintptr_t p = reinterpret_cast<std::uintptr_t>(raw);
+        first = reinterpret_cast<T*>((p + kAlign - 1) &
+                                     ~static_cast<std::uintptr_t>(kAlign - 1));
+        cap = n;
+    }
+
+    void push_back(const T& val) {
+        assert(len < cap);
+        AlTraits::construct(alloc, first + len, val);
+        ++len;
+    }
+
+    void clear() noexcept {
+        if (raw != nullptr) {
+            for (size_type i = 0; i < len; ++i)
+                AlTraits::destroy(alloc, first + i);
+            AlByte(alloc).deallocate(raw, rawSize);
+        }
+        raw = nullptr;
+        first = nullptr;
+        rawSize = len = cap = 0;
+    }
+
+    const T* data() const noexcept {
+        return first;
+    }
+
+    size_type size() const noexcept {
+        return len;
+    }
+
+    Alloc get_allocator() const {
+        return alloc;
+    }
+
+    void swap(CacheAlignedArray& rhs) noexcept {
+        tiny_stl::swap(alloc, rhs.alloc);
+        tiny_stl::swap(raw, rhs.raw);
+        tiny_stl::swap(rawSize, rhs.rawSize);
+        tiny_stl::swap(first, rhs.first);
+        tiny_stl::swap(len, rhs.len);
+        tiny_stl::swap(cap, rhs.cap);
+    }
+
+    [[noreturn]] static void xLength() {
+        throw "search index too long";
+    }
+}; // class CacheAlignedArray<T, Alloc>
+
+template <typename T, typename Alloc>
+constexpr const typename CacheAlignedArray<T, Alloc>::size_type
+    CacheAlignedArray<T, Alloc>::kAlign;
+
+// Vector operations for the node search of s_tree. lessMask(a, b) has bit
+// i set if a[i] < b[i].
+template <typename T>
+struct SimdLanes : false_type {};
+
+#if defined(TINY_STL_AVX2)
+
+template <>
+struct SimdLanes<std::int32_t> : true_type {
+    using Vec = __m256i;
+    constexpr static const std::size_t kLanes = 8;
+
+    static Vec splat(std::int32_t x) noexcept {
+        return _mm256_set1_epi32(x);
+    }
+
+    static Vec load(const std::int32_t* p) noexcept {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+
+    static unsigned lessMask(Vec a, Vec b) noexcept {
+        return static_cast<unsigned>(
+            _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(b, a))));
+    }
+};
+
+template <>
+struct SimdLanes<std::int64_t> : true_type {
+    using Vec = __m256i;
+    constexpr static const std::size_t kLanes = 4;
+
+    static Vec splat(std::int64_t x) noexcept {
+        return _mm256_set1_epi64x(x);
+    }
+
+    static Vec load(const std::int64_t* p) noexcept {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+
+    static unsigned lessMask(Vec a, Vec b) noexcept {
+        return static_cast<unsigned>(
+            _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(b, a))));
+    }
+};
+
+template <>
+struct SimdLanes<float> : true_type {
+    using Vec = __m256;
+    constexpr static const std::size_t kLanes = 8;
+
+    static Vec splat(float x) noexcept {
+        return _mm256_set1_ps(x);
+    }
+
+    static Vec load(const float* p) noexcept {
+        return _mm256_loadu_ps(p);
+    }
+
+    static unsigned lessMask(Vec a, Vec b) noexcept {
+        return static_cast<unsigned>(
+            _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ)));
+    }
+};
+
+template <>
+struct SimdLanes<double> : true_type {
+    using Vec = __m256d;
+    constexpr static const std::size_t kLanes = 4;
+
+    static Vec splat(double x) noexcept {
+        return _mm256_set1_pd(x);
+    }
+
+    static Vec load(const double* p) noexcept {
+        return _mm256_loadu_pd(p);
+    }
+
+    static unsigned lessMask(Vec a, Vec b) noexcept {
+        return static_cast<unsigned>(
+            _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LT_OQ)));
+    }
+};
+
+#elif defined(TINY_STL_SSE2)
+
+template <>
+struct SimdLanes<std::int32_t> : true_type {
+    using Vec = __m128i;
+    constexpr static const std::size_t kLanes = 4;
+
+    static Vec splat(std::int32_t x) noexcept {
+        return _mm_set1_epi32(x);
+    }
+
+    static Vec load(const std::int32_t* p) noexcept {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+
+    static unsigned lessMask(Vec a, Vec b) noexcept {
+        return static_cast<unsigned>(
+            _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(b, a))));
+    }
+};
+
+template <>
+struct SimdLanes<float> : true_type {
+    using Vec = __m128;
+    constexpr static const std::size_t kLanes = 4;
+
+    static Vec splat(float x) noexcept {
+        return _mm_set1_ps(x);
+    }
+
+    static Vec load(const float* p) noexcept {
+        return _mm_loadu_ps(p);
+    }
+
+    static unsigned lessMask(Vec a, Vec b) noexcept {
+        return static_cast<unsigned>(_mm_movemask_ps(_mm_cmplt_ps(a, b)));
+    }
+};
+
+template <>
+struct SimdLanes<double> : true_type {
+    using Vec = __m128d;
+    constexpr static const std::size_t kLanes = 2;
+
+    static Vec splat(double x) noexcept {
+        return _mm_set1_pd(x);
+    }
+
+    static Vec load(const double* p) noexcept {
+        return _mm_loadu_pd(p);
+    }
+
+    static unsigned lessMask(Vec a, Vec b) noexcept {
+        return static_cast<unsigned>(_mm_movemask_pd(_mm_cmplt_pd(a, b)));
+    }
+};
+
+#endif // TINY_STL_AVX2
+
+template <typename T, typename Compare>
+struct IsSimdLess
+    : bool_constant<SimdLanes<T>::value &&
+                    (is_same<Compare, tiny_stl::less<T>>::value ||
+                     is_same<Compare, tiny_stl::less<>>::value)> {};
+
+// Number of the B keys of a node that are less than x (lower) or not
+// greater than x (upper). No branch depends on the keys. The keys of a
+// node are sorted, so the SIMD comparison masks are a run of ones from
+// bit 0 (lower) or to bit B - 1 (upper), and the count is a bit scan.
+template <typename T, typename Compare, std::size_t B,
+          bool = IsSimdLess<T, Compare>::value>
+struct STreeNodeRank {
+    static std::size_t lower(const T* node, const T& x, const Compare& cmp) {
+        std::size_t c = 0;
+        for (std::size_t i = 0; i < B; ++i)
+            c += static_cast<std::size_t>(cmp(node[i], x));
+        return c;
+    }
+
+    static std::size_t upper(const T* node, const T& x, const Compare& cmp) {
+        std::size_t c = 0;
+        for (std::size_t i = 0; i < B; ++i)
+            c += static_cast<std::size_t>(!cmp(x, node[i]));
+        return c;
+    }
+};
+
+template <typename T, typename Compare, std::size_t B>
+struct STreeNodeRank<T, Compare, B, true> {
+    using Lanes = SimdLanes<T>;
+
+    static_assert(B % Lanes::kLanes == 0 && B < kBitWordBits,
+                  "a node is a whole number of vectors");
+
+    static std::size_t lower(const T* node, const T& x, const Compare&) {
+        const auto xv = Lanes::splat(x);
+        BitWord mask = 0;
+        for (std::size_t i = 0; i < B; i += Lanes::kLanes)
+            mask |= static_cast<BitWord>(
+                        Lanes::lessMask(Lanes::load(node + i), xv))
+                    << i;
+        return countTrailingZeros(~mask);
+    }
+
+    static std::size_t upper(const T* node, const T& x, const Compare&) {
+        const auto xv = Lanes::splat(x);
+        BitWord mask = 0;
+        for (std::size_t i = 0; i < B; i += Lanes::kLanes)
+            mask |= static_cast<BitWord>(
+                        Lanes::lessMask(xv, Lanes::load(node + i)))
+                    << i;
+        return countTrailingZeros(mask | (static_cast<BitWord>(1) << B));
+    }
+};
+
+} // namespace details
+
+// Read-only index of a sorted sequence, laid out as an implicit binary
+// search tree in BFS order (the Eytzinger layout): the root is at 1 and
+// the children of k at 2k and 2k + 1. The first levels, which every search
+// goes through, share a few cache lines, and the descendants of k four
+// levels down (for 4-byte keys) are one cache line, which the search
+// prefetches while it compares the levels between. The search has no
+// branch that depends on the keys.
+//
+// lower_bound and upper_bound return the rank of the result in the sorted
+// sequence, it's computed from the position in the tree, so no rank array
+// is stored.
+template <typename T, typename Compare = tiny_stl::less<T>,
+          typename Alloc = allocator<T>>
+class eytzinger_index {
+public:
+    static_assert(tiny_stl::is_same_v<T, typename Alloc::value_type>,
+                  "Alloc::value_type is not the same as T");
+
+    using value_type = T;
+    using key_compare = Compare;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using const_reference = const T&;
+
+private:
+    // tree[k * kStride] begins the cache line of the descendants of k
+    // log2(kStride) levels down
+    constexpr static const size_type kStride =
+        details::floorPow2(TINY_STL_CACHE_LINE_SIZE / sizeof(T));
+
+    details::CacheAlignedArray<T, Alloc> tree; // tree[0] is a filler
+    Compare comp;
+    size_type len;
+    unsigned height; // floor(log2(len)) + 1
+
+private:
+    // rank of node k, the leftmost len nodes of a perfect tree with
+    // height levels are present
+    size_type rankOf(size_type k) const noexcept {
+        const unsigned depth = details::floorLog2(k);
+        const size_type pos = k - (static_cast<size_type>(1) << depth);
+        const size_type perfect = ((2 * pos + 1) << (height - 1 - depth)) - 1;
+        // the missing leaves are every other position from 2 * leaves
+        const size_type leaves =
+            len - ((static_cast<size_type>(1) << (height - 1)) - 1);
+        const size_type half = (perfect + 1) / 2;
+        return half > leaves ? perfect - (half - leaves) : perfect;
+    }
+
+    template <typename RanIter>
+    void build(RanIter first) {
+        tree.reset(len + 1);
+        tree.push_back(first[0]);
+        for (size_type k = 1; k <= len; ++k)
+            tree.push_back(first[static_cast<IterDiffType<RanIter>>(
+                rankOf(k))]);
+    }
+
+    // the first node whose key satisfies !pred, 0 if none does
+    template <typename Pred>
+    size_type search(Pred pred) const {
+        const T* keys = tree.data();
+        size_type k = 1;
+        while (k <= len) {
+            if (kStride > 1)
+                TINY_STL_PREFETCH(reinterpret_cast<const char*>(
+                    reinterpret_cast<std::uintptr_t>(keys) +
+                    k * kStride * sizeof(T)));
+            k = 2 * k + static_cast<size_type>(pred(keys[k]));
+        }
+        // the path turns left at the result and right ever since
+        return k >> (details::countTrailingZeros(~k) + 1);
+    }
+
+    size_type lowerNode(const T& x) const {
+        return search([&](const T& key) { return comp(key, x); });
+    }
+
+    size_type rankOrEnd(size_type k) const noexcept {
+        return k == 0 ? len : rankOf(k);
+    }
+
+public:
+    eytzinger_index() : eytzinger_index(Compare()) {
+    }
+
+    explicit eytzinger_index(const Compare& cmp, const Alloc& a = Alloc())
+        : tree(a), comp(cmp), len(0), height(0) {
+    }
+
+    // [first, last) is sorted by cmp
+    template <typename RanIter>
+    eytzinger_index(RanIter first, RanIter last,
+                    const Compare& cmp = Compare(), const Alloc& a = Alloc())
+        : eytzinger_index(cmp, a) {
+        TINY_STL_ASSERT_SORTED(first, last, comp);
+        len = static_cast<size_type>(last - first);
+        if (len != 0) {
+            height = details::floorLog2(len) + 1;
+            build(first);
+        }
+    }
+
+    template <typename VAlloc>
+    explicit eytzinger_index(const vector<T, VAlloc>& sorted,
+                             const Compare& cmp = Compare(),
+                             const Alloc& a = Alloc())
+        : eytzinger_index(sorted.begin(), sorted.end(), cmp, a) {
+    }
+
+    eytzinger_index(const eytzinger_index& rhs)
+        : eytzinger_index(rhs.comp,
+                          allocator_traits<Alloc>::
+                              select_on_container_copy_construction(
+                                  rhs.tree.get_allocator())) {
+        tree.reset(rhs.tree.size());
+        for (size_type k = 0; k < rhs.tree.size(); ++k)
+            tree.push_back(rhs.tree.data()[k]);
+        len = rhs.len;
+        height = rhs.height;
+    }
+
+    eytzinger_index(eytzinger_index&& rhs) noexcept
+        : tree(tiny_stl::move(rhs.tree)), comp(rhs.comp), len(rhs.len),
+          height(rhs.height) {
+        rhs.len = 0;
+        rhs.height = 0;
+    }
+
+    eytzinger_index& operator=(const eytzinger_index& rhs) {
+        if (this != &rhs) {
+            eytzinger_index tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    eytzinger_index& operator=(eytzinger_index&& rhs) noexcept {
+        if (this != &rhs) {
+            eytzinger_index tmp(tiny_stl::move(rhs));
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    allocator_type get_allocator() const {
+        return tree.get_allocator();
+    }
+
+    key_compare key_comp() const {
+        return comp;
+    }
+
+    size_type size() const noexcept {
+        return len;
+    }
+
+    bool empty() const noexcept {
+        return len == 0;
+    }
+
+    // rank of the first key not less than x, size() if none
+    size_type lower_bound(const T& x) const {
+        return rankOrEnd(lowerNode(x));
+    }
+
+    // rank of the first key greater than x, size() if none
+    size_type upper_bound(const T& x) const {
+        return rankOrEnd(
+            search([&](const T& key) { return !comp(x, key); }));
+    }
+
+    bool contains(const T& x) const {
+        const size_type k = lowerNode(x);
+        return k != 0 && !comp(x, tree.data()[k]);
+    }
+
+    size_type count(const T& x) const {
+        return upper_bound(x) - lower_bound(x);
+    }
+
+    void swap(eytzinger_index& rhs) noexcept {
+        tree.swap(rhs.tree);
+        tiny_stl::swap(comp, rhs.comp);
+        tiny_stl::swap(len, rhs.len);
+        tiny_stl::swap(height, rhs.height);
+    }
+}; // class eytzinger_index<T, Compare, Alloc>
+
+template <typename T, typename Compare, typename Alloc>
+constexpr const typename eytzinger_index<T, Compare, Alloc>::size_type
+    eytzinger_index<T, Compare, Alloc>::kStride;
+
+template <typename T, typename Compare, typename Alloc>
+inline void swap(eytzinger_index<T, Compare, Alloc>& lhs,
+                 eytzinger_index<T, Compare, Alloc>& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+// Static B+ tree over a sorted sequence (the S-tree). A node is B keys in
+// one cache line. Layer 0 is the sequence itself padded to whole nodes
+// with copies of the greatest key, and node j of every layer above has the
+// children j * (B + 1) + c in the layer below, key i being the first key
+// under child i + 1. A search reads one node per layer, and ranks x in a
+// node by counting the keys before it, with SIMD comparisons for int32_t,
+// int64_t (AVX2), float and double under less.
+//
+// The leaf it ends in is a block of the sorted sequence, so the result is
+// a rank, and operator[] gives the key of a rank.
+template <typename T, typename Compare = tiny_stl::less<T>,
+          typename Alloc = allocator<T>>
+class s_tree {
+public:
+    static_assert(tiny_stl::is_same_v<T, typename Alloc::value_type>,
+                  "Alloc::value_type is not the same as T");
+
+    using value_type = T;
+    using key_compare = Compare;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using const_reference = const T&;
+
+private:
+    constexpr static const size_type kNodeKeys =
+        TINY_STL_CACHE_LINE_SIZE / sizeof(T) > 2
+            ? TINY_STL_CACHE_LINE_SIZE / sizeof(T)
+            : 2;
+
+    constexpr static const size_type kMaxLayers = 64;
+
+    using NodeRank = details::STreeNodeRank<T, Compare, kNodeKeys>;
+
+    details::CacheAlignedArray<T, Alloc> keys;
+    Compare comp;
+    size_type len;
+    size_type layers;
+    size_type offsets[kMaxLayers]; // first key of every layer
+
+private:
+    template <typename RanIter>
+    void build(RanIter first) {
+        constexpr size_type B = kNodeKeys;
+        size_type nodes[kMaxLayers];
+        nodes[0] = (len + B - 1) / B;
+        layers = 1;
+        offsets[0] = 0;
+        while (nodes[layers - 1] > 1) {
+            nodes[layers] = (nodes[layers - 1] + B) / (B + 1);
+            offsets[layers] = offsets[layers - 1] + nodes[layers - 1] * B;
+            ++layers;
+        }
+
+        keys.reset(offsets[layers - 1] + nodes[layers - 1] * B);
+        for (size_type i = 0; i < len; ++i)
+            keys.push_back(first[static_cast<IterDiffType<RanIter>>(i)]);
+        const T* leaves = keys.data();
+        for (size_type i = len; i < nodes[0] * B; ++i)
+            keys.push_back(leaves[len - 1]);
+
+        // a node of layer l - 1 spans span leaves
+        size_type span = 1;
+        for (size_type l = 1; l < layers; ++l) {
+            for (size_type j = 0; j < nodes[l]; ++j) {
+                for (size_type i = 0; i < B; ++i) {
+                    const size_type leaf = (j * (B + 1) + i + 1) * span;
+                    keys.push_back(leaf < nodes[0] ? leaves[leaf * B]
+                                                   : leaves[len - 1]);
+                }
+            }
+            span *= B + 1;
+        }
+    }
+
+    template <typename Rank>
+    size_type search(Rank rank) const {
+        const T* base = keys.data();
+        size_type j = 0;
+        for (size_type l = layers - 1; l > 0; --l)
+            j = j * (kNodeKeys + 1) + rank(base + offsets[l] + j * kNodeKeys);
+        return j * kNodeKeys + rank(base + j * kNodeKeys);
+    }
+
+public:
+    s_tree() : s_tree(Compare()) {
+    }
+
+    explicit s_tree(const Compare& cmp, const Alloc& a = Alloc())
+        : keys(a), comp(cmp), len(0), layers(0) {
+    }
+
+    // [first, last) is sorted by cmp
+    template <typename RanIter>
+    s_tree(RanIter first, RanIter last, const Compare& cmp = Compare(),
+           const Alloc& a = Alloc())
+        : s_tree(cmp, a) {
+        TINY_STL_ASSERT_SORTED(first, last, comp);
+        len = static_cast<size_type>(last - first);
+        if (len != 0)
+            build(first);
+    }
+
+    template <typename VAlloc>
+    explicit s_tree(const vector<T, VAlloc>& sorted,
+                    const Compare& cmp = Compare(), const Alloc& a = Alloc())
+        : s_tree(sorted.begin(), sorted.end(), cmp, a) {
+    }
+
+    s_tree(const s_tree& rhs)
+        : s_tree(rhs.comp, allocator_traits<Alloc>::
+                               select_on_container_copy_construction(
+                                   rhs.keys.get_allocator())) {
+        keys.reset(rhs.keys.size());
+        for (size_type i = 0; i < rhs.keys.size(); ++i)
+            keys.push_back(rhs.keys.data()[i]);
+        len = rhs.len;
+        layers = rhs.layers;
+        tiny_stl::copy(rhs.offsets, rhs.offsets + layers, offsets);
+    }
+
+    s_tree(s_tree&& rhs) noexcept
+        : keys(tiny_stl::move(rhs.keys)), comp(rhs.comp), len(rhs.len),
+          layers(rhs.layers) {
+        tiny_stl::copy(rhs.offsets, rhs.offsets + layers, offsets);
+        rhs.len = 0;
+        rhs.layers = 0;
+    }
+
+    s_tree& operator=(const s_tree& rhs) {
+        if (this != &rhs) {
+            s_tree tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    s_tree& operator=(s_tree&& rhs) noexcept {
+        if (this != &rhs) {
+            s_tree tmp(tiny_stl::move(rhs));
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    allocator_type get_allocator() const {
+        return keys.get_allocator();
+    }
+
+    key_compare key_comp() const {
+        return comp;
+    }
+
+    size_type size() const noexcept {
+        return len;
+    }
+
+    bool empty() const noexcept {
+        return len == 0;
+    }
+
+    // the key of rank pos
+    const_reference operator[](size_type pos) const {
+        assert(pos < len);
+        return keys.data()[pos];
+    }
+
+    // rank of the first key not less than x, size() if none
+    size_type lower_bound(const T& x) const {
+        // past the greatest key the padding would lead out of the tree
+        if (len == 0 || comp(keys.data()[len - 1], x))
+            return len;
+        return search([&](const T* node) {
+            return NodeRank::lower(node, x, comp);
+        });
+    }
+
+    // rank of the first key greater than x, size() if none
+    size_type upper_bound(const T& x) const {
+        if (len == 0 || !comp(x, keys.data()[len - 1]))
+            return len;
+        return search([&](const T* node) {
+            return NodeRank::upper(node, x, comp);
+        });
+    }
+
+    bool contains(const T& x) const {
+        const size_type pos = lower_bound(x);
+        return pos != len && !comp(x, keys.data()[pos]);
+    }
+
+    size_type count(const T& x) const {
+        return upper_bound(x) - lower_bound(x);
+    }
+
+    void swap(s_tree& rhs) noexcept {
+        keys.swap(rhs.keys);
+        tiny_stl::swap(comp, rhs.comp);
+        tiny_stl::swap(len, rhs.len);
+        size_type tmp[kMaxLayers];
+        tiny_stl::copy(offsets, offsets + layers, tmp);
+        tiny_stl::copy(rhs.offsets, rhs.offsets + rhs.layers, offsets);
+        tiny_stl::copy(tmp, tmp + layers, rhs.offsets);
+        tiny_stl::swap(layers, rhs.layers);
+    }
+}; // class s_tree<T, Compare, Alloc>
+
+template <typename T, typename Compare, typename Alloc>
+constexpr const typename s_tree<T, Compare, Alloc>::size_type
+    s_tree<T, Compare, Alloc>::kNodeKeys;
+
+template <typename T, typename Compare, typename Alloc>
+constexpr const typename s_tree<T, Compare, Alloc>::size_type
+    s_tree<T, Compare, Alloc>::kMaxLayers;
+
+template <typename T, typename Compare, typename Alloc>
+inline void swap(s_tree<T, Compare, Alloc>& lhs,
+                 s_tree<T, Compare, Alloc>& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+} // namespace tiny_stl
@@ -0,0 +1,978 @@
+// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+
+#include "iterator.hpp"
+#include "utility.hpp"
+
+#if defined(TINY_STL_AVX2) || defined(TINY_STL_AVX2_DISPATCH)
+#include <immintrin.h>
+#elif defined(TINY_STL_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(TINY_STL_SSE2) && defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+// Vector kernels behind find, count, remove, unique, min_element, max_element
+// and minmax_element of algorithm.hpp, for contiguous ranges of arithmetic
+// values.
+// A kernel is written once against an Ops interface and instantiated for SSE2
+// and AVX2. Without -mavx2 the AVX2 copy is compiled with a target attribute
+// and picked at run time.
+
+namespace tiny_stl {
+
+namespace details {
+
+// Arithmetic types the kernels take: integers up to 64 bits except bool,
+// float and double.
+template <typename T>
+struct SimdElement
+#ifdef TINY_STL_SSE2
+    : bool_constant<(is_integral<T>::value && !is_same<T, bool>::value &&
+                     sizeof(T) <= 8) ||
+                    is_same<T, float>::value || is_same<T, double>::value> {
+};
+#else
+    : false_type {
+};
+#endif // TINY_STL_SSE2
+
+#ifdef TINY_STL_SSE2
+
+// index of the lowest / highest set bit, m != 0
+inline unsigned maskLowest(unsigned m) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctz(m));
+#else
+    unsigned long idx;
+    _BitScanForward(&idx, m);
+    return static_cast<unsigned>(idx);
+#endif
+}
+
+inline unsigned maskHighest(unsigned m) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return 31u - static_cast<unsigned>(__builtin_clz(m));
+#else
+    unsigned long idx;
+    _BitScanReverse(&idx, m);
+    return static_cast<unsigned>(idx);
+#endif
+}
+
+#ifdef TINY_STL_AVX2_DISPATCH
+// AVX2 usable by this process: the CPU has it and the OS saves YMM state
+inline bool cpuHasAvx2() noexcept {
+    static const bool has = [] {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+#else
+        int regs[4];
+        __cpuid(regs, 0);
+        if (regs[0] < 7)
+            return false;
+        __cpuid(regs, 1);
+        constexpr int kOsxsaveAvx = (1 << 27) | (1 << 28);
+        if ((regs[2] & kOsxsaveAvx) != kOsxsaveAvx || (_xgetbv(0) & 6) != 6)
+            return false;
+        __cpuidex(regs, 7, 0);
+        return (regs[1] & (1 << 5)) != 0;
+#endif
+    }();
+    return has;
+}
+#endif // TINY_STL_AVX2_DISPATCH
+
+// Instruction set layer: every value lives in an integer vector, masks have
+// all bits of a lane set, and byteMask() gives one bit per byte.
+struct Sse2Isa {
+    using Vec = __m128i;
+    static constexpr std::size_t kBytes = 16;
+    static constexpr bool kHasCompress32 = false; // no variable lane shuffle
+
+    static Vec loadBytes(const void* p) noexcept {
+        return _mm_loadu_si128(static_cast<const __m128i*>(p));
+    }
+
+    static void storeBytes(void* p, Vec v) noexcept {
+        _mm_storeu_si128(static_cast<__m128i*>(p), v);
+    }
+
+    static unsigned byteMask(Vec v) noexcept {
+        return static_cast<unsigned>(_mm_movemask_epi8(v));
+    }
+
+    static Vec zero() noexcept {
+        return _mm_setzero_si128();
+    }
+
+    static Vec orBits(Vec a, Vec b) noexcept {
+        return _mm_or_si128(a, b);
+    }
+
+    static Vec xorBits(Vec a, Vec b) noexcept {
+        return _mm_xor_si128(a, b);
+    }
+
+    // m ? a : b per lane
+    static Vec select(Vec m, Vec a, Vec b) noexcept {
+        return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b));
+    }
+
+    static Vec subBytes(Vec a, Vec b) noexcept {
+        return _mm_sub_epi8(a, b);
+    }
+
+    // sum of all bytes, at most 16 * 255 so 16 bit halves do
+    static std::size_t sumBytes(Vec v) noexcept {
+        const Vec s = _mm_sad_epu8(v, _mm_setzero_si128());
+        return static_cast<std::size_t>(_mm_extract_epi16(s, 0)) +
+               static_cast<std::size_t>(_mm_extract_epi16(s, 4));
+    }
+};
+
+// Integer lanes of one width: splat, eq, the signed min / max, and the
+// unordered() / flipSign() the kernels share with the floating lanes.
+// kHasLess is false where the instruction set has no signed compare.
+template <typename Isa, std::size_t Bytes>
+struct SimdIntLanes;
+
+template <>
+struct SimdIntLanes<Sse2Isa, 1> {
+    using Vec = __m128i;
+    static constexpr bool kHasLess = true;
+
+    static Vec splat(std::int8_t x) noexcept {
+        return _mm_set1_epi8(static_cast<char>(x));
+    }
+
+    static Vec eq(Vec a, Vec b) noexcept {
+        return _mm_cmpeq_epi8(a, b);
+    }
+
+    static Vec gt(Vec a, Vec b) noexcept {
+        return _mm_cmpgt_epi8(a, b);
+    }
+
+    static Vec min(Vec a, Vec b) noexcept {
+        return Sse2Isa::select(gt(b, a), a, b);
+    }
+
+    static Vec max(Vec a, Vec b) noexcept {
+        return Sse2Isa::select(gt(a, b), a, b);
+    }
+
+    static Vec unordered(Vec) noexcept {
+        return Sse2Isa::zero();
+    }
+
+    static Vec flipSign(Vec v) noexcept {
+        return _mm_xor_si128(v, splat(INT8_MIN));
+    }
+};
+
+template <>
+struct SimdIntLanes<Sse2Isa, 2> {
+    using Vec = __m128i;
+    static constexpr bool kHasLess = true;
+
+    static Vec splat(std::int16_t x) noexcept {
+        return _mm_set1_epi16(x);
+    }
+
+    static Vec eq(Vec a, Vec b) noexcept {
+        return _mm_cmpeq_epi16(a, b);
+    }
+
+    static Vec gt(Vec a, Vec b) noexcept {
+        return _mm_cmpgt_epi16(a, b);
+    }
+
+    static Vec min(Vec a, Vec b) noexcept {
+        return _mm_min_epi16(a, b);
+    }
+
+    static Vec max(Vec a, Vec b) noexcept {
+        return _mm_max_epi16(a, b);
+    }
+
+    static Vec unordered(Vec) noexcept {
+        return Sse2Isa::zero();
+    }
+
+    static Vec flipSign(Vec v) noexcept {
+        return _mm_xor_si128(v, splat(INT16_MIN));
+    }
+};
+
+template <>
+struct SimdIntLanes<Sse2Isa, 4> {
+    using Vec = __m128i;
+    static constexpr bool kHasLess = true;
+
+    static Vec splat(std::int32_t x) noexcept {
+        return _mm_set1_epi32(x);
+    }
+
+    static Vec eq(Vec a, Vec b) noexcept {
+        return _mm_cmpeq_epi32(a, b);
+    }
+
+    static Vec gt(Vec a, Vec b) noexcept {
+        return _mm_cmpgt_epi32(a, b);
+    }
+
+    static Vec min(Vec a, Vec b) noexcept {
+        return Sse2Isa::select(gt(b, a), a, b);
+    }
+
+    static Vec max(Vec a, Vec b) noexcept {
+        return Sse2Isa::select(gt(a, b), a, b);
+    }
+
+    static Vec unordered(Vec) noexcept {
+        return Sse2Isa::zero();
+    }
+
+    static Vec flipSign(Vec v) noexcept {
+        return _mm_xor_si128(v, splat(INT32_MIN));
+    }
+};
+
+template <>
+struct SimdIntLanes<Sse2Isa, 8> {
+    using Vec = __m128i;
+    static constexpr bool kHasLess = false; // pcmpgtq is SSE4.2
+
+    static Vec splat(std::int64_t x) noexcept {
+        return _mm_set1_epi64x(x);
+    }
+
+    // both 32 bit halves equal
+    static Vec eq(Vec a, Vec b) noexcept {
+        const Vec e = _mm_cmpeq_epi32(a, b);
+        return _mm_and_si128(e, _mm_shuffle_epi32(e, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+};
+
+template <typename Isa, typename T>
+struct SimdFloatLanes;
+
+template <>
+struct SimdFloatLanes<Sse2Isa, float> {
+    using Vec = __m128i;
+
+    static Vec splat(float x) noexcept {
+        return _mm_castps_si128(_mm_set1_ps(x));
+    }
+
+    static Vec eq(Vec a, Vec b) noexcept {
+        return _mm_castps_si128(
+            _mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+    }
+
+    static Vec unordered(Vec a) noexcept {
+        const __m128 x = _mm_castsi128_ps(a);
+        return _mm_castps_si128(_mm_cmpunord_ps(x, x));
+    }
+
+    // b where either is NaN
+    static Vec min(Vec a, Vec b) noexcept {
+        return _mm_castps_si128(
+            _mm_min_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+    }
+
+    static Vec max(Vec a, Vec b) noexcept {
+        return _mm_castps_si128(
+            _mm_max_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+    }
+
+    static Vec flipSign(Vec v) noexcept {
+        return v;
+    }
+};
+
+template <>
+struct SimdFloatLanes<Sse2Isa, double> {
+    using Vec = __m128i;
+
+    static Vec splat(double x) noexcept {
+        return _mm_castpd_si128(_mm_set1_pd(x));
+    }
+
+    static Vec eq(Vec a, Vec b) noexcept {
+        return _mm_castpd_si128(
+            _mm_cmpeq_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+    }
+
+    static Vec unordered(Vec a) noexcept {
+        const __m128d x = _mm_castsi128_pd(a);
+        return _mm_castpd_si128(_mm_cmpunord_pd(x, x));
+    }
+
+    static Vec min(Vec a, Vec b) noexcept {
+        return _mm_castpd_si128(
+            _mm_min_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+    }
+
+    static Vec max(Vec a, Vec b) noexcept {
+        return _mm_castpd_si128(
+            _mm_max_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+    }
+
+    static Vec flipSign(Vec v) noexcept {
+        return v;
+    }
+};
+
+#if defined(TINY_STL_AVX2) || defined(TINY_STL_AVX2_DISPATCH)
+
+// For each mask of 8 lanes, the indices of the set lanes in 3 bit fields
+// from the lowest, and their number in the top byte.
+struct CompressTable {
+    std::uint32_t entry[256];
+
+    constexpr CompressTable() : entry() {
+        for (unsigned m = 0; m < 256; ++m) {
+            std::uint32_t e = 0;
+            unsigned k = 0;
+            for (unsigned i = 0; i < 8; ++i) {
+                if (m & (1u << i))
+                    e |= i << (3 * k++);
+            }
+            entry[m] = e | (k << 24);
+        }
+    }
+};
+
+inline const std::uint32_t* compressTable() noexcept {
+    static constexpr CompressTable table{};
+    return table.entry;
+}
+
+struct Avx2Isa {
+    using Vec = __m256i;
+    static constexpr std::size_t kBytes = 32;
+    static constexpr bool kHasCompress32 = true;
+
+    TINY_STL_TARGET_AVX2 static Vec loadBytes(const void* p) noexcept {
+        return _mm256_loadu_si256(static_cast<const __m256i*>(p));
+    }
+
+    TINY_STL_TARGET_AVX2 static void storeBytes(void* p, Vec v) noexcept {
+        _mm256_storeu_si256(static_cast<__m256i*>(p), v);
+    }
+
+    TINY_STL_TARGET_AVX2 static unsigned byteMask(Vec v) noexcept {
+        return static_cast<unsigned>(_mm256_movemask_epi8(v));
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec zero() noexcept {
+        return _mm256_setzero_si256();
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec orBits(Vec a, Vec b) noexcept {
+        return _mm256_or_si256(a, b);
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec xorBits(Vec a, Vec b) noexcept {
+        return _mm256_xor_si256(a, b);
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec select(Vec m, Vec a, Vec b) noexcept {
+        return _mm256_blendv_epi8(b, a, m);
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec subBytes(Vec a, Vec b) noexcept {
+        return _mm256_sub_epi8(a, b);
+    }
+
+    TINY_STL_TARGET_AVX2 static std::size_t sumBytes(Vec v) noexcept {
+        const Vec s = _mm256_sad_epu8(v, _mm256_setzero_si256());
+        const __m128i t = _mm_add_epi64(_mm256_castsi256_si128(s),
+                                        _mm256_extracti128_si256(s, 1));
+        return static_cast<std::size_t>(_mm_extract_epi16(t, 0)) +
+               static_cast<std::size_t>(_mm_extract_epi16(t, 4));
+    }
+
+    // one bit per 32 bit lane
+    TINY_STL_TARGET_AVX2 static unsigned laneMask32(Vec v) noexcept {
+        return static_cast<unsigned>(
+            _mm256_movemask_ps(_mm256_castsi256_ps(v)));
+    }
+
+    // store the 32 bit lanes of v set in m to p, in order and followed by
+    // junk up to a whole vector, and return their number
+    TINY_STL_TARGET_AVX2 static unsigned compressStore32(void* p, Vec v,
+                                                         unsigned m) noexcept {
+        const std::uint32_t e = compressTable()[m];
+        const Vec idx =
+            _mm256_srlv_epi32(_mm256_set1_epi32(static_cast<int>(e)),
+                              _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21));
+        storeBytes(p, _mm256_permutevar8x32_epi32(v, idx));
+        return e >> 24;
+    }
+};
+
+template <>
+struct SimdIntLanes<Avx2Isa, 1> {
+    using Vec = __m256i;
+    static constexpr bool kHasLess = true;
+
+    TINY_STL_TARGET_AVX2 static Vec splat(std::int8_t x) noexcept {
+        return _mm256_set1_epi8(static_cast<char>(x));
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec eq(Vec a, Vec b) noexcept {
+        return _mm256_cmpeq_epi8(a, b);
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec min(Vec a, Vec b) noexcept {
+        return _mm256_min_epi8(a, b);
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec max(Vec a, Vec b) noexcept {
+        return _mm256_max_epi8(a, b);
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec unordered(Vec) noexcept {
+        return Avx2Isa::zero();
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec flipSign(Vec v) noexcept {
+        return _mm256_xor_si256(v, splat(INT8_MIN));
+    }
+};
+
+template <>
+struct SimdIntLanes<Avx2Isa, 2> {
+    using Vec = __m256i;
+    static constexpr bool kHasLess = true;
+
+    TINY_STL_TARGET_AVX2 static Vec splat(std::int16_t x) noexcept {
+        return _mm256_set1_epi16(x);
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec eq(Vec a, Vec b) noexcept {
+        return _mm256_cmpeq_epi16(a, b);
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec min(Vec a, Vec b) noexcept {
+        return _mm256_min_epi16(a, b);
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec max(Vec a, Vec b) noexcept {
+        return _mm256_max_epi16(a, b);
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec unordered(Vec) noexcept {
+        return Avx2Isa::zero();
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec flipSign(Vec v) noexcept {
+        return _mm256_xor_si256(v, splat(INT16_MIN));
+    }
+};
+
+template <>
+struct SimdIntLanes<Avx2Isa, 4> {
+    using Vec = __m256i;
+    static constexpr bool kHasLess = true;
+
+    TINY_STL_TARGET_AVX2 static Vec splat(std::int32_t x) noexcept {
+        return _mm256_set1_epi32(x);
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec eq(Vec a, Vec b) noexcept {
+        return _mm256_cmpeq_epi32(a, b);
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec min(Vec a, Vec b) noexcept {
+        return _mm256_min_epi32(a, b);
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec max(Vec a, Vec b) noexcept {
+        return _mm256_max_epi32(a, b);
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec unordered(Vec) noexcept {
+        return Avx2Isa::zero();
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec flipSign(Vec v) noexcept {
+        return _mm256_xor_si256(v, splat(INT32_MIN));
+    }
+};
+
+template <>
+struct SimdIntLanes<Avx2Isa, 8> {
+    using Vec = __m256i;
+    static constexpr bool kHasLess = true;
+
+    TINY_STL_TARGET_AVX2 static Vec splat(std::int64_t x) noexcept {
+        return _mm256_set1_epi64x(x);
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec eq(Vec a, Vec b) noexcept {
+        return _mm256_cmpeq_epi64(a, b);
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec min(Vec a, Vec b) noexcept {
+        return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(b, a));
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec max(Vec a, Vec b) noexcept {
+        return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b));
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec unordered(Vec) noexcept {
+        return Avx2Isa::zero();
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec flipSign(Vec v) noexcept {
+        return _mm256_xor_si256(v, splat(INT64_MIN));
+    }
+};
+
+template <>
+struct SimdFloatLanes<Avx2Isa, float> {
+    using Vec = __m256i;
+
+    TINY_STL_TARGET_AVX2 static Vec splat(float x) noexcept {
+        return _mm256_castps_si256(_mm256_set1_ps(x));
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec eq(Vec a, Vec b) noexcept {
+        return _mm256_castps_si256(_mm256_cmp_ps(
+            _mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_EQ_OQ));
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec unordered(Vec a) noexcept {
+        const __m256 x = _mm256_castsi256_ps(a);
+        return _mm256_castps_si256(_mm256_cmp_ps(x, x, _CMP_UNORD_Q));
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec min(Vec a, Vec b) noexcept {
+        return _mm256_castps_si256(
+            _mm256_min_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec max(Vec a, Vec b) noexcept {
+        return _mm256_castps_si256(
+            _mm256_max_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec flipSign(Vec v) noexcept {
+        return v;
+    }
+};
+
+template <>
+struct SimdFloatLanes<Avx2Isa, double> {
+    using Vec = __m256i;
+
+    TINY_STL_TARGET_AVX2 static Vec splat(double x) noexcept {
+        return _mm256_castpd_si256(_mm256_set1_pd(x));
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec eq(Vec a, Vec b) noexcept {
+        return _mm256_castpd_si256(_mm256_cmp_pd(
+            _mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_EQ_OQ));
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec unordered(Vec a) noexcept {
+        const __m256d x = _mm256_castsi256_pd(a);
+        return _mm256_castpd_si256(_mm256_cmp_pd(x, x, _CMP_UNORD_Q));
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec min(Vec a, Vec b) noexcept {
+        return _mm256_castpd_si256(
+            _mm256_min_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b)));
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec max(Vec a, Vec b) noexcept {
+        return _mm256_castpd_si256(
+            _mm256_max_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b)));
+    }
+
+    TINY_STL_TARGET_AVX2 static Vec flipSign(Vec v) noexcept {
+        return v;
+    }
+};
+
+#endif // TINY_STL_AVX2 || TINY_STL_AVX2_DISPATCH
+
+// Element layer seen by the kernels, the lanes of T's kind. Unsigned values
+// are ordered by the signed min / max after flipSign(), flipping it again
+// gives them back. kHasCompress tells that T is made of whole 32 bit lanes,
+// which the instruction set can pack with compressStore32().
+template <typename Isa, typename T, bool = is_floating_point<T>::value>
+struct SimdOps : Isa, SimdIntLanes<Isa, sizeof(T)> {
+    static constexpr bool kFlipSign = !is_signed<T>::value;
+    static constexpr bool kHasCompress = Isa::kHasCompress32 && sizeof(T) >= 4;
+};
+
+template <typename Isa, typename T>
+struct SimdOps<Isa, T, true> : Isa, SimdFloatLanes<Isa, T> {
+    static constexpr bool kHasLess = true;
+    static constexpr bool kFlipSign = false;
+    static constexpr bool kHasCompress = Isa::kHasCompress32;
+};
+
+// Kernels. Each run() is inlined into the entry point of its instruction set,
+// so it is compiled with that entry point's target.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+// first element equal to val, or last
+struct SimdFind {
+    template <typename Ops, typename T>
+    TINY_STL_FORCE_INLINE static const T* run(const T* first, const T* last,
+                                             T val) noexcept {
+        constexpr std::ptrdiff_t kLanes = Ops::kBytes / sizeof(T);
+        const T* const begin = first;
+        const auto v = Ops::splat(val);
+
+        for (; last - first >= 4 * kLanes; first += 4 * kLanes) {
+            const auto e0 = Ops::eq(Ops::loadBytes(first), v);
+            const auto e1 = Ops::eq(Ops::loadBytes(first + kLanes), v);
+            const auto e2 = Ops::eq(Ops::loadBytes(first + 2 * kLanes), v);
+            const auto e3 = Ops::eq(Ops::loadBytes(first + 3 * kLanes), v);
+            const auto any = Ops::orBits(Ops::orBits(e0, e1),
+                                         Ops::orBits(e2, e3));
+            if (Ops::byteMask(any) != 0) {
+                unsigned m = Ops::byteMask(e0);
+                if (m != 0)
+                    return first + maskLowest(m) / sizeof(T);
+                m = Ops::byteMask(e1);
+                if (m != 0)
+                    return first + kLanes + maskLowest(m) / sizeof(T);
+                m = Ops::byteMask(e2);
+                if (m != 0)
+                    return first + 2 * kLanes + maskLowest(m) / sizeof(T);
+                m = Ops::byteMask(e3);
+                return first + 3 * kLanes + maskLowest(m) / sizeof(T);
+            }
+        }
+
+        for (; last - first >= kLanes; first += kLanes) {
+            const unsigned m = Ops::byteMask(Ops::eq(Ops::loadBytes(first), v));
+            if (m != 0)
+                return first + maskLowest(m) / sizeof(T);
+        }
+
+        if (first == last)
+            return last;
+
+        // the tail rereads checked elements instead of looping on scalars
+        if (last - begin >= kLanes) {
+            const T* const p = last - kLanes;
+            const unsigned m = Ops::byteMask(Ops::eq(Ops::loadBytes(p), v));
+            return m != 0 ? p + maskLowest(m) / sizeof(T) : last;
+        }
+
+        for (; first != last; ++first) {
+            if (*first == val)
+                break;
+        }
+
+        return first;
+    }
+};
+
+// last element equal to val, or last
+struct SimdFindLast {
+    template <typename Ops, typename T>
+    TINY_STL_FORCE_INLINE static const T* run(const T* first, const T* last,
+                                             T val) noexcept {
+        constexpr std::ptrdiff_t kLanes = Ops::kBytes / sizeof(T);
+        const auto v = Ops::splat(val);
+
+        for (const T* p = last; p - first >= kLanes;) {
+            p -= kLanes;
+            const unsigned m = Ops::byteMask(Ops::eq(Ops::loadBytes(p), v));
+            if (m != 0)
+                return p + maskHighest(m) / sizeof(T);
+        }
+
+        for (const T* p = first + (last - first) % kLanes; p != first;) {
+            if (*--p == val)
+                return p;
+        }
+
+        return last;
+    }
+};
+
+struct SimdCount {
+    template <typename Ops, typename T>
+    TINY_STL_FORCE_INLINE static std::size_t run(const T* first, const T* last,
+                                                T val) noexcept {
+        constexpr std::ptrdiff_t kLanes = Ops::kBytes / sizeof(T);
+        const auto v = Ops::splat(val);
+        std::size_t bytes = 0;
+
+        // each match subtracts -1 from all bytes of its lane, so the byte
+        // counters are summed before 256 vectors can wrap them
+        while (last - first >= kLanes) {
+            std::ptrdiff_t n = (last - first) / kLanes;
+            n = n < 255 ? n : 255;
+            auto acc = Ops::zero();
+            for (; n > 0; --n, first += kLanes)
+                acc = Ops::subBytes(acc, Ops::eq(Ops::loadBytes(first), v));
+            bytes += Ops::sumBytes(acc);
+        }
+
+        std::size_t cnt = bytes / sizeof(T);
+        for (; first != last; ++first)
+            cnt += *first == val ? 1 : 0;
+
+        return cnt;
+    }
+};
+
+// Moves the elements of [first, last) that are kept to its front, in order,
+// and returns their end. Without Unique the elements unequal to val are kept,
+// with it those unequal to the element before them, which for == drops the
+// same elements as comparing with the last one kept.
+template <bool Unique>
+struct SimdCompress {
+    template <typename Ops, typename T>
+    TINY_STL_FORCE_INLINE static T* run(T* first, T* last, T val) noexcept {
+        if (first == last)
+            return last;
+
+        T* p = Unique ? first + 1 : first;
+        return run<Ops>(p, last, val, bool_constant<Ops::kHasCompress>{});
+    }
+
+private:
+    template <typename Ops, typename T>
+    TINY_STL_FORCE_INLINE static T* run(T* p, T* last, T val,
+                                        true_type) noexcept {
+        constexpr std::ptrdiff_t kLanes = Ops::kBytes / sizeof(T);
+        constexpr unsigned kAll = (1u << Ops::kBytes / 4) - 1;
+        const auto v = Ops::splat(val);
+
+        // nothing moves before the first dropped element
+        for (; last - p >= kLanes; p += kLanes) {
+            const auto x = Ops::loadBytes(p);
+            if (dropMask<Ops>(p, x, v) != 0)
+                break;
+        }
+        p = skipKept(p, last, val);
+        if (p == last)
+            return last;
+
+        // out stays behind p, so a whole vector stored at out only covers
+        // elements already read and leaves p[-1] as it was
+        T* out = p++;
+        for (; last - p >= kLanes; p += kLanes) {
+            const auto x = Ops::loadBytes(p);
+            const unsigned n =
+                Ops::compressStore32(out, x, dropMask<Ops>(p, x, v) ^ kAll);
+            out += n * 4 / sizeof(T);
+        }
+
+        return compactTail(out, p, last, val);
+    }
+
+    template <typename Ops, typename T>
+    TINY_STL_FORCE_INLINE static T* run(T* p, T* last, T val,
+                                        false_type) noexcept {
+        p = skipKept(p, last, val);
+        if (p == last)
+            return last;
+
+        T* out = p++;
+        return compactTail(out, p, last, val);
+    }
+
+    // lanes of x equal to what drops them, x is loaded from p
+    template <typename Ops, typename T, typename Vec>
+    TINY_STL_FORCE_INLINE static unsigned dropMask(const T* p, const Vec& x,
+                                                   const Vec& v) noexcept {
+        return Ops::laneMask32(Ops::eq(x, Unique ? Ops::loadBytes(p - 1) : v));
+    }
+
+    template <typename T>
+    TINY_STL_FORCE_INLINE static T* skipKept(T* p, T* last, T val) noexcept {
+        for (; p != last; ++p) {
+            if (*p == (Unique ? p[-1] : val))
+                break;
+        }
+
+        return p;
+    }
+
+    // every element is written and out only moves past those kept
+    template <typename T>
+    TINY_STL_FORCE_INLINE static T* compactTail(T* out, T* p, T* last,
+                                                T val) noexcept {
+        T prev = p[-1];
+        for (; p != last; ++p) {
+            const T x = *p;
+            *out = x;
+            out += x == (Unique ? prev : val) ? 0 : 1;
+            prev = x;
+        }
+
+        return out;
+    }
+};
+
+// Smallest and / or largest value of a nonempty range. NaNs are skipped, as
+// the accumulators start at *first and min(x, acc) keeps acc for a NaN x.
+// Returns false if CheckNan and the range holds a NaN.
+template <bool Lo, bool Hi, bool CheckNan>
+struct SimdBounds {
+    template <typename Ops, typename T>
+    TINY_STL_FORCE_INLINE static bool run(const T* first, const T* last,
+                                         T* lo, T* hi) noexcept {
+        return run<Ops>(first, last, lo, hi, bool_constant<Ops::kHasLess>{});
+    }
+
+private:
+    // four accumulators each, to hide the latency of min / max
+    template <typename Ops, typename T>
+    TINY_STL_FORCE_INLINE static bool run(const T* first, const T* last,
+                                         T* lo, T* hi, true_type) noexcept {
+        constexpr std::ptrdiff_t kLanes = Ops::kBytes / sizeof(T);
+        auto seed = Ops::splat(*first);
+        if (Ops::kFlipSign)
+            seed = Ops::flipSign(seed);
+        auto lo0 = seed, lo1 = seed, lo2 = seed, lo3 = seed;
+        auto hi0 = seed, hi1 = seed, hi2 = seed, hi3 = seed;
+        auto nan = Ops::zero();
+
+        for (; last - first >= 4 * kLanes; first += 4 * kLanes) {
+            step<Ops>(first, lo0, hi0, nan);
+            step<Ops>(first + kLanes, lo1, hi1, nan);
+            step<Ops>(first + 2 * kLanes, lo2, hi2, nan);
+            step<Ops>(first + 3 * kLanes, lo3, hi3, nan);
+        }
+
+        for (; last - first >= kLanes; first += kLanes)
+            step<Ops>(first, lo0, hi0, nan);
+
+        if (CheckNan && Ops::byteMask(nan) != 0)
+            return false;
+
+        T lanes[kLanes];
+        if (Lo) {
+            const auto v = Ops::min(Ops::min(lo0, lo1), Ops::min(lo2, lo3));
+            Ops::storeBytes(lanes, Ops::kFlipSign ? Ops::flipSign(v) : v);
+            T m = lanes[0];
+            for (std::ptrdiff_t i = 1; i < kLanes; ++i)
+                m = lanes[i] < m ? lanes[i] : m;
+            for (const T* p = first; p != last; ++p)
+                m = *p < m ? *p : m;
+            *lo = m;
+        }
+
+        if (Hi) {
+            const auto v = Ops::max(Ops::max(hi0, hi1), Ops::max(hi2, hi3));
+            Ops::storeBytes(lanes, Ops::kFlipSign ? Ops::flipSign(v) : v);
+            T m = lanes[0];
+            for (std::ptrdiff_t i = 1; i < kLanes; ++i)
+                m = m < lanes[i] ? lanes[i] : m;
+            for (const T* p = first; p != last; ++p)
+                m = m < *p ? *p : m;
+            *hi = m;
+        }
+
+        if (CheckNan) {
+            for (; first != last; ++first) {
+                if (*first != *first)
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    template <typename Ops, typename T, typename Vec>
+    TINY_STL_FORCE_INLINE static void step(const T* p, Vec& lo, Vec& hi,
+                                           Vec& nan) noexcept {
+        const auto x = Ops::loadBytes(p);
+        const auto k = Ops::kFlipSign ? Ops::flipSign(x) : x;
+        if (Lo)
+            lo = Ops::min(k, lo);
+        if (Hi)
+            hi = Ops::max(k, hi);
+        if (CheckNan)
+            nan = Ops::orBits(nan, Ops::unordered(x));
+    }
+
+    // no vector compare for T, only floating T has NaNs to check
+    template <typename Ops, typename T>
+    TINY_STL_FORCE_INLINE static bool run(const T* first, const T* last,
+                                         T* lo, T* hi, false_type) noexcept {
+        T l = *first;
+        T h = *first;
+        for (++first; first != last; ++first) {
+            l = *first < l ? *first : l;
+            h = h < *first ? *first : h;
+        }
+
+        if (Lo)
+            *lo = l;
+        if (Hi)
+            *hi = h;
+
+        return true;
+    }
+};
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+// Entry points, one per instruction set, and the dispatcher.
+template <typename Kernel, typename T, typename... Args>
+inline auto simdRunSse2(Args... args) noexcept {
+    return Kernel::template run<SimdOps<Sse2Isa, T>>(args...);
+}
+
+#if defined(TINY_STL_AVX2) || defined(TINY_STL_AVX2_DISPATCH)
+template <typename Kernel, typename T, typename... Args>
+TINY_STL_TARGET_AVX2 inline auto simdRunAvx2(Args... args) noexcept {
+    return Kernel::template run<SimdOps<Avx2Isa, T>>(args...);
+}
+#endif // TINY_STL_AVX2 || TINY_STL_AVX2_DISPATCH
+
+template <typename Kernel, typename T, typename... Args>
+inline auto simdRun(Args... args) noexcept {
+#if defined(TINY_STL_AVX2)
+    return simdRunAvx2<Kernel, T>(args...);
+#else
+#ifdef TINY_STL_AVX2_DISPATCH
+    if (cpuHasAvx2())
+        return simdRunAvx2<Kernel, T>(args...);
+#endif // TINY_STL_AVX2_DISPATCH
+    return simdRunSse2<Kernel, T>(args...);
+#endif // TINY_STL_AVX2
+}
+
+#endif // TINY_STL_SSE2
+
+// contiguous ranges the kernels take
+template <typename Iter, typename V = remove_cv_t<IteratorValueType<Iter>>>
+struct IsSimdRange : conjunction<IsContiguousIterator<Iter>, SimdElement<V>> {
+};
+
+} // namespace details
+
+} // namespace tiny_stl
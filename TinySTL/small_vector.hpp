@@ -0,0 +1,904 @@
+// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include "vector.hpp"
+
+namespace tiny_stl {
+
+// vector that keeps up to N elements inside the object and only goes to the
+// allocator once it outgrows them.
+// Iterators are the ones of vector, and the interface follows vector.
+template <typename T, std::size_t N, typename Alloc = allocator<T>>
+class small_vector {
+public:
+    static_assert(tiny_stl::is_same_v<T, typename Alloc::value_type>,
+                  "Alloc::value_type is not the same as T");
+    static_assert(N > 0, "small_vector needs at least one inline element");
+
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = typename Alloc::size_type;
+    using difference_type = typename Alloc::difference_type;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = VectorIterator<T>;
+    using const_iterator = VectorConstIterator<T>;
+    using reverse_iterator = tiny_stl::reverse_iterator<iterator>;
+    using const_reverse_iterator = tiny_stl::reverse_iterator<const_iterator>;
+
+private:
+    allocator_type alloc;
+
+    T* first;
+    T* last;
+    T* end_of_storage;
+
+    alignas(T) unsigned char buffer[sizeof(T) * N];
+
+    // a bitwise copy is a valid move + destroy when T is trivially copyable
+    // and the allocator does not hook construct
+    using UseMemcpyRelocate =
+        typename conjunction<is_trivially_copyable<T>,
+                             UseDefaultConstruct<Alloc, T*, T&&>>::type;
+
+private:
+    pointer inlineBuffer() noexcept {
+        return reinterpret_cast<pointer>(buffer);
+    }
+
+    const_pointer inlineBuffer() const noexcept {
+        return reinterpret_cast<const_pointer>(buffer);
+    }
+
+    bool isInline() const noexcept {
+        return this->first == inlineBuffer();
+    }
+
+    void resetInline() noexcept {
+        this->first = inlineBuffer();
+        this->last = this->first;
+        this->end_of_storage = this->first + N;
+    }
+
+    pointer allocateAux(size_type n) {
+        if (n > max_size())
+            xLength();
+
+        return this->alloc.allocate(n);
+    }
+
+    // only allocate, the object must be empty and inline
+    void allocAux(size_type newCapacity) {
+        if (newCapacity <= N)
+            return;
+
+        this->first = allocateAux(newCapacity);
+        this->last = this->first;
+        this->end_of_storage = this->first + newCapacity;
+    }
+
+    void releaseHeap() noexcept {
+        if (!isInline())
+            this->alloc.deallocate(this->first, capacity());
+    }
+
+    // destroy elements, give back the heap block and fall back to inline
+    void tidy() noexcept {
+        destroyAllocRange(this->first, this->last, this->alloc);
+        releaseHeap();
+        resetInline();
+    }
+
+    // construct
+    pointer fillHelper(pointer dest, size_type count, const_reference val) {
+        return uninitializedAllocFillN(dest, count, val, this->alloc);
+    }
+
+    // default construct
+    pointer defaultConstruct(pointer dest, size_type count) {
+        return uninitializedAllocDefaultN(dest, count, this->alloc);
+    }
+
+    pointer moveAux(pointer xfirst, pointer xlast, pointer newFirst) {
+        return uninitializedAllocMove(xfirst, xlast, newFirst, this->alloc);
+    }
+
+    template <typename Iter>
+    pointer copyAux(Iter xfirst, Iter xlast, pointer newFirst) {
+        return uninitializedAllocCopy(xfirst, xlast, newFirst, this->alloc);
+    }
+
+    // move construct
+    void moveOrCopyAux(pointer xfirst, pointer xlast, pointer newFirst,
+                       true_type) {
+        uninitializedAllocMove(xfirst, xlast, newFirst, this->alloc);
+    }
+
+    // copy construct, the copies made so far are destroyed if one throws
+    void moveOrCopyAux(pointer xfirst, pointer xlast, pointer newFirst,
+                       false_type) {
+        pointer cur = newFirst;
+        try {
+            for (; xfirst != xlast; ++xfirst, ++cur)
+                allocator_traits<Alloc>::construct(this->alloc, cur, *xfirst);
+        } catch (...) {
+            destroyAllocRange(newFirst, cur, this->alloc);
+            throw;
+        }
+    }
+
+    void moveOrCopy(pointer xfirst, pointer xlast, pointer newFirst) {
+        moveOrCopyAux(xfirst, xlast, newFirst,
+                      typename tiny_stl::disjunction<
+                          is_nothrow_move_constructible<T>,
+                          negation<is_copy_constructible<T>>>::type());
+    }
+
+    void relocateAux(size_type front, size_type back, pointer newFirst,
+                     size_type gap, true_type) noexcept {
+        if (front != 0)
+            ::memcpy(newFirst, this->first, front * sizeof(T));
+        if (back != 0)
+            ::memcpy(newFirst + front + gap, this->first + front,
+                     back * sizeof(T));
+    }
+
+    void relocateAux(size_type front, size_type back, pointer newFirst,
+                     size_type gap, false_type) {
+        const pointer pos = this->first + front;
+        moveOrCopy(this->first, pos, newFirst);
+        try {
+            moveOrCopy(pos, pos + back, newFirst + front + gap);
+        } catch (...) {
+            destroyAllocRange(newFirst, newFirst + front, this->alloc);
+            throw;
+        }
+        destroyAllocRange(this->first, pos + back, this->alloc);
+    }
+
+    // move the first front elements to newFirst and the next back ones
+    // behind a hole of gap elements, the old elements are dead afterwards
+    void relocate(size_type front, size_type back, pointer newFirst,
+                  size_type gap) {
+        relocateAux(front, back, newFirst, gap, UseMemcpyRelocate{});
+    }
+
+    // move [first, pos) to newFirst and [pos, last) behind a hole of gap
+    // elements
+    void relocate(pointer pos, pointer newFirst, size_type gap) {
+        relocate(pos - this->first, this->last - pos, newFirst, gap);
+    }
+
+    void updatePointer(const pointer newFirst, size_type newSize,
+                       size_type newCapacity) noexcept {
+        releaseHeap();
+
+        this->first = newFirst;
+        this->last = newFirst + newSize;
+        this->end_of_storage = newFirst + newCapacity;
+    }
+
+    void reallocAndInit(size_type newCapacity) {
+        const size_type oldSize = size();
+        const pointer newFirst = allocateAux(newCapacity);
+
+        try {
+            relocate(this->last, newFirst, 0);
+        } catch (...) {
+            this->alloc.deallocate(newFirst, newCapacity);
+            throw;
+        }
+
+        updatePointer(newFirst, oldSize, newCapacity);
+    }
+
+    size_type capacityGrowth(size_type newSize) const {
+        const size_type oldCapacity = capacity();
+
+        if ((oldCapacity << 1) > max_size())
+            return newSize;
+
+        const size_type newCapacity = (oldCapacity << 1);
+
+        return newCapacity < newSize ? newSize : newCapacity;
+    }
+
+public:
+    // (1)
+    small_vector() noexcept(noexcept(Alloc())) : small_vector(Alloc()) {
+    }
+
+    explicit small_vector(const Alloc& a) noexcept : alloc(a) {
+        resetInline();
+    }
+
+    // (2)
+    small_vector(size_type count, const T& val, const Alloc& a = Alloc())
+        : alloc(a) {
+        resetInline();
+        try {
+            allocAux(count);
+            this->last = fillHelper(this->first, count, val);
+        } catch (...) {
+            releaseHeap();
+            throw;
+        }
+    }
+
+    // (3)
+    explicit small_vector(size_type count, const Alloc& a = Alloc())
+        : alloc(a) {
+        resetInline();
+        try {
+            allocAux(count);
+            this->last = defaultConstruct(this->first, count);
+        } catch (...) {
+            releaseHeap();
+            throw;
+        }
+    }
+
+private:
+    template <typename InIter>
+    void rangeConstruct(InIter xfirst, InIter xlast, input_iterator_tag) {
+        try {
+            for (; xfirst != xlast; ++xfirst)
+                emplace_back(*xfirst);
+        } catch (...) {
+            tidy();
+            throw;
+        }
+    }
+
+    template <typename FwdIter>
+    void rangeConstruct(FwdIter xfirst, FwdIter xlast, forward_iterator_tag) {
+        try {
+            allocAux(static_cast<size_type>(tiny_stl::distance(xfirst, xlast)));
+            this->last = copyAux(xfirst, xlast, this->first);
+        } catch (...) {
+            releaseHeap();
+            throw;
+        }
+    }
+
+public:
+    // (4)
+    template <typename InIter,
+              typename = enable_if_t<is_iterator<InIter>::value>>
+    small_vector(InIter xfirst, InIter xlast, const Alloc& a = Alloc())
+        : alloc(a) {
+        resetInline();
+        rangeConstruct(xfirst, xlast,
+                       typename iterator_traits<InIter>::iterator_category{});
+    }
+
+    // (5)
+    small_vector(const small_vector& rhs)
+        : alloc(allocator_traits<Alloc>::select_on_container_copy_construction(
+              rhs.alloc)) {
+        resetInline();
+        rangeConstruct(rhs.first, rhs.last, random_access_iterator_tag{});
+    }
+
+private:
+    // take over rhs's heap block, or move its inline elements one by one
+    void takeFrom(small_vector& rhs) {
+        if (!rhs.isInline()) {
+            this->first = rhs.first;
+            this->last = rhs.last;
+            this->end_of_storage = rhs.end_of_storage;
+            rhs.resetInline();
+        } else {
+            const size_type n = rhs.size();
+            rhs.relocate(rhs.last, this->first, 0);
+            this->last = this->first + n;
+            rhs.last = rhs.first;
+        }
+    }
+
+public:
+    // (6)
+    small_vector(small_vector&& rhs) noexcept(
+        is_nothrow_move_constructible<T>::value)
+        : alloc(tiny_stl::move(rhs.alloc)) {
+        resetInline();
+        takeFrom(rhs);
+    }
+
+    // (7)
+    small_vector(std::initializer_list<T> ilist, const Alloc& a = Alloc())
+        : alloc(a) {
+        resetInline();
+        rangeConstruct(ilist.begin(), ilist.end(),
+                       random_access_iterator_tag{});
+    }
+
+    ~small_vector() {
+        tidy();
+    }
+
+private:
+    template <typename InIter>
+    void assignCopyRange(InIter xfirst, InIter xlast, input_iterator_tag) {
+        clear();
+        for (; xfirst != xlast; ++xfirst)
+            emplace_back(*xfirst);
+    }
+
+    template <typename FwdIter>
+    void assignCopyRange(FwdIter xfirst, FwdIter xlast, forward_iterator_tag) {
+        const size_type newSize =
+            static_cast<size_type>(tiny_stl::distance(xfirst, xlast));
+
+        if (newSize > capacity()) { // reallocate
+            const pointer newFirst = allocateAux(newSize);
+            try {
+                copyAux(xfirst, xlast, newFirst);
+            } catch (...) {
+                this->alloc.deallocate(newFirst, newSize);
+                throw;
+            }
+
+            destroyAllocRange(this->first, this->last, this->alloc);
+            updatePointer(newFirst, newSize, newSize);
+        } else if (newSize > size()) {
+            FwdIter mid = xfirst;
+            tiny_stl::advance(mid, size());
+            tiny_stl::copy(xfirst, mid, this->first);
+            this->last = copyAux(mid, xlast, this->last);
+        } else {
+            const pointer newLast = tiny_stl::copy(xfirst, xlast, this->first);
+            destroyAllocRange(newLast, this->last, this->alloc);
+            this->last = newLast;
+        }
+    }
+
+public:
+    void assign(size_type n, const T& val) {
+        if (n > capacity()) { // reallocate, val may live in *this
+            const pointer newFirst = allocateAux(n);
+            try {
+                fillHelper(newFirst, n, val);
+            } catch (...) {
+                this->alloc.deallocate(newFirst, n);
+                throw;
+            }
+
+            destroyAllocRange(this->first, this->last, this->alloc);
+            updatePointer(newFirst, n, n);
+        } else if (n > size()) {
+            tiny_stl::fill(this->first, this->last, val);
+            this->last = fillHelper(this->last, n - size(), val);
+        } else {
+            const pointer newLast = this->first + n;
+            tiny_stl::fill(this->first, newLast, val);
+            destroyAllocRange(newLast, this->last, this->alloc);
+            this->last = newLast;
+        }
+    }
+
+    template <typename InIter,
+              typename = enable_if_t<is_iterator<InIter>::value>>
+    void assign(InIter xfirst, InIter xlast) {
+        assignCopyRange(xfirst, xlast,
+                        typename iterator_traits<InIter>::iterator_category{});
+    }
+
+    void assign(std::initializer_list<T> ilist) {
+        assignCopyRange(ilist.begin(), ilist.end(),
+                        random_access_iterator_tag{});
+    }
+
+    small_vector& operator=(const small_vector& rhs) {
+        if (this == tiny_stl::addressof(rhs))
+            return *this;
+
+        if (allocator_traits<
+                Alloc>::propagate_on_container_copy_assignment::value &&
+            this->alloc != rhs.alloc) {
+            tidy(); // this->alloc deallocate elements
+            this->alloc = rhs.alloc;
+        }
+
+        assign(rhs.first, rhs.last);
+        return *this;
+    }
+
+    small_vector& operator=(small_vector&& rhs) noexcept(
+        is_nothrow_move_constructible<T>::value &&
+        (allocator_traits<
+             Alloc>::propagate_on_container_move_assignment::value ||
+         allocator_traits<Alloc>::is_always_equal::value)) {
+        if (this == tiny_stl::addressof(rhs))
+            return *this;
+
+        tidy();
+        if (allocator_traits<
+                Alloc>::propagate_on_container_move_assignment::value)
+            this->alloc = rhs.alloc;
+
+        if (rhs.isInline() || this->alloc == rhs.alloc) {
+            takeFrom(rhs);
+        } else { // heap block belongs to another allocator, move individually
+            allocAux(rhs.size());
+            this->last = moveAux(rhs.first, rhs.last, this->first);
+            rhs.clear();
+        }
+
+        return *this;
+    }
+
+    small_vector& operator=(std::initializer_list<T> ilist) {
+        assignCopyRange(ilist.begin(), ilist.end(),
+                        random_access_iterator_tag{});
+        return *this;
+    }
+
+    allocator_type get_allocator() const {
+        return static_cast<allocator_type>(this->alloc);
+    }
+
+    T& at(size_type pos) {
+        if (pos >= size())
+            xRange();
+
+        return this->first[pos];
+    }
+
+    const T& at(size_type pos) const {
+        if (pos >= size())
+            xRange();
+
+        return this->first[pos];
+    }
+
+    T& operator[](size_type pos) {
+        assert(pos < size());
+        return this->first[pos];
+    }
+
+    const T& operator[](size_type pos) const {
+        assert(pos < size());
+        return this->first[pos];
+    }
+
+    T& front() {
+        assert(!empty());
+        return *this->first;
+    }
+
+    const T& front() const {
+        assert(!empty());
+        return *this->first;
+    }
+
+    T& back() {
+        assert(!empty());
+        return this->last[-1];
+    }
+
+    const T& back() const {
+        assert(!empty());
+        return this->last[-1];
+    }
+
+    T* data() noexcept {
+        return this->first;
+    }
+
+    const T* data() const noexcept {
+        return this->first;
+    }
+
+    iterator begin() noexcept {
+        return iterator(this->first);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(this->first);
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    iterator end() noexcept {
+        return iterator(this->last);
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(this->last);
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator crbegin() const noexcept {
+        return rbegin();
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    const_reverse_iterator crend() const noexcept {
+        return rend();
+    }
+
+public:
+    bool empty() const noexcept {
+        return this->first == this->last;
+    }
+
+    size_type size() const noexcept {
+        return static_cast<size_type>(this->last - this->first);
+    }
+
+    size_type max_size() const noexcept {
+        return sizeof(T) == 1 ? static_cast<size_type>(-1) >> 1
+                              : static_cast<size_type>(-1) / sizeof(T);
+    }
+
+    void reserve(size_type newCapacity) {
+        if (newCapacity > capacity())
+            reallocAndInit(newCapacity);
+    }
+
+    size_type capacity() const noexcept {
+        return static_cast<size_type>(this->end_of_storage - this->first);
+    }
+
+    // the inline capacity, never less than capacity()
+    static constexpr size_type inline_capacity() noexcept {
+        return N;
+    }
+
+    void shrink_to_fit() {
+        if (isInline() || size() == capacity())
+            return;
+
+        if (size() > N) {
+            reallocAndInit(size());
+            return;
+        }
+
+        // come back to the inline buffer
+        const pointer oldFirst = this->first;
+        const size_type oldCapacity = capacity();
+        const size_type oldSize = size();
+        relocate(this->last, inlineBuffer(), 0);
+
+        resetInline();
+        this->last = this->first + oldSize;
+        this->alloc.deallocate(oldFirst, oldCapacity);
+    }
+
+    void clear() noexcept {
+        destroyAllocRange(this->first, this->last, this->alloc);
+        this->last = this->first;
+    }
+
+private:
+    // grow to hold n more elements, the hole [pos, pos + n) is left raw and
+    // filled by construct(hole) before the old elements are moved over
+    template <typename Construct>
+    pointer reallocInsert(pointer pos, size_type n, Construct construct) {
+        const size_type oldSize = size();
+        if (n > max_size() - oldSize)
+            xLength();
+
+        const size_type newSize = oldSize + n;
+        const size_type newCapacity = capacityGrowth(newSize);
+        const size_type offset = pos - this->first;
+        const pointer newFirst = allocateAux(newCapacity);
+
+        try {
+            construct(newFirst + offset);
+        } catch (...) {
+            this->alloc.deallocate(newFirst, newCapacity);
+            throw;
+        }
+
+        try {
+            relocate(offset, oldSize - offset, newFirst, n);
+        } catch (...) {
+            destroyAllocRange(newFirst + offset, newFirst + offset + n,
+                              this->alloc);
+            this->alloc.deallocate(newFirst, newCapacity);
+            throw;
+        }
+
+        updatePointer(newFirst, newSize, newCapacity);
+        return newFirst + offset;
+    }
+
+public:
+    template <typename... Args>
+    void emplace_back(Args&&... args) {
+        if (this->last != this->end_of_storage) { // has unused capacity
+            allocator_traits<Alloc>::construct(
+                this->alloc, this->last, tiny_stl::forward<Args>(args)...);
+            ++this->last;
+        } else { // spill to (a larger) heap block
+            reallocInsert(this->last, 1, [&](pointer hole) {
+                allocator_traits<Alloc>::construct(
+                    this->alloc, hole, tiny_stl::forward<Args>(args)...);
+            });
+        }
+    }
+
+    void push_back(const_reference val) {
+        emplace_back(val);
+    }
+
+    void push_back(T&& val) {
+        emplace_back(tiny_stl::move(val));
+    }
+
+    void pop_back() {
+        assert(!empty());
+        allocator_traits<Alloc>::destroy(this->alloc, --this->last);
+    }
+
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args) {
+        assert(pos.ptr >= this->first && pos.ptr <= this->last);
+        const pointer p = pos.ptr;
+
+        if (p == this->last) {
+            emplace_back(tiny_stl::forward<Args>(args)...);
+            return iterator(this->last - 1);
+        }
+
+        if (this->last == this->end_of_storage) {
+            return reallocInsert(p, 1, [&](pointer hole) {
+                allocator_traits<Alloc>::construct(
+                    this->alloc, hole, tiny_stl::forward<Args>(args)...);
+            });
+        }
+
+        // args may refer to an element that is about to move
+        T obj(tiny_stl::forward<Args>(args)...);
+        allocator_traits<Alloc>::construct(this->alloc, this->last,
+                                           tiny_stl::move(this->last[-1]));
+        ++this->last;
+        tiny_stl::move_backward(p, this->last - 2, this->last - 1);
+        *p = tiny_stl::move(obj);
+        return iterator(p);
+    }
+
+    iterator insert(const_iterator pos, const T& val) {
+        return emplace(pos, val);
+    }
+
+    iterator insert(const_iterator pos, T&& val) {
+        return emplace(pos, tiny_stl::move(val));
+    }
+
+    iterator insert(const_iterator pos, size_type n, const T& val) {
+        assert(pos.ptr >= this->first && pos.ptr <= this->last);
+        const pointer p = pos.ptr;
+
+        if (n == 0)
+            return iterator(p);
+
+        if (n > static_cast<size_type>(this->end_of_storage - this->last)) {
+            return reallocInsert(
+                p, n, [&](pointer hole) { fillHelper(hole, n, val); });
+        }
+
+        const T copy(val); // val may live in *this
+        const pointer oldLast = this->last;
+        const size_type elemsAfter = oldLast - p;
+
+        if (elemsAfter > n) {
+            this->last = moveAux(oldLast - n, oldLast, oldLast);
+            tiny_stl::move_backward(p, oldLast - n, oldLast);
+            tiny_stl::fill(p, p + n, copy);
+        } else {
+            this->last = fillHelper(oldLast, n - elemsAfter, copy);
+            this->last = moveAux(p, oldLast, this->last);
+            tiny_stl::fill(p, oldLast, copy);
+        }
+
+        return iterator(p);
+    }
+
+private:
+    template <typename InIter>
+    pointer insertRangeAux(pointer pos, InIter xfirst, InIter xlast,
+                           input_iterator_tag) {
+        const size_type offset = pos - this->first;
+        const size_type oldSize = size();
+
+        // 1 2 3 6 insert 4 5 => 1 2 3 6 4 5 => rotate => 1 2 3 4 5 6
+        for (; xfirst != xlast; ++xfirst)
+            emplace_back(*xfirst);
+
+        tiny_stl::rotate(this->first + offset, this->first + oldSize,
+                         this->last);
+        return this->first + offset;
+    }
+
+    template <typename FwdIter>
+    pointer insertRangeAux(pointer pos, FwdIter xfirst, FwdIter xlast,
+                           forward_iterator_tag) {
+        const size_type n =
+            static_cast<size_type>(tiny_stl::distance(xfirst, xlast));
+
+        if (n == 0)
+            return pos;
+
+        if (n > static_cast<size_type>(this->end_of_storage - this->last)) {
+            return reallocInsert(pos, n, [&](pointer hole) {
+                copyAux(xfirst, xlast, hole);
+            });
+        }
+
+        const pointer oldLast = this->last;
+        const size_type elemsAfter = oldLast - pos;
+
+        if (elemsAfter > n) {
+            this->last = moveAux(oldLast - n, oldLast, oldLast);
+            tiny_stl::move_backward(pos, oldLast - n, oldLast);
+            tiny_stl::copy(xfirst, xlast, pos);
+        } else {
+            FwdIter mid = xfirst;
+            tiny_stl::advance(mid, elemsAfter);
+            this->last = copyAux(mid, xlast, oldLast);
+            this->last = moveAux(pos, oldLast, this->last);
+            tiny_stl::copy(xfirst, mid, pos);
+        }
+
+        return pos;
+    }
+
+public:
+    template <typename InIter,
+              typename = enable_if_t<is_iterator<InIter>::value>>
+    iterator insert(const_iterator pos, InIter xfirst, InIter xlast) {
+        assert(pos.ptr >= this->first && pos.ptr <= this->last);
+        return iterator(
+            insertRangeAux(pos.ptr, xfirst, xlast,
+                           typename iterator_traits<InIter>::iterator_category{}));
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<T> ilist) {
+        return insert(pos, ilist.begin(), ilist.end());
+    }
+
+    iterator erase(const_iterator pos) {
+        assert(pos.ptr >= this->first && pos.ptr < this->last);
+
+        tiny_stl::move(pos.ptr + 1, this->last, pos.ptr);
+        pop_back();
+        return iterator(pos.ptr);
+    }
+
+    iterator erase(const_iterator xfirst, const_iterator xlast) {
+        assert(xfirst.ptr == xlast.ptr ||
+               (xfirst.ptr >= this->first && xfirst.ptr < xlast.ptr &&
+                xlast.ptr <= this->last));
+
+        if (xfirst != xlast) {
+            const pointer newLast =
+                tiny_stl::move(xlast.ptr, this->last, xfirst.ptr);
+            destroyAllocRange(newLast, this->last, this->alloc);
+            this->last = newLast;
+        }
+
+        return iterator(xfirst.ptr);
+    }
+
+    void resize(size_type newSize) {
+        const size_type oldSize = size();
+
+        if (newSize < oldSize) {
+            erase(begin() + newSize, end());
+        } else if (newSize > oldSize) {
+            if (newSize > capacity())
+                reallocAndInit(capacityGrowth(newSize));
+
+            this->last = defaultConstruct(this->last, newSize - oldSize);
+        }
+    }
+
+    void resize(size_type newSize, const T& val) {
+        const size_type oldSize = size();
+
+        if (newSize < oldSize)
+            erase(begin() + newSize, end());
+        else if (newSize > oldSize)
+            insert(end(), newSize - oldSize, val);
+    }
+
+    void swap(small_vector& rhs) noexcept(
+        is_nothrow_move_constructible<T>::value) {
+        if (this == tiny_stl::addressof(rhs))
+            return;
+
+        if (!isInline() && !rhs.isInline()) {
+            swapAlloc(this->alloc, rhs.alloc);
+            tiny_stl::swap(this->first, rhs.first);
+            tiny_stl::swap(this->last, rhs.last);
+            tiny_stl::swap(this->end_of_storage, rhs.end_of_storage);
+        } else {
+            small_vector tmp(tiny_stl::move(rhs));
+            rhs = tiny_stl::move(*this);
+            *this = tiny_stl::move(tmp);
+        }
+    }
+
+private:
+    [[noreturn]] static void xLength() {
+        throw "small_vector<T, N> too long";
+    }
+
+    [[noreturn]] static void xRange() {
+        throw "invalid small_vector<T, N> subscript";
+    }
+}; // class small_vector<T, N, Alloc>
+
+template <typename T, std::size_t N, typename Alloc>
+inline bool operator==(const small_vector<T, N, Alloc>& lhs,
+                       const small_vector<T, N, Alloc>& rhs) {
+    return lhs.size() == rhs.size() &&
+           tiny_stl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline bool operator!=(const small_vector<T, N, Alloc>& lhs,
+                       const small_vector<T, N, Alloc>& rhs) {
+    return (!(lhs == rhs));
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline bool operator<(const small_vector<T, N, Alloc>& lhs,
+                      const small_vector<T, N, Alloc>& rhs) {
+    return tiny_stl::lexicographical_compare(lhs.begin(), lhs.end(),
+                                             rhs.begin(), rhs.end());
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline bool operator<=(const small_vector<T, N, Alloc>& lhs,
+                       const small_vector<T, N, Alloc>& rhs) {
+    return (!(rhs < lhs));
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline bool operator>(const small_vector<T, N, Alloc>& lhs,
+                      const small_vector<T, N, Alloc>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline bool operator>=(const small_vector<T, N, Alloc>& lhs,
+                       const small_vector<T, N, Alloc>& rhs) {
+    return (!(lhs < rhs));
+}
+
+template <typename T, std::size_t N, typename Alloc>
+inline void swap(small_vector<T, N, Alloc>& lhs,
+                 small_vector<T, N, Alloc>& rhs) noexcept(noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
+} // namespace tiny_stl
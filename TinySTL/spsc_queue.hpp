@@ -0,0 +1,207 @@
+// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <atomic>
+
+#include "memory.hpp"
+
+namespace tiny_stl {
+
+// Bounded single-producer/single-consumer queue on a ring buffer.
+// One thread may call the push functions and one other thread the pop
+// functions at the same time, every operation is wait-free.
+//
+// head and tail are free-running counters, the slot is `index & mask`.
+// Each side keeps a copy of the other side's counter and only reloads it
+// when the copy says the queue is full (empty), so in the common case a
+// push or pop doesn't touch the cache line written by the other thread.
+template <typename T, typename Alloc = allocator<T>>
+class spsc_queue {
+public:
+    static_assert(is_same<T, typename Alloc::value_type>::value,
+                  "Allocator::value_type is not the same as T");
+
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using reference = T&;
+    using const_reference = const T&;
+
+private:
+    // written only by the consumer
+    alignas(TINY_STL_CACHE_LINE_SIZE) std::atomic<size_type> head;
+    size_type tail_cache;
+
+    // written only by the producer
+    alignas(TINY_STL_CACHE_LINE_SIZE) std::atomic<size_type> tail;
+    size_type head_cache;
+
+    // read-only after construction
+    alignas(TINY_STL_CACHE_LINE_SIZE) T* buffer;
+    size_type mask;
+    Alloc alloc;
+
+private:
+    static size_type roundUpCapacity(size_type n) {
+        size_type cap = 1;
+        while (cap < n)
+            cap <<= 1;
+        return cap;
+    }
+
+    T* slot(size_type index) const noexcept {
+        return buffer + (index & mask);
+    }
+
+    // free slots seen by the producer, reload head only when needed
+    size_type freeSlots(size_type t, size_type want) noexcept {
+        size_type avail = capacity() - (t - head_cache);
+        if (avail < want) {
+            head_cache = head.load(std::memory_order_acquire);
+            avail = capacity() - (t - head_cache);
+        }
+        return avail;
+    }
+
+    // filled slots seen by the consumer, reload tail only when needed
+    size_type usedSlots(size_type h, size_type want) noexcept {
+        size_type avail = tail_cache - h;
+        if (avail < want) {
+            tail_cache = tail.load(std::memory_order_acquire);
+            avail = tail_cache - h;
+        }
+        return avail;
+    }
+
+public:
+    // the capacity is rounded up to a power of two
+    explicit spsc_queue(size_type cap, const Alloc& a = Alloc())
+        : head(0), tail_cache(0), tail(0), head_cache(0), buffer(nullptr),
+          mask(roundUpCapacity(cap == 0 ? 1 : cap) - 1), alloc(a) {
+        buffer = alloc.allocate(mask + 1);
+    }
+
+    spsc_queue(const spsc_queue&) = delete;
+    spsc_queue& operator=(const spsc_queue&) = delete;
+
+    ~spsc_queue() {
+        const size_type t = tail.load(std::memory_order_relaxed);
+        for (size_type h = head.load(std::memory_order_relaxed); h != t; ++h)
+            alloc.destroy(slot(h));
+        alloc.deallocate(buffer, mask + 1);
+    }
+
+public:
+    size_type capacity() const noexcept {
+        return mask + 1;
+    }
+
+    // only a snapshot while the other thread is running
+    size_type size() const noexcept {
+        const size_type h = head.load(std::memory_order_acquire);
+        return tail.load(std::memory_order_acquire) - h;
+    }
+
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    allocator_type get_allocator() const {
+        return alloc;
+    }
+
+public: // producer
+    template <typename... Args>
+    bool try_emplace(Args&&... args) {
+        const size_type t = tail.load(std::memory_order_relaxed);
+        if (freeSlots(t, 1) == 0)
+            return false;
+
+        alloc.construct(slot(t), tiny_stl::forward<Args>(args)...);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T& val) {
+        return try_emplace(val);
+    }
+
+    bool try_push(T&& val) {
+        return try_emplace(tiny_stl::move(val));
+    }
+
+    // push up to n elements from first and publish them at once,
+    // returns the number pushed
+    template <typename InIter>
+    size_type try_push_n(InIter first, size_type n) {
+        const size_type t = tail.load(std::memory_order_relaxed);
+        n = tiny_stl::min(n, freeSlots(t, n));
+
+        size_type i = 0;
+        try {
+            for (; i != n; ++i, ++first)
+                alloc.construct(slot(t + i), *first);
+        } catch (...) {
+            tail.store(t + i, std::memory_order_release);
+            throw;
+        }
+
+        tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+
+public: // consumer
+    bool try_pop(T& val) {
+        const size_type h = head.load(std::memory_order_relaxed);
+        if (usedSlots(h, 1) == 0)
+            return false;
+
+        T* p = slot(h);
+        val = tiny_stl::move(*p);
+        alloc.destroy(p);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // the oldest element or nullptr, stays valid until pop()
+    T* front() noexcept {
+        const size_type h = head.load(std::memory_order_relaxed);
+        return usedSlots(h, 1) == 0 ? nullptr : slot(h);
+    }
+
+    // the queue mustn't be empty, i.e. front() returned non-null
+    void pop() noexcept {
+        const size_type h = head.load(std::memory_order_relaxed);
+        assert(h != tail_cache);
+        alloc.destroy(slot(h));
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    // move up to n elements to dest and release their slots at once,
+    // returns the number popped
+    template <typename OutIter>
+    size_type try_pop_n(OutIter dest, size_type n) {
+        const size_type h = head.load(std::memory_order_relaxed);
+        n = tiny_stl::min(n, usedSlots(h, n));
+
+        size_type i = 0;
+        try {
+            for (; i != n; ++i, ++dest) {
+                T* p = slot(h + i);
+                *dest = tiny_stl::move(*p);
+                alloc.destroy(p);
+            }
+        } catch (...) {
+            head.store(h + i, std::memory_order_release);
+            throw;
+        }
+
+        head.store(h + n, std::memory_order_release);
+        return n;
+    }
+}; // class spsc_queue<T, Alloc>
+
+} // namespace tiny_stl
@@ -0,0 +1,590 @@
+// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include "vector.hpp"
+
+namespace tiny_stl {
+
+// storage of static_vector, elements live in the object itself
+template <typename T, std::size_t N,
+          bool = is_trivially_copyable<T>::value>
+class StaticVectorBase {
+public:
+    using size_type = std::size_t;
+
+protected:
+    size_type count;
+    alignas(T) unsigned char buffer[sizeof(T) * N];
+
+    T* getFirst() noexcept {
+        return reinterpret_cast<T*>(buffer);
+    }
+
+    const T* getFirst() const noexcept {
+        return reinterpret_cast<const T*>(buffer);
+    }
+
+    void destroyAll() noexcept {
+        destroyRange(getFirst(), getFirst() + count);
+        count = 0;
+    }
+
+    // build n elements into an empty buffer, if one of them throws the
+    // ones before it are destroyed again and the buffer is left empty
+    template <typename InIter>
+    void constructN(InIter src, size_type n) {
+        assert(count == 0);
+        try {
+            for (T* const p = getFirst(); count != n; ++src, ++count)
+                constructInPlace(p[count], *src);
+        } catch (...) {
+            destroyAll();
+            throw;
+        }
+    }
+
+public:
+    StaticVectorBase() noexcept : count(0) {
+    }
+
+    StaticVectorBase(const StaticVectorBase& rhs) : count(0) {
+        constructN(rhs.getFirst(), rhs.count);
+    }
+
+    StaticVectorBase(StaticVectorBase&& rhs) noexcept(
+        is_nothrow_move_constructible<T>::value)
+        : count(0) {
+        constructN(tiny_stl::make_move_iterator(rhs.getFirst()), rhs.count);
+    }
+
+    StaticVectorBase& operator=(const StaticVectorBase& rhs) {
+        if (this != tiny_stl::addressof(rhs)) {
+            destroyAll();
+            constructN(rhs.getFirst(), rhs.count);
+        }
+        return *this;
+    }
+
+    StaticVectorBase& operator=(StaticVectorBase&& rhs) noexcept(
+        is_nothrow_move_constructible<T>::value) {
+        if (this != tiny_stl::addressof(rhs)) {
+            destroyAll();
+            constructN(tiny_stl::make_move_iterator(rhs.getFirst()),
+                       rhs.count);
+        }
+        return *this;
+    }
+
+    ~StaticVectorBase() {
+        destroyAll();
+    }
+}; // class StaticVectorBase<T, N, false>
+
+// trivially copyable T: copy, move and destroy are left to the compiler,
+// so static_vector<T, N> itself is trivially copyable
+template <typename T, std::size_t N>
+class StaticVectorBase<T, N, true> {
+public:
+    using size_type = std::size_t;
+
+protected:
+    size_type count;
+    union {
+        unsigned char dummy;
+        T elems[N];
+    };
+
+    T* getFirst() noexcept {
+        return elems;
+    }
+
+    const T* getFirst() const noexcept {
+        return elems;
+    }
+
+    void destroyAll() noexcept {
+        count = 0;
+    }
+
+public:
+    constexpr StaticVectorBase() noexcept : count(0), dummy() {
+    }
+}; // class StaticVectorBase<T, N, true>
+
+// vector with a fixed capacity N and no allocator.
+// Going over capacity is a precondition violation (assert) for the plain
+// modifiers; try_emplace_back/try_push_back are the checked form.
+template <typename T, std::size_t N>
+class static_vector : public StaticVectorBase<T, N> {
+public:
+    static_assert(N > 0, "static_vector needs a capacity");
+
+private:
+    using Base = StaticVectorBase<T, N>;
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = VectorIterator<T>;
+    using const_iterator = VectorConstIterator<T>;
+    using reverse_iterator = tiny_stl::reverse_iterator<iterator>;
+    using const_reverse_iterator = tiny_stl::reverse_iterator<const_iterator>;
+
+private:
+    using Base::count;
+    using Base::destroyAll;
+    using Base::getFirst;
+
+    pointer getLast() noexcept {
+        return getFirst() + count;
+    }
+
+    // never written through, VectorConstIterator only holds a T*
+    pointer mutableFirst() const noexcept {
+        return const_cast<pointer>(getFirst());
+    }
+
+    static pointer moveAux(pointer xfirst, pointer xlast, pointer newFirst) {
+        return tiny_stl::uninitialized_copy(tiny_stl::make_move_iterator(xfirst),
+                                            tiny_stl::make_move_iterator(xlast),
+                                            newFirst);
+    }
+
+    template <typename InIter>
+    void appendRange(InIter xfirst, InIter xlast, input_iterator_tag) {
+        for (; xfirst != xlast; ++xfirst)
+            emplace_back(*xfirst);
+    }
+
+    template <typename FwdIter>
+    void appendRange(FwdIter xfirst, FwdIter xlast, forward_iterator_tag) {
+        assert(static_cast<size_type>(tiny_stl::distance(xfirst, xlast)) <=
+               N - count);
+        for (; xfirst != xlast; ++xfirst, ++count)
+            constructInPlace(*getLast(), *xfirst);
+    }
+
+    void appendFill(size_type n, const T& val) {
+        assert(n <= N - count);
+        for (; n > 0; --n, ++count)
+            constructInPlace(*getLast(), val);
+    }
+
+public:
+    // (1)
+    static_vector() = default;
+
+    // (2)
+    static_vector(size_type n, const T& val) {
+        appendFill(n, val);
+    }
+
+    // (3)
+    explicit static_vector(size_type n) {
+        resize(n);
+    }
+
+    // (4)
+    template <typename InIter,
+              typename = enable_if_t<is_iterator<InIter>::value>>
+    static_vector(InIter xfirst, InIter xlast) {
+        appendRange(xfirst, xlast,
+                    typename iterator_traits<InIter>::iterator_category{});
+    }
+
+    // (5)
+    static_vector(std::initializer_list<T> ilist) {
+        appendRange(ilist.begin(), ilist.end(), random_access_iterator_tag{});
+    }
+
+    static_vector& operator=(std::initializer_list<T> ilist) {
+        assign(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    void assign(size_type n, const T& val) {
+        if (n <= count) {
+            tiny_stl::fill(getFirst(), getFirst() + n, val);
+            erase(begin() + n, end());
+        } else {
+            tiny_stl::fill(getFirst(), getLast(), val);
+            appendFill(n - count, val);
+        }
+    }
+
+    template <typename InIter,
+              typename = enable_if_t<is_iterator<InIter>::value>>
+    void assign(InIter xfirst, InIter xlast) {
+        clear();
+        appendRange(xfirst, xlast,
+                    typename iterator_traits<InIter>::iterator_category{});
+    }
+
+    void assign(std::initializer_list<T> ilist) {
+        assign(ilist.begin(), ilist.end());
+    }
+
+    T& at(size_type pos) {
+        if (pos >= count)
+            xRange();
+
+        return getFirst()[pos];
+    }
+
+    const T& at(size_type pos) const {
+        if (pos >= count)
+            xRange();
+
+        return getFirst()[pos];
+    }
+
+    T& operator[](size_type pos) {
+        assert(pos < count);
+        return getFirst()[pos];
+    }
+
+    const T& operator[](size_type pos) const {
+        assert(pos < count);
+        return getFirst()[pos];
+    }
+
+    T& front() {
+        assert(!empty());
+        return getFirst()[0];
+    }
+
+    const T& front() const {
+        assert(!empty());
+        return getFirst()[0];
+    }
+
+    T& back() {
+        assert(!empty());
+        return getFirst()[count - 1];
+    }
+
+    const T& back() const {
+        assert(!empty());
+        return getFirst()[count - 1];
+    }
+
+    T* data() noexcept {
+        return getFirst();
+    }
+
+    const T* data() const noexcept {
+        return getFirst();
+    }
+
+    iterator begin() noexcept {
+        return iterator(getFirst());
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(mutableFirst());
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    iterator end() noexcept {
+        return iterator(getLast());
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(mutableFirst() + count);
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator crbegin() const noexcept {
+        return rbegin();
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    const_reverse_iterator crend() const noexcept {
+        return rend();
+    }
+
+public:
+    constexpr bool empty() const noexcept {
+        return count == 0;
+    }
+
+    constexpr size_type size() const noexcept {
+        return count;
+    }
+
+    static constexpr size_type max_size() noexcept {
+        return N;
+    }
+
+    static constexpr size_type capacity() noexcept {
+        return N;
+    }
+
+    constexpr bool full() const noexcept {
+        return count == N;
+    }
+
+    // no storage to manage, kept so that code written for vector compiles
+    void reserve(size_type n) noexcept {
+        assert(n <= N);
+        (void)n;
+    }
+
+    void shrink_to_fit() noexcept {
+    }
+
+    void clear() noexcept {
+        destroyAll();
+    }
+
+    template <typename... Args>
+    void emplace_back(Args&&... args) {
+        assert(count < N);
+        constructInPlace(*getLast(), tiny_stl::forward<Args>(args)...);
+        ++count;
+    }
+
+    void push_back(const T& val) {
+        emplace_back(val);
+    }
+
+    void push_back(T&& val) {
+        emplace_back(tiny_stl::move(val));
+    }
+
+    // return nullptr instead of overflowing
+    template <typename... Args>
+    pointer try_emplace_back(Args&&... args) {
+        if (count == N)
+            return nullptr;
+
+        const pointer p = getLast();
+        constructInPlace(*p, tiny_stl::forward<Args>(args)...);
+        ++count;
+        return p;
+    }
+
+    pointer try_push_back(const T& val) {
+        return try_emplace_back(val);
+    }
+
+    pointer try_push_back(T&& val) {
+        return try_emplace_back(tiny_stl::move(val));
+    }
+
+    void pop_back() {
+        assert(!empty());
+        --count;
+        destroyInPlace(*getLast());
+    }
+
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args) {
+        const pointer p = pos.ptr;
+        assert(p >= getFirst() && p <= getLast());
+
+        if (p == getLast()) {
+            emplace_back(tiny_stl::forward<Args>(args)...);
+            return iterator(p);
+        }
+
+        assert(count < N);
+        // args may refer to an element that is about to move
+        T obj(tiny_stl::forward<Args>(args)...);
+        const pointer oldLast = getLast();
+        constructInPlace(*oldLast, tiny_stl::move(oldLast[-1]));
+        ++count;
+        tiny_stl::move_backward(p, oldLast - 1, oldLast);
+        *p = tiny_stl::move(obj);
+        return iterator(p);
+    }
+
+    iterator insert(const_iterator pos, const T& val) {
+        return emplace(pos, val);
+    }
+
+    iterator insert(const_iterator pos, T&& val) {
+        return emplace(pos, tiny_stl::move(val));
+    }
+
+    iterator insert(const_iterator pos, size_type n, const T& val) {
+        const pointer p = pos.ptr;
+        assert(p >= getFirst() && p <= getLast());
+        assert(n <= N - count);
+
+        if (n == 0)
+            return iterator(p);
+
+        const T copy(val); // val may live in *this
+        const pointer oldLast = getLast();
+        const size_type elemsAfter = oldLast - p;
+
+        if (elemsAfter > n) {
+            moveAux(oldLast - n, oldLast, oldLast);
+            count += n;
+            tiny_stl::move_backward(p, oldLast - n, oldLast);
+            tiny_stl::fill(p, p + n, copy);
+        } else {
+            appendFill(n - elemsAfter, copy);
+            moveAux(p, oldLast, getLast());
+            count += elemsAfter;
+            tiny_stl::fill(p, oldLast, copy);
+        }
+
+        return iterator(p);
+    }
+
+    template <typename InIter,
+              typename = enable_if_t<is_iterator<InIter>::value>>
+    iterator insert(const_iterator pos, InIter xfirst, InIter xlast) {
+        const pointer p = pos.ptr;
+        assert(p >= getFirst() && p <= getLast());
+
+        // 1 2 3 6 insert 4 5 => 1 2 3 6 4 5 => rotate => 1 2 3 4 5 6
+        const pointer oldLast = getLast();
+        appendRange(xfirst, xlast,
+                    typename iterator_traits<InIter>::iterator_category{});
+        tiny_stl::rotate(p, oldLast, getLast());
+        return iterator(p);
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<T> ilist) {
+        return insert(pos, ilist.begin(), ilist.end());
+    }
+
+    iterator erase(const_iterator pos) {
+        assert(pos.ptr >= getFirst() && pos.ptr < getLast());
+
+        tiny_stl::move(pos.ptr + 1, getLast(), pos.ptr);
+        pop_back();
+        return iterator(pos.ptr);
+    }
+
+    iterator erase(const_iterator xfirst, const_iterator xlast) {
+        assert(xfirst.ptr == xlast.ptr ||
+               (xfirst.ptr >= getFirst() && xfirst.ptr < xlast.ptr &&
+                xlast.ptr <= getLast()));
+
+        if (xfirst != xlast) {
+            const pointer newLast =
+                tiny_stl::move(xlast.ptr, getLast(), xfirst.ptr);
+            destroyRange(newLast, getLast());
+            count = newLast - getFirst();
+        }
+
+        return iterator(xfirst.ptr);
+    }
+
+    void resize(size_type n) {
+        assert(n <= N);
+
+        if (n < count) {
+            erase(begin() + n, end());
+        } else {
+            for (; count < n; ++count)
+                constructInPlace(*getLast());
+        }
+    }
+
+    void resize(size_type n, const T& val) {
+        if (n < count)
+            erase(begin() + n, end());
+        else
+            insert(end(), n - count, val);
+    }
+
+    void swap(static_vector& rhs) noexcept(
+        is_nothrow_move_constructible<T>::value &&
+        is_nothrow_swappable<T>::value) {
+        static_vector& shorter = count <= rhs.count ? *this : rhs;
+        static_vector& longer = count <= rhs.count ? rhs : *this;
+        const size_type n = shorter.count;
+
+        tiny_stl::swap_ranges(shorter.getFirst(), shorter.getLast(),
+                              longer.getFirst());
+        moveAux(longer.getFirst() + n, longer.getLast(), shorter.getLast());
+        destroyRange(longer.getFirst() + n, longer.getLast());
+        shorter.count = longer.count;
+        longer.count = n;
+    }
+
+private:
+    [[noreturn]] static void xRange() {
+        throw "invalid static_vector<T, N> subscript";
+    }
+}; // class static_vector<T, N>
+
+template <typename T, std::size_t N>
+inline bool operator==(const static_vector<T, N>& lhs,
+                       const static_vector<T, N>& rhs) {
+    return lhs.size() == rhs.size() &&
+           tiny_stl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename T, std::size_t N>
+inline bool operator!=(const static_vector<T, N>& lhs,
+                       const static_vector<T, N>& rhs) {
+    return (!(lhs == rhs));
+}
+
+template <typename T, std::size_t N>
+inline bool operator<(const static_vector<T, N>& lhs,
+                      const static_vector<T, N>& rhs) {
+    return tiny_stl::lexicographical_compare(lhs.begin(), lhs.end(),
+                                             rhs.begin(), rhs.end());
+}
+
+template <typename T, std::size_t N>
+inline bool operator<=(const static_vector<T, N>& lhs,
+                       const static_vector<T, N>& rhs) {
+    return (!(rhs < lhs));
+}
+
+template <typename T, std::size_t N>
+inline bool operator>(const static_vector<T, N>& lhs,
+                      const static_vector<T, N>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename T, std::size_t N>
+inline bool operator>=(const static_vector<T, N>& lhs,
+                       const static_vector<T, N>& rhs) {
+    return (!(lhs < rhs));
+}
+
+template <typename T, std::size_t N>
+inline void swap(static_vector<T, N>& lhs,
+                 static_vector<T, N>& rhs) noexcept(noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
+} // namespace tiny_stl
@@ -176,6 +176,27 @@ struct StringIterator : StringConstIterator<T> {
     }
 }; // StringIterator<T>
 
+template <typename Iter, typename Ptr>
+struct StringContiguousTraits {
+    using is_contiguous_iterator = true_type;
+
+    static Ptr toPointer(const Iter& iter) {
+        return const_cast<Ptr>(iter.ptr);
+    }
+
+    static Iter fromPointer(const Iter&, Ptr p) {
+        return Iter(p);
+    }
+};
+
+template <typename T>
+struct ContiguousIteratorTraits<StringConstIterator<T>>
+    : StringContiguousTraits<StringConstIterator<T>, const T*> {};
+
+template <typename T>
+struct ContiguousIteratorTraits<StringIterator<T>>
+    : StringContiguousTraits<StringIterator<T>, T*> {};
+
 template <typename CharT, typename Traits = std::char_traits<CharT>,
           typename Alloc = allocator<CharT>>
 class basic_string {
@@ -873,20 +894,20 @@ private:
         const bool isShortRhs = rhsVal.isShortString();
 
         if (isShortLhs) {
-            if (isShortRhs)
-                swapADL(lhsVal.data.ptr, rhsVal.data.ptr);
-            else
-                swapShortWithLong(lhsVal, rhsVal);
-        } else { // lhs is long string
             if (isShortRhs) {
-                swapShortWithLong(rhsVal, lhsVal);
-            } else {
                 value_type tmpBuf[StringValue::kBufferSize];
                 Traits::move(tmpBuf, lhsVal.data.buf, StringValue::kBufferSize);
                 Traits::move(lhsVal.data.buf, rhsVal.data.buf,
                              StringValue::kBufferSize);
                 Traits::move(rhsVal.data.buf, tmpBuf, StringValue::kBufferSize);
+            } else {
+                swapShortWithLong(lhsVal, rhsVal);
             }
+        } else { // lhs is long string
+            if (isShortRhs)
+                swapShortWithLong(rhsVal, lhsVal);
+            else
+                swapADL(lhsVal.data.ptr, rhsVal.data.ptr);
         }
 
         swapADL(lhsVal.size, rhsVal.size);
@@ -230,6 +230,31 @@ operator+(const typename StringViewIterator<CharT>::difference_type off,
     return rhs;
 }
 
+template <typename CharT>
+struct ContiguousIteratorTraits<StringViewIterator<CharT>> {
+    using is_contiguous_iterator = true_type;
+    using Iter = StringViewIterator<CharT>;
+
+#ifndef NDEBUG // DEBUG
+    static const CharT* toPointer(const Iter& iter) {
+        return iter.ptr + iter.index;
+    }
+
+    static Iter fromPointer(const Iter& iter, const CharT* p) {
+        return Iter(iter.ptr, iter.size,
+                    static_cast<std::size_t>(p - iter.ptr));
+    }
+#else
+    static const CharT* toPointer(const Iter& iter) {
+        return iter.ptr;
+    }
+
+    static Iter fromPointer(const Iter&, const CharT* p) {
+        return Iter(p);
+    }
+#endif // !NDEBUG
+};
+
 template <typename CharT, typename Traits = std::char_traits<CharT>>
 class basic_string_view {
 public:
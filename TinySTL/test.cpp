@@ -11,19 +11,33 @@
 #include <climits>
 #include <ctime>
 #include <iostream>
+#include <thread>
 
 #include "array.hpp"
+#include "circular_buffer.hpp"
+#include "concurrent_map.hpp"
+#include "concurrent_set.hpp"
+#include "concurrent_unordered_map.hpp"
 #include "cow_string.hpp"
 #include "deque.hpp"
+#include "dynamic_bitset.hpp"
 #include "forward_list.hpp"
+#include "indexed_priority_queue.hpp"
 #include "iterator.hpp"
 #include "list.hpp"
 #include "map.hpp"
 #include "memory.hpp"
+#include "mpmc_queue.hpp"
+#include "numeric.hpp"
+#include "pairing_heap.hpp"
 #include "queue.hpp"
 #include "rbtree.hpp"
+#include "search_index.hpp"
 #include "set.hpp"
+#include "small_vector.hpp"
+#include "spsc_queue.hpp"
 #include "stack.hpp"
+#include "static_vector.hpp"
 #include "string.hpp"
 #include "string_view.hpp"
 #include "tuple.hpp"
@@ -122,6 +136,7 @@ void testTypeTraits() {
     UNIT_TEST(true, (is_same_v<add_rvalue_reference_t<int>, int&&>));
     UNIT_TEST(true, is_floating_point_v<double>);
     UNIT_TEST(true, is_integral_v<std::int32_t>);
+    UNIT_TEST(true, is_integral_v<unsigned short>);
     UNIT_TEST(true, (is_same_v<int*, add_pointer_t<int>>));
     UNIT_TEST(true, (is_same_v<add_pointer_t<int(int)>,
                                tiny_stl::add_pointer_t<int(int)>>));
@@ -226,6 +241,11 @@ void testAlgorithm() {
     UNIT_TEST(true, tiny_stl::is_sorted(v2.begin(), v2.end()));
     tiny_stl::make_heap(v2.begin(), v2.end());
     UNIT_TEST(true, tiny_stl::is_heap(v2.begin(), v2.end()));
+    tiny_stl::make_heap(v2.begin(), v2.end(), tiny_stl::greater<>{});
+    UNIT_TEST(2, v2.front());
+    tiny_stl::sort_heap(v2.begin(), v2.end(), tiny_stl::greater<>{});
+    UNIT_TEST(true, tiny_stl::is_sorted(v2.begin(), v2.end(),
+                                        tiny_stl::greater<>{}));
 
     tiny_stl::vector<int> v = {3, 4, 2, 3, 5, 5, 3, 5, 2};
     UNIT_TEST(3, tiny_stl::count(v.begin(), v.end(), 5));
@@ -249,6 +269,239 @@ void testAlgorithm() {
     tiny_stl::sort(vs.begin(), vs.end());
     UNIT_TEST(true, tiny_stl::is_sorted(vs.begin(), vs.end()));
 
+    tiny_stl::vector<int> vr;
+    for (int i = 0; i < 1000; ++i) {
+        vr.push_back(rand() - RAND_MAX / 2);
+    }
+    tiny_stl::radix_sort(vr.begin(), vr.end());
+    UNIT_TEST(true, tiny_stl::is_sorted(vr.begin(), vr.end()));
+
+    double vd[] = {2.5, -0.5, 0.0, -3.0, 1e300, -1e-300};
+    tiny_stl::radix_sort(vd, vd + 6);
+    UNIT_TEST(true, tiny_stl::is_sorted(vd, vd + 6));
+    UNIT_TEST(-3.0, vd[0]);
+
+    // stable by key
+    tiny_stl::vector<tiny_stl::pair<unsigned char, int>> vk;
+    for (int i = 0; i < 100; ++i) {
+        vk.push_back(tiny_stl::make_pair<unsigned char, int>(
+            static_cast<unsigned char>(i % 7), int(i)));
+    }
+    tiny_stl::radix_sort(vk.begin(), vk.end(),
+                         [](const tiny_stl::pair<unsigned char, int>& e) {
+                             return e.first;
+                         });
+    UNIT_TEST(true, tiny_stl::is_sorted(vk.begin(), vk.end()));
+
+    tiny_stl::vector<std::uint16_t> vu16;
+    for (int i = 0; i < 1000; ++i) {
+        vu16.push_back(static_cast<std::uint16_t>(rand()));
+    }
+    vu16.push_back(65535);
+    tiny_stl::radix_sort(vu16.begin(), vu16.end());
+    UNIT_TEST(true, tiny_stl::is_sorted(vu16.begin(), vu16.end()));
+    UNIT_TEST(65535, vu16.back());
+
+    // payloads that aren't trivially copyable travel with their keys
+    tiny_stl::vector<tiny_stl::pair<int, tiny_stl::string>> vps;
+    for (int i = 0; i < 300; ++i) {
+        const int id = rand() % 1000 - 500;
+        vps.push_back(tiny_stl::make_pair(id, tiny_stl::to_string(id)));
+    }
+    tiny_stl::radix_sort(vps.begin(), vps.end(),
+                         [](const tiny_stl::pair<int, tiny_stl::string>& e) {
+                             return e.first;
+                         });
+    bool payloadsKept = true;
+    for (const auto& e : vps) {
+        payloadsKept = payloadsKept && e.second == tiny_stl::to_string(e.first);
+    }
+    UNIT_TEST(true, tiny_stl::is_sorted(vps.begin(), vps.end()));
+    UNIT_TEST(true, payloadsKept);
+
+    tiny_stl::vector<tiny_stl::string> vstr = {
+        "pear", "apple", "", "app", "banana", "apple pie", "b", "apple"};
+    for (int i = 0; i < 100; ++i) {
+        vstr.push_back(tiny_stl::to_string(rand()));
+    }
+    tiny_stl::radix_sort(vstr.begin(), vstr.end());
+    UNIT_TEST(true, tiny_stl::is_sorted(vstr.begin(), vstr.end()));
+    UNIT_TEST(tiny_stl::string{}, vstr.front());
+
+    int m1[] = {1, 3, 5, 7};
+    int m2[] = {2, 3, 4, 8, 9};
+    int mo[9];
+    tiny_stl::merge(m1, m1 + 4, m2, m2 + 5, mo);
+    UNIT_TEST(true, tiny_stl::is_sorted(mo, mo + 9));
+    UNIT_TEST(9, mo[8]);
+
+    tiny_stl::vector<int> vm = {1, 4, 6, 9, 2, 3, 4, 10};
+    tiny_stl::inplace_merge(vm.begin(), vm.begin() + 4, vm.end());
+    UNIT_TEST(true, tiny_stl::is_sorted(vm.begin(), vm.end()));
+
+    // stable by key, with natural runs and a descending run
+    tiny_stl::vector<tiny_stl::pair<int, int>> vss;
+    for (int i = 0; i < 500; ++i) {
+        vss.push_back(tiny_stl::make_pair(i < 200 ? i / 3 : 500 - i, i));
+    }
+    for (int i = 0; i < 300; ++i) {
+        vss.push_back(tiny_stl::make_pair(rand() % 50, 500 + i));
+    }
+    tiny_stl::stable_sort(vss.begin(), vss.end(),
+                          [](const tiny_stl::pair<int, int>& lhs,
+                             const tiny_stl::pair<int, int>& rhs) {
+                              return lhs.first < rhs.first;
+                          });
+    UNIT_TEST(true, tiny_stl::is_sorted(vss.begin(), vss.end()));
+
+    tiny_stl::vector<int> vn;
+    for (int i = 0; i < 1000; ++i) {
+        vn.push_back((i * 7919) % 1000);
+    }
+    tiny_stl::nth_element(vn.begin(), vn.begin() + 500, vn.end());
+    UNIT_TEST(500, vn[500]);
+    UNIT_TEST(true, *tiny_stl::max_element(vn.begin(), vn.begin() + 500) <
+                        *tiny_stl::min_element(vn.begin() + 501, vn.end()));
+    tiny_stl::partial_sort(vn.begin(), vn.begin() + 10, vn.end());
+    UNIT_TEST(true, tiny_stl::is_sorted(vn.begin(), vn.begin() + 10));
+    UNIT_TEST(9, vn[9]);
+    tiny_stl::partial_sort(vn.begin(), vn.begin() + 600, vn.end(),
+                           tiny_stl::greater<>{});
+    UNIT_TEST(999, vn[0]);
+    UNIT_TEST(400, vn[599]);
+
+    tiny_stl::list<int> ln = {5, 1, 4, 2, 3};
+    int lo[3];
+    UNIT_TEST(true,
+              lo + 3 == tiny_stl::partial_sort_copy(ln.begin(), ln.end(), lo,
+                                                    lo + 3));
+    UNIT_TEST(1, lo[0]);
+    UNIT_TEST(3, lo[2]);
+
+    tiny_stl::vector<int> vb = {1, 3, 3, 3, 5, 8, 13};
+    UNIT_TEST(1, tiny_stl::lower_bound(vb.begin(), vb.end(), 3) - vb.begin());
+    UNIT_TEST(4, tiny_stl::upper_bound(vb.begin(), vb.end(), 3) - vb.begin());
+    UNIT_TEST(0, tiny_stl::lower_bound(vb.begin(), vb.end(), 0) - vb.begin());
+    UNIT_TEST(7, tiny_stl::upper_bound(vb.begin(), vb.end(), 13) - vb.begin());
+    UNIT_TEST(true, tiny_stl::binary_search(vb.begin(), vb.end(), 8));
+    UNIT_TEST(false, tiny_stl::binary_search(vb.begin(), vb.end(), 9));
+    tiny_stl::list<int> lb(vb.begin(), vb.end());
+    UNIT_TEST(5, *tiny_stl::upper_bound(lb.begin(), lb.end(), 3));
+
+    int bkeys[] = {13, 0, 3, 4, 20};
+    tiny_stl::vector<int>::iterator bres[5];
+    UNIT_TEST(true, bres + 5 == tiny_stl::lower_bound_many(
+                                    vb.begin(), vb.end(), bkeys, bkeys + 5,
+                                    bres));
+    UNIT_TEST(6, bres[0] - vb.begin());
+    UNIT_TEST(0, bres[1] - vb.begin());
+    UNIT_TEST(1, bres[2] - vb.begin());
+    UNIT_TEST(4, bres[3] - vb.begin());
+    UNIT_TEST(true, bres[4] == vb.end());
+
+    tiny_stl::vector<signed char> vc(100, 1);
+    vc[70] = vc[90] = -3;
+    vc[30] = vc[95] = 9;
+    UNIT_TEST(70, tiny_stl::find(vc.begin(), vc.end(), -3) - vc.begin());
+    UNIT_TEST(true, tiny_stl::find(vc.begin(), vc.end(), 300) == vc.end());
+    UNIT_TEST(96, tiny_stl::count(vc.cbegin(), vc.cend(), 1));
+    UNIT_TEST(70, tiny_stl::min_element(vc.begin(), vc.end()) - vc.begin());
+    UNIT_TEST(30, tiny_stl::max_element(vc.begin(), vc.end()) - vc.begin());
+    auto pc = tiny_stl::minmax_element(vc.begin(), vc.end());
+    UNIT_TEST(70, pc.first - vc.begin());
+    UNIT_TEST(95, pc.second - vc.begin());
+
+    tiny_stl::vector<unsigned> vu(50, 7u);
+    vu[10] = UINT_MAX;
+    vu[40] = 0;
+    UNIT_TEST(48, tiny_stl::count(vu.begin(), vu.end(), 7));
+    UNIT_TEST(40, tiny_stl::min_element(vu.begin(), vu.end()) - vu.begin());
+    UNIT_TEST(10, tiny_stl::max_element(vu.begin(), vu.end()) - vu.begin());
+
+    tiny_stl::vector<double> vf(64, 2.0);
+    vf[5] = std::nan("");
+    vf[40] = -1.0;
+    vf[50] = 8.0;
+    UNIT_TEST(50, tiny_stl::find(vf.begin(), vf.end(), 8) - vf.begin());
+    UNIT_TEST(true, tiny_stl::find(vf.begin(), vf.end(), 2.5) == vf.end());
+    UNIT_TEST(61, tiny_stl::count(vf.begin(), vf.end(), 2.0));
+    UNIT_TEST(40, tiny_stl::min_element(vf.begin(), vf.end()) - vf.begin());
+    UNIT_TEST(50, tiny_stl::max_element(vf.begin(), vf.end()) - vf.begin());
+    UNIT_TEST(5, tiny_stl::max_element(vf.begin() + 5, vf.end()) - vf.begin());
+
+    tiny_stl::array<long long, 40> al{};
+    al[33] = -5;
+    UNIT_TEST(33, tiny_stl::find(al.begin(), al.end(), -5) - al.begin());
+    auto ml = tiny_stl::min_element(al.cbegin(), al.cend());
+    UNIT_TEST(33, ml - al.cbegin());
+    auto pl = tiny_stl::minmax_element(al.begin(), al.end());
+    UNIT_TEST(33, pl.first - al.begin());
+    UNIT_TEST(39, pl.second - al.begin());
+
+    tiny_stl::string sa(100, 'a');
+    sa[77] = 'z';
+    UNIT_TEST(77, tiny_stl::find(sa.begin(), sa.end(), 'z') - sa.begin());
+    UNIT_TEST(99, tiny_stl::count(sa.cbegin(), sa.cend(), 'a'));
+
+    tiny_stl::vector<int> vw(40);
+    for (int i = 0; i < 40; ++i)
+        vw[i] = i % 4;
+    auto ew = tiny_stl::remove(vw.begin(), vw.end(), 2);
+    UNIT_TEST(30, ew - vw.begin());
+    UNIT_TEST(0, tiny_stl::count(vw.begin(), ew, 2));
+    UNIT_TEST(3, vw[29]);
+    ew = tiny_stl::remove_if(vw.begin(), ew, [](int x) { return x != 1; });
+    UNIT_TEST(10, ew - vw.begin());
+    UNIT_TEST(10, tiny_stl::count(vw.begin(), ew, 1));
+
+    tiny_stl::vector<long long> vq = {1, 1, 2, 2, 2, 3, 5, 5, 8, 8, 8, 8,
+                                      9, 9, 9, 9, 9, 9, 9, 9, 10, 11, 11};
+    auto eq = tiny_stl::unique(vq.begin(), vq.end());
+    UNIT_TEST(8, eq - vq.begin());
+    UNIT_TEST(true, tiny_stl::is_sorted(vq.begin(), eq));
+    UNIT_TEST(11, vq[7]);
+    tiny_stl::list<int> lq = {1, 2, 4, 5, 7, 9, 10};
+    auto lqe = tiny_stl::unique(lq.begin(), lq.end(),
+                                [](int a, int b) { return b - a < 2; });
+    UNIT_TEST(4, tiny_stl::distance(lq.begin(), lqe));
+    UNIT_TEST(9, *--lqe);
+
+    auto odd = [](int x) { return x % 2 != 0; };
+    tiny_stl::vector<int> vp = {2, 7, 4, 1, 8, 3, 6, 5};
+    auto pp = tiny_stl::partition(vp.begin(), vp.end(), odd);
+    UNIT_TEST(4, pp - vp.begin());
+    UNIT_TEST(true, tiny_stl::all_of(vp.begin(), pp, odd));
+    UNIT_TEST(true, tiny_stl::none_of(pp, vp.end(), odd));
+    tiny_stl::list<tiny_stl::string> lp = {"ab", "c", "de", "f", "gh"};
+    auto lpp = tiny_stl::stable_partition(
+        lp.begin(), lp.end(),
+        [](const tiny_stl::string& s) { return s.size() == 1; });
+    UNIT_TEST("c", *lp.begin());
+    UNIT_TEST("f", *--lpp);
+    UNIT_TEST("gh", lp.back());
+    vp = {2, 7, 4, 1, 8, 3, 6, 5};
+    pp = tiny_stl::stable_partition(vp.begin(), vp.end(), odd);
+    UNIT_TEST(7, vp[0]);
+    UNIT_TEST(5, vp[3]);
+    UNIT_TEST(2, *pp);
+
+    int sx[] = {1, 2, 2, 4, 6, 9};
+    int sy[] = {2, 2, 3, 6, 7};
+    int so[11];
+    UNIT_TEST(8, tiny_stl::set_union(sx, sx + 6, sy, sy + 5, so) - so);
+    UNIT_TEST(7, so[6]);
+    UNIT_TEST(3, tiny_stl::set_intersection(sx, sx + 6, sy, sy + 5, so) - so);
+    UNIT_TEST(6, so[2]);
+    UNIT_TEST(3, tiny_stl::set_difference(sx, sx + 6, sy, sy + 5, so) - so);
+    UNIT_TEST(9, so[2]);
+    tiny_stl::vector<int> vt(1000);
+    for (int i = 0; i < 1000; ++i)
+        vt[i] = i * 3;
+    UNIT_TEST(2, tiny_stl::set_intersection(vt.begin(), vt.end(), sx, sx + 6,
+                                            so) -
+                     so);
+    UNIT_TEST(9, so[1]);
+
 #if 0
     tiny_stl::vector<int> bigNums(100'000'000);
     for (int i = 0; i < 100'000'000; ++i)
@@ -266,6 +519,72 @@ void testAlgorithm() {
 #endif
 }
 
+void testNumeric() {
+    tiny_stl::vector<int> v1;
+    for (int i = 1; i <= 100; ++i)
+        v1.push_back(i);
+    UNIT_TEST(5050, tiny_stl::accumulate(v1.begin(), v1.end(), 0));
+    UNIT_TEST(5050, tiny_stl::reduce(v1.begin(), v1.end()));
+    UNIT_TEST(5051, tiny_stl::reduce(v1.begin(), v1.end(), 1));
+    auto maxOp = [](int a, int b) { return a > b ? a : b; };
+    UNIT_TEST(100, tiny_stl::reduce(v1.begin(), v1.end(), 0, maxOp));
+    UNIT_TEST(338350,
+              tiny_stl::inner_product(v1.begin(), v1.end(), v1.begin(), 0));
+    UNIT_TEST(338350, tiny_stl::transform_reduce(v1.begin(), v1.end(),
+                                                 v1.begin(), 0));
+    UNIT_TEST(10100,
+              tiny_stl::transform_reduce(v1.begin(), v1.end(), 0,
+                                         tiny_stl::plus<>{},
+                                         [](int x) { return 2 * x; }));
+
+    // the reduce and scan overloads of lists take one element at a time
+    tiny_stl::list<double> l1 = {0.5, 1.5, 2.0};
+    UNIT_TEST(4.0, tiny_stl::reduce(l1.begin(), l1.end()));
+    UNIT_TEST(4.0, tiny_stl::accumulate(l1.begin(), l1.end(), 0.0));
+
+    tiny_stl::vector<int> v2(100);
+    tiny_stl::inclusive_scan(v1.begin(), v1.end(), v2.begin());
+    UNIT_TEST(1, v2[0]);
+    UNIT_TEST(6, v2[2]);
+    UNIT_TEST(5050, v2[99]);
+    tiny_stl::exclusive_scan(v1.begin(), v1.end(), v2.begin(), 10);
+    UNIT_TEST(10, v2[0]);
+    UNIT_TEST(13, v2[2]);
+    UNIT_TEST(4960, v2[99]);
+    tiny_stl::vector<int> v3 = {1, 2, 3, 4, 5, 6};
+    tiny_stl::inclusive_scan(v3.begin(), v3.end(), v3.begin(),
+                             tiny_stl::multiplies<>{});
+    UNIT_TEST(720, v3[5]);
+    UNIT_TEST(24, v3[3]);
+    tiny_stl::adjacent_difference(v3.begin(), v3.end(), v3.begin());
+    UNIT_TEST(1, v3[0]);
+    UNIT_TEST(1, v3[1]);
+    UNIT_TEST(600, v3[5]);
+
+    tiny_stl::vector<tiny_stl::string> v4 = {"a", "b", "c"};
+    tiny_stl::vector<tiny_stl::string> v5(3);
+    tiny_stl::exclusive_scan(v4.begin(), v4.end(), v5.begin(),
+                             tiny_stl::string("x"));
+    UNIT_TEST(true, v5[2] == "xab");
+
+    // long enough to be split between threads where there are several
+    tiny_stl::vector<float> v6(300000, 1.0f);
+    UNIT_TEST(300000.0f, tiny_stl::reduce(tiny_stl::execution::par,
+                                          v6.begin(), v6.end()));
+    UNIT_TEST(600000.0, tiny_stl::transform_reduce(
+                            tiny_stl::execution::par, v6.begin(), v6.end(),
+                            0.0, tiny_stl::plus<>{},
+                            [](float x) { return 2.0 * x; }));
+    tiny_stl::inclusive_scan(tiny_stl::execution::par, v6.begin(), v6.end(),
+                             v6.begin());
+    UNIT_TEST(1.0f, v6[0]);
+    UNIT_TEST(200000.0f, v6[199999]);
+    UNIT_TEST(300000.0f, v6[299999]);
+    tiny_stl::exclusive_scan(tiny_stl::execution::seq, v1.begin(), v1.end(),
+                             v2.begin(), 0);
+    UNIT_TEST(4950, v2[99]);
+}
+
 void testArray() {
     tiny_stl::array<std::int32_t, 10> arr;
     arr.assign(42);
@@ -366,6 +685,14 @@ void testVector() {
     v10 = tiny_stl::move(v9); // v10 = move(v9);
     UNIT_TEST(3, v10.size());
     UNIT_TEST(0, v10[0]);
+    // move assignment frees the elements it replaces
+    auto spOld = tiny_stl::make_shared<int>(1);
+    tiny_stl::vector<tiny_stl::shared_ptr<int>> vsp1(4, spOld);
+    tiny_stl::vector<tiny_stl::shared_ptr<int>> vsp2(2, spOld);
+    UNIT_TEST(7, spOld.use_count());
+    vsp1 = tiny_stl::move(vsp2);
+    UNIT_TEST(3, spOld.use_count());
+    UNIT_TEST(2, vsp1.size());
     tiny_stl::vector<int> v11{1, 2, 3};
     v11.emplace(v11.end(), 4);
     UNIT_TEST(4, v11.size());
@@ -384,6 +711,17 @@ void testVector() {
     UNIT_TEST(6, v12.size());
     UNIT_TEST(4, v12[0].size());
     UNIT_TEST(3, v12[1].size());
+    // range insert without reallocation, before and at the old end
+    tiny_stl::list<tiny_stl::vector<int>> l12 = {{9}, {8, 8}};
+    v12.reserve(20);
+    v12.insert(v12.begin() + 5, l12.begin(), l12.end());
+    UNIT_TEST(8, v12.size());
+    UNIT_TEST(9, v12[5][0]);
+    UNIT_TEST(2, v12[6].size());
+    UNIT_TEST(6, v12[7][3]);
+    v12.insert(v12.end(), l12.begin(), ++l12.begin());
+    UNIT_TEST(9, v12.size());
+    UNIT_TEST(9, v12[8][0]);
     tiny_stl::vector<int> v13 = {1, 2, 3, 4, 5, 6};
     auto iter1 = v13.erase(v13.begin());
     UNIT_TEST(5, v13.size());
@@ -404,6 +742,258 @@ void testVector() {
     UNIT_TEST(10, v16.size());
     UNIT_TEST(42, v16.front());
     UNIT_TEST(42, v16.back());
+
+    tiny_stl::vector<tiny_stl::string> v17(3);
+    UNIT_TEST(true, v17[2].empty());
+    v17.resize(40, "x");
+    UNIT_TEST(40, v17.size());
+    UNIT_TEST(true, v17[39] == "x");
+
+    // packed vector<bool>
+    tiny_stl::vector<bool> vb1(200, false);
+    UNIT_TEST(200, vb1.size());
+    UNIT_TEST(0, tiny_stl::count(vb1.begin(), vb1.end(), true));
+    vb1[3] = true;
+    vb1[130] = true;
+    UNIT_TEST(true, vb1[130]);
+    UNIT_TEST(2, tiny_stl::count(vb1.cbegin(), vb1.cend(), true));
+    UNIT_TEST(3, tiny_stl::find(vb1.begin(), vb1.end(), true) - vb1.begin());
+    UNIT_TEST(130, tiny_stl::find(vb1.begin() + 4, vb1.end(), true) -
+                       vb1.begin());
+    tiny_stl::fill(vb1.begin() + 60, vb1.begin() + 190, true);
+    UNIT_TEST(131, tiny_stl::count(vb1.begin(), vb1.end(), true));
+    UNIT_TEST(190, tiny_stl::find(vb1.begin() + 60, vb1.end(), false) -
+                       vb1.begin());
+
+    tiny_stl::vector<bool> vb2(vb1.begin() + 1, vb1.end());
+    UNIT_TEST(true, tiny_stl::equal(vb2.begin(), vb2.end(), vb1.begin() + 1));
+    UNIT_TEST(false, tiny_stl::equal(vb2.begin(), vb2.end(), vb1.begin()));
+    vb2.insert(vb2.begin(), true);
+    vb2[0] = vb1[0];
+    UNIT_TEST(true, vb1 == vb2);
+
+    vb2.erase(vb2.begin() + 2, vb2.begin() + 70);
+    UNIT_TEST(132, vb2.size());
+    UNIT_TEST(false, vb2[1]);
+    UNIT_TEST(true, vb2[2]);
+    UNIT_TEST(true, vb2[121]);
+    UNIT_TEST(false, vb2[122]);
+    vb2.flip();
+    UNIT_TEST(true, vb2[1]);
+    tiny_stl::vector<bool>::swap(vb2[1], vb2[2]);
+    UNIT_TEST(false, vb2[1]);
+    UNIT_TEST(true, vb2[2]);
+
+    tiny_stl::vector<bool> vb3 = {true, false, true};
+    vb3.push_back(true);
+    vb3.pop_back();
+    vb3.resize(70, true);
+    UNIT_TEST(69, tiny_stl::count(vb3.begin(), vb3.end(), true));
+    UNIT_TEST(1, tiny_stl::find(vb3.rbegin(), vb3.rend(), false).base() -
+                     vb3.begin() - 1);
+}
+
+// copies fail once the shared budget is used up
+struct CopyBudget {
+    tiny_stl::shared_ptr<int> left;
+
+    explicit CopyBudget(const tiny_stl::shared_ptr<int>& budget)
+        : left(budget) {
+    }
+
+    CopyBudget(const CopyBudget& rhs) : left(rhs.left) {
+        if ((*left)-- == 0)
+            throw "copy budget exhausted";
+    }
+
+    CopyBudget& operator=(const CopyBudget&) = default;
+};
+
+void testSmallVector() {
+    tiny_stl::small_vector<int, 4> sv1 = {1, 2, 3};
+    UNIT_TEST(3, sv1.size());
+    UNIT_TEST(4, sv1.capacity());
+    sv1.push_back(4);
+    UNIT_TEST(4, sv1.capacity());
+    sv1.push_back(5); // spill to heap
+    UNIT_TEST(5, sv1.size());
+    UNIT_TEST(8, sv1.capacity());
+    UNIT_TEST(1, sv1.front());
+    UNIT_TEST(5, sv1.back());
+    sv1.erase(sv1.begin() + 1, sv1.end() - 1);
+    sv1.shrink_to_fit(); // back to inline
+    UNIT_TEST(4, sv1.capacity());
+    UNIT_TEST(2, sv1.size());
+    UNIT_TEST(5, sv1[1]);
+    sv1.insert(sv1.begin() + 1, 5, 0); // 1 0 0 0 0 0 5
+    UNIT_TEST(7, sv1.size());
+    UNIT_TEST(0, sv1[5]);
+    UNIT_TEST(5, sv1[6]);
+    sv1.emplace(sv1.begin(), sv1.back());
+    UNIT_TEST(5, sv1[0]);
+
+    tiny_stl::small_vector<int, 4> sv2 = {1, 2};
+    tiny_stl::small_vector<int, 4> sv3 = tiny_stl::move(sv1);
+    UNIT_TEST(8, sv3.size());
+    UNIT_TEST(true, sv1.empty());
+    sv2.swap(sv3);
+    UNIT_TEST(8, sv2.size());
+    UNIT_TEST(2, sv3.size());
+    UNIT_TEST(true, sv3 < sv2);
+    sv3.insert(sv3.begin() + 1, {7, 8, 9}); // 1 7 8 9 2
+    UNIT_TEST(5, sv3.size());
+    UNIT_TEST(9, sv3[3]);
+    UNIT_TEST(2, sv3[4]);
+    sv3.resize(2, sv3[1]);
+    UNIT_TEST(7, sv3.back());
+    sv3.resize(5, sv3[1]);
+    UNIT_TEST(7, sv3[4]);
+
+    tiny_stl::small_vector<tiny_stl::string, 2> sv4(3, "abc");
+    sv4.emplace(sv4.begin() + 1, "xyz");
+    sv4.insert(sv4.begin(), sv4[1]);
+    UNIT_TEST(5, sv4.size());
+    UNIT_TEST("xyz", sv4[0]);
+    UNIT_TEST("abc", sv4[4]);
+    sv4.erase(sv4.begin(), sv4.begin() + 4);
+    sv4.shrink_to_fit();
+    tiny_stl::small_vector<tiny_stl::string, 2> sv5 = sv4;
+    sv5.push_back("def");
+    UNIT_TEST(2, sv5.size());
+    UNIT_TEST("def", sv5[1]);
+    sv4 = tiny_stl::move(sv5);
+    UNIT_TEST(2, sv4.size());
+    UNIT_TEST("abc", sv4.front());
+
+    // spilling to the heap copies the elements, a copy that throws part way
+    // leaves the vector as it was
+    auto budget = tiny_stl::make_shared<int>(100);
+    const CopyBudget cb(budget);
+    tiny_stl::small_vector<CopyBudget, 2> svb(2, cb);
+    UNIT_TEST(4, budget.use_count());
+    *budget = 2;
+    try {
+        svb.insert(svb.begin() + 1, cb);
+        UNIT_TEST(true, false);
+    } catch (const char*) {
+        UNIT_TEST(2, svb.size());
+        UNIT_TEST(4, budget.use_count());
+    }
+}
+
+void testStaticVector() {
+    constexpr tiny_stl::static_vector<int, 4> csv;
+    static_assert(csv.empty() && csv.capacity() == 4, "");
+    UNIT_TEST(true, (tiny_stl::is_trivially_copyable<
+                        tiny_stl::static_vector<int, 4>>::value));
+    UNIT_TEST(false, (tiny_stl::is_trivially_copyable<
+                         tiny_stl::static_vector<tiny_stl::string, 4>>::value));
+
+    tiny_stl::static_vector<int, 4> sv1 = {1, 2, 3};
+    UNIT_TEST(3, sv1.size());
+    sv1.push_back(4);
+    UNIT_TEST(true, sv1.full());
+    UNIT_TEST(true, sv1.try_push_back(5) == nullptr);
+    UNIT_TEST(4, sv1.size());
+    sv1.erase(sv1.begin());
+    UNIT_TEST(5, *sv1.try_emplace_back(5));
+    UNIT_TEST(2, sv1.front());
+    sv1.erase(sv1.begin() + 1, sv1.end()); // 2
+    sv1.insert(sv1.begin(), 2, 7);         // 7 7 2
+    sv1.emplace(sv1.begin() + 1, sv1.back());
+    UNIT_TEST(4, sv1.size());
+    UNIT_TEST(2, sv1[1]);
+    UNIT_TEST(2, sv1[3]);
+    tiny_stl::static_vector<int, 4> sv2 = sv1;
+    UNIT_TEST(true, sv1 == sv2);
+    sv2.resize(1);
+    UNIT_TEST(true, sv2 < sv1);
+
+    tiny_stl::static_vector<tiny_stl::string, 3> sv3(2, "abc");
+    tiny_stl::static_vector<tiny_stl::string, 3> sv4 = {"x"};
+    sv4.insert(sv4.begin(), {"y", "z"}); // y z x
+    UNIT_TEST("z", sv4[1]);
+    UNIT_TEST("x", sv4.back());
+    sv3.swap(sv4);
+    UNIT_TEST(3, sv3.size());
+    UNIT_TEST(2, sv4.size());
+    UNIT_TEST("y", sv3.front());
+    UNIT_TEST("abc", sv4.back());
+    sv4 = tiny_stl::move(sv3);
+    UNIT_TEST(3, sv4.size());
+    sv4.pop_back();
+    sv4.resize(3, sv4[0]);
+    UNIT_TEST("y", sv4[2]);
+    try {
+        sv4.at(3);
+        UNIT_TEST(true, false);
+    } catch (const char*) {
+        UNIT_TEST(true, true);
+    }
+
+    // a copy that throws part way leaves no element behind
+    auto budget = tiny_stl::make_shared<int>(100);
+    tiny_stl::static_vector<CopyBudget, 4> svb1(3, CopyBudget(budget));
+    tiny_stl::static_vector<CopyBudget, 4> svb2(1, CopyBudget(budget));
+    UNIT_TEST(5, budget.use_count());
+    *budget = 1;
+    try {
+        tiny_stl::static_vector<CopyBudget, 4> svb3(svb1);
+        UNIT_TEST(true, false);
+    } catch (const char*) {
+        UNIT_TEST(5, budget.use_count());
+    }
+    *budget = 1;
+    try {
+        svb2 = svb1;
+        UNIT_TEST(true, false);
+    } catch (const char*) {
+        UNIT_TEST(0, svb2.size());
+        UNIT_TEST(4, budget.use_count());
+    }
+}
+
+void testDynamicBitset() {
+    tiny_stl::dynamic_bitset<> b1(150);
+    tiny_stl::dynamic_bitset<> b2(150, true);
+    UNIT_TEST(150, b1.size());
+    UNIT_TEST(3, b1.num_blocks());
+    UNIT_TEST(true, b1.none());
+    UNIT_TEST(150, b2.count());
+    UNIT_TEST(true, b2.all());
+
+    b1.set(3).set(64).set(149);
+    UNIT_TEST(3, b1.count());
+    UNIT_TEST(3, b1.find_first());
+    UNIT_TEST(64, b1.find_next(3));
+    UNIT_TEST(149, b1.find_next(64));
+    UNIT_TEST(tiny_stl::dynamic_bitset<>::npos, b1.find_next(149));
+
+    b2.reset(64);
+    auto b3 = b1 & b2;
+    UNIT_TEST(2, b3.count());
+    UNIT_TEST(false, b3.test(64));
+    b3.assign_or(b1, b2);
+    UNIT_TEST(150, b3.count());
+    b3.assign_and_not(b2, b1);
+    UNIT_TEST(147, b3.count());
+    b3 ^= b2;
+    UNIT_TEST(2, b3.count());
+    UNIT_TEST(true, b3 == (b1 - (b1 - b2)));
+    b3 -= b1;
+    UNIT_TEST(true, b3.none());
+
+    b1.flip();
+    UNIT_TEST(147, b1.count());
+    UNIT_TEST(true, b1 == ~(~b1));
+    b1.resize(200, true);
+    UNIT_TEST(197, b1.count());
+    b1.push_back(false);
+    UNIT_TEST(201, b1.size());
+    b1.resize(10);
+    UNIT_TEST(9, b1.count());
+    UNIT_TEST(0, b1.find_first());
+    UNIT_TEST(4, b1.find_next(2));
 }
 
 void testList() {
@@ -503,6 +1093,42 @@ void testList() {
     tiny_stl::list<int> l7 = {3, 4, 2, 1, 5, 6, 0, 7};
     l7.sort();
     UNIT_TEST(true, tiny_stl::is_sorted(l7.begin(), l7.end()));
+    UNIT_TEST(8, l7.size());
+    UNIT_TEST(7, l7.back());
+    UNIT_TEST(6, *--(--l7.end()));
+
+    tiny_stl::list<int> l8;
+    for (int i = 0; i < 1000; ++i)
+        l8.push_back(rand() % 100);
+    l8.sort(tiny_stl::greater<>{});
+    UNIT_TEST(1000, l8.size());
+    UNIT_TEST(true, tiny_stl::is_sorted(l8.rbegin(), l8.rend()));
+    l8.unique();
+    UNIT_TEST(true, l8.size() <= 100);
+
+    // stable: equal keys keep their order
+    tiny_stl::list<tiny_stl::pair<int, int>> l9 = {
+        {2, 0}, {1, 1}, {2, 2}, {1, 3}, {0, 4}, {2, 5}};
+    l9.sort([](const tiny_stl::pair<int, int>& lhs,
+               const tiny_stl::pair<int, int>& rhs) {
+        return lhs.first < rhs.first;
+    });
+    UNIT_TEST(4, l9.front().second);
+    UNIT_TEST(1, (++l9.begin())->second);
+    UNIT_TEST(5, l9.back().second);
+
+    tiny_stl::list<int> l10 = {1, 2, 1, 3, 1};
+    l10.remove(l10.front()); // val refers to an element
+    UNIT_TEST(2, l10.size());
+    UNIT_TEST(2, l10.front());
+    l10.remove_if([](int x) { return x == 2; });
+    UNIT_TEST(1, l10.size());
+    UNIT_TEST(3, l10.back());
+    l10 = {1, 2, 3};
+    l10.reverse();
+    UNIT_TEST(3, l10.front());
+    UNIT_TEST(1, l10.back());
+    UNIT_TEST(2, *--(--l10.end()));
 }
 
 void testForwardList() {
@@ -572,6 +1198,27 @@ void testForwardList() {
     fl12.sort();
     UNIT_TEST(true, is_sorted(fl12.begin(), fl12.end()));
     // print_elements(t);
+
+    tiny_stl::forward_list<int> fl13;
+    for (int i = 0; i < 1000; ++i)
+        fl13.push_front(rand() % 100);
+    fl13.sort(tiny_stl::greater<>{});
+    UNIT_TEST(1000, tiny_stl::distance(fl13.begin(), fl13.end()));
+    UNIT_TEST(true,
+              is_sorted(fl13.begin(), fl13.end(), tiny_stl::greater<>{}));
+
+    // stable: equal keys keep their order
+    tiny_stl::forward_list<tiny_stl::pair<int, int>> fl14 = {
+        {2, 0}, {1, 1}, {2, 2}, {1, 3}, {0, 4}, {2, 5}};
+    fl14.sort([](const tiny_stl::pair<int, int>& lhs,
+                 const tiny_stl::pair<int, int>& rhs) {
+        return lhs.first < rhs.first;
+    });
+    auto iter1 = fl14.begin();
+    UNIT_TEST(4, (iter1++)->second);
+    UNIT_TEST(1, (iter1++)->second);
+    UNIT_TEST(3, (iter1++)->second);
+    UNIT_TEST(0, (iter1++)->second);
 }
 
 void testDeque() {
@@ -652,6 +1299,198 @@ void testDeque() {
     UNIT_TEST(10, d5.size());
     d5.resize(4);
     UNIT_TEST(4, d5.size());
+
+    // algorithms that walk the deque block by block
+    tiny_stl::deque<int> d6;
+    for (int i = 0; i < 1000; ++i)
+        d6.push_front(i); // 999 ... 0
+    tiny_stl::deque<int> d7(d6.begin() + 100, d6.begin() + 900);
+    UNIT_TEST(899, d7.front());
+    UNIT_TEST(100, d7.back());
+    tiny_stl::copy(d6.begin() + 300, d6.begin() + 700, d7.begin() + 1);
+    UNIT_TEST(699, d7[1]);
+    UNIT_TEST(300, d7[400]);
+    UNIT_TEST(498, d7[401]);
+    tiny_stl::copy_backward(d7.begin(), d7.begin() + 500, d7.begin() + 600);
+    UNIT_TEST(899, d7[100]);
+    UNIT_TEST(300, d7[500]);
+    tiny_stl::fill(d7.begin() + 10, d7.end() - 10, 7);
+    UNIT_TEST(780, tiny_stl::count(d7.begin(), d7.end(), 7));
+    UNIT_TEST(10, tiny_stl::find(d7.begin(), d7.end(), 7) - d7.begin());
+    UNIT_TEST(true, tiny_stl::find(d7.begin(), d7.end(), -1) == d7.end());
+    tiny_stl::sort(d6.begin(), d6.end());
+    UNIT_TEST(true, tiny_stl::is_sorted(d6.begin(), d6.end()));
+    UNIT_TEST(500, d6[500]);
+    tiny_stl::partial_sort(d7.begin(), d7.begin() + 400, d7.end());
+    UNIT_TEST(true, tiny_stl::is_sorted(d7.begin(), d7.begin() + 400));
+    int sum = 0;
+    tiny_stl::for_each(d6.begin(), d6.end(), [&sum](int x) { sum += x; });
+    UNIT_TEST(499500, sum);
+
+    tiny_stl::deque<tiny_stl::string> d8(300, "abc");
+    d8.insert(d8.begin() + 10, 0, "x");
+    d8.erase(d8.end(), d8.end());
+    UNIT_TEST(300, d8.size());
+    UNIT_TEST("abc", d8[10]);
+    tiny_stl::fill_n(d8.begin() + 100, 150, "x");
+    UNIT_TEST("x", d8[249]);
+    UNIT_TEST("abc", d8[250]);
+
+    // block size policy, buffers released at one end are reused at the other
+    using SmallBlock = tiny_stl::integral_constant<std::size_t, 4>;
+    tiny_stl::deque<int, tiny_stl::allocator<int>, SmallBlock> d9;
+    UNIT_TEST(4, decltype(d9)::iterator::buffer_size());
+    for (int i = 0; i < 100; ++i) {
+        d9.push_back(i);
+        d9.push_back(i);
+        d9.pop_front();
+    }
+    UNIT_TEST(100, d9.size());
+    UNIT_TEST(50, d9.front());
+    UNIT_TEST(99, d9.back());
+    d9.clear();
+    d9.push_front(1);
+    UNIT_TEST(1, d9.size());
+    UNIT_TEST(1, d9.front());
+    for (int i = 0; i < 1000; ++i)
+        d9.push_back(i);
+    while (d9.size() > 10)
+        d9.pop_front();
+    const int* p9 = &d9.back();
+    d9.shrink_to_fit();
+    UNIT_TEST(10, d9.size());
+    UNIT_TEST(990, d9.front());
+    UNIT_TEST(true, p9 == &d9.back());
+    d9.push_front(-1);
+    d9.push_back(1000);
+    UNIT_TEST(-1, d9.front());
+    UNIT_TEST(1000, d9.back());
+    UNIT_TEST(999, d9[10]);
+
+    struct Big {
+        char data[1024];
+    };
+    UNIT_TEST(16, tiny_stl::deque<Big>::iterator::buffer_size());
+}
+
+void testCircularBuffer() {
+    tiny_stl::circular_buffer<int> cb1;
+    for (int i = 0; i < 10; ++i)
+        cb1.push_back(i);
+    UNIT_TEST(10, cb1.size());
+    UNIT_TEST(16, cb1.capacity());
+    cb1.pop_front();
+    cb1.pop_front();
+    cb1.push_front(-1);
+    UNIT_TEST(-1, cb1.front());
+    UNIT_TEST(9, cb1.back());
+    UNIT_TEST(2, cb1[1]);
+    UNIT_TEST(9, cb1.end() - cb1.begin());
+
+    // a window of the latest 4 values
+    using Window = tiny_stl::circular_buffer<int>;
+    Window cb2(3, Window::full_policy::overwrite);
+    UNIT_TEST(4, cb2.capacity());
+    for (int i = 1; i <= 6; ++i)
+        cb2.push_back(i);
+    UNIT_TEST(4, cb2.size());
+    UNIT_TEST(true, cb2.full());
+    UNIT_TEST(3, cb2.front());
+    UNIT_TEST(6, cb2.back());
+
+    // [3, 4] at the end of the storage, [5, 6] wrapped to the start
+    auto one = cb2.array_one();
+    auto two = cb2.array_two();
+    UNIT_TEST(2, one.second);
+    UNIT_TEST(2, two.second);
+    UNIT_TEST(3, one.first[0]);
+    UNIT_TEST(6, two.first[1]);
+
+    tiny_stl::vector<int> v1(4);
+    tiny_stl::copy(cb2.begin(), cb2.end(), v1.begin());
+    tiny_stl::vector<int> v2 = {3, 4, 5, 6};
+    UNIT_TEST(true, v1 == v2);
+    UNIT_TEST(2, tiny_stl::find(cb2.begin(), cb2.end(), 5) - cb2.begin());
+    tiny_stl::fill(cb2.begin() + 1, cb2.end(), 0);
+    UNIT_TEST(3, tiny_stl::count(cb2.begin(), cb2.end(), 0));
+
+    Window cb3 = cb2;
+    UNIT_TEST(true, cb3 == cb2);
+    cb3.push_front(7);
+    UNIT_TEST(7, cb3.front());
+    UNIT_TEST(0, cb3.back());
+    UNIT_TEST(4, cb3.size());
+
+    tiny_stl::queue<int, tiny_stl::circular_buffer<int>> q1;
+    for (int i = 0; i < 20; ++i)
+        q1.push(i);
+    q1.pop();
+    UNIT_TEST(1, q1.front());
+    UNIT_TEST(19, q1.back());
+    tiny_stl::stack<int, tiny_stl::circular_buffer<int>> s1;
+    s1.push(1);
+    s1.push(2);
+    UNIT_TEST(2, s1.top());
+}
+
+void testSearchIndex() {
+    tiny_stl::vector<int> v1;
+    for (int i = 0; i < 100; ++i)
+        v1.push_back(i / 2 * 3); // 0 0 3 3 6 6 ...
+
+    tiny_stl::eytzinger_index<int> e1(v1);
+    UNIT_TEST(100, e1.size());
+    UNIT_TEST(0, e1.lower_bound(-1));
+    UNIT_TEST(2, e1.lower_bound(3));
+    UNIT_TEST(4, e1.upper_bound(3));
+    UNIT_TEST(4, e1.lower_bound(4));
+    UNIT_TEST(100, e1.lower_bound(148));
+    UNIT_TEST(100, e1.upper_bound(147));
+    UNIT_TEST(true, e1.contains(147));
+    UNIT_TEST(false, e1.contains(146));
+    UNIT_TEST(2, e1.count(9));
+
+    tiny_stl::s_tree<int> s1(v1);
+    UNIT_TEST(100, s1.size());
+    UNIT_TEST(0, s1.lower_bound(-1));
+    UNIT_TEST(2, s1.lower_bound(3));
+    UNIT_TEST(4, s1.upper_bound(3));
+    UNIT_TEST(98, s1.lower_bound(146));
+    UNIT_TEST(100, s1.lower_bound(148));
+    UNIT_TEST(true, s1.contains(0));
+    UNIT_TEST(false, s1.contains(1));
+    UNIT_TEST(147, s1[99]);
+
+    // every rank of a sequence that fills several layers
+    tiny_stl::vector<double> v2;
+    for (int i = 0; i < 1000; ++i)
+        v2.push_back(i * 0.5);
+    tiny_stl::eytzinger_index<double> e2(v2);
+    tiny_stl::s_tree<double> s2(v2);
+    bool ok = true;
+    for (std::size_t i = 0; i < 1000; ++i) {
+        const double x = static_cast<double>(i) * 0.5;
+        ok = ok && e2.lower_bound(x) == i;
+        ok = ok && e2.upper_bound(x - 0.25) == i;
+        ok = ok && s2.lower_bound(x) == i;
+        ok = ok && s2.upper_bound(x + 0.25) == i + 1;
+    }
+    UNIT_TEST(true, ok);
+
+    using Greater = tiny_stl::greater<tiny_stl::string>;
+    tiny_stl::vector<tiny_stl::string> v3 = {"c", "b", "a"};
+    tiny_stl::s_tree<tiny_stl::string, Greater> s3(v3);
+    UNIT_TEST(1, s3.lower_bound("b"));
+    UNIT_TEST(3, s3.upper_bound("a"));
+    auto s4 = s3;
+    UNIT_TEST(true, s4.contains("c"));
+
+    tiny_stl::eytzinger_index<int> e3;
+    UNIT_TEST(true, e3.empty());
+    UNIT_TEST(0, e3.lower_bound(1));
+    e3 = tiny_stl::move(e1);
+    UNIT_TEST(100, e3.size());
+    UNIT_TEST(2, e3.lower_bound(2));
 }
 
 void testAdaptor() {
@@ -704,6 +1543,208 @@ void testAdaptor() {
     UNIT_TEST(4, pq1.top());
     pq1.push(10);
     UNIT_TEST(10, pq1.top());
+
+    // 4-ary min-heap
+    tiny_stl::priority_queue<int, tiny_stl::vector<int>, tiny_stl::greater<int>,
+                             4>
+        pq2;
+    for (int i = 0; i < 100; ++i)
+        pq2.push((i * 37) % 100);
+    tiny_stl::vector<int> more = {-5, 200, 7, -1};
+    pq2.push_range(more.begin(), more.end());
+    UNIT_TEST(104, pq2.size());
+    UNIT_TEST(-5, pq2.top());
+    pq2.pop();
+    UNIT_TEST(-1, pq2.top());
+    pq2.pop();
+    bool ordered = true;
+    for (int prev = pq2.top(); !pq2.empty(); pq2.pop()) {
+        ordered = ordered && prev <= pq2.top();
+        prev = pq2.top();
+    }
+    UNIT_TEST(true, ordered);
+
+    tiny_stl::top_k<int> tk(3);
+    for (int i = 0; i < 100; ++i)
+        tk.push((i * 37) % 100);
+    UNIT_TEST(3, tk.size());
+    UNIT_TEST(97, tk.threshold());
+    tiny_stl::vector<int> top = tk.sorted();
+    UNIT_TEST(99, top[0]);
+    UNIT_TEST(97, top[2]);
+}
+
+void testIndexedHeap() {
+    // min-queue of distances keyed by vertex, as in Dijkstra
+    tiny_stl::indexed_priority_queue<int, tiny_stl::greater<int>> q1;
+    tiny_stl::vector<std::size_t> h;
+    for (int i = 0; i < 10; ++i)
+        h.push_back(q1.push(100 + i));
+    UNIT_TEST(10, q1.size());
+    UNIT_TEST(100, q1.top());
+
+    q1.decrease_key(h[7], 50);
+    UNIT_TEST(50, q1.top());
+    UNIT_TEST(h[7], q1.top_handle());
+    q1.update(h[7], 200); // moves down
+    UNIT_TEST(100, q1.top());
+    UNIT_TEST(200, q1.value(h[7]));
+    q1.erase(h[0]);
+    UNIT_TEST(false, q1.contains(h[0]));
+    UNIT_TEST(101, q1.top());
+    q1.pop();
+    UNIT_TEST(102, q1.top());
+    UNIT_TEST(8, q1.size());
+
+    std::size_t reused = q1.push(1);
+    UNIT_TEST(true, reused == h[0] || reused == h[1]);
+    UNIT_TEST(1, q1.top());
+
+    int prev = q1.top();
+    bool ordered = true;
+    for (; !q1.empty(); q1.pop()) {
+        ordered = ordered && prev <= q1.top();
+        prev = q1.top();
+    }
+    UNIT_TEST(true, ordered);
+    UNIT_TEST(200, prev);
+
+    using PairingHeap = tiny_stl::pairing_heap<int, tiny_stl::greater<int>>;
+    PairingHeap ph1, ph2;
+    tiny_stl::vector<PairingHeap::handle_type> ph;
+    for (int i = 0; i < 10; ++i)
+        ph.push_back(ph1.push(100 + i));
+    auto other = ph2.push(5);
+    ph1.merge(ph2);
+    UNIT_TEST(11, ph1.size());
+    UNIT_TEST(true, ph2.empty());
+    UNIT_TEST(5, ph1.top());
+    UNIT_TEST(true, ph1.top_handle() == other);
+
+    ph1.decrease_key(ph[9], 1);
+    UNIT_TEST(1, ph1.top());
+    ph1.update(ph[9], 300);
+    UNIT_TEST(300, *ph[9]);
+    ph1.erase(other);
+    UNIT_TEST(100, ph1.top());
+    ph1.erase(ph[4]);
+    UNIT_TEST(9, ph1.size());
+
+    tiny_stl::vector<int> popped;
+    for (; !ph1.empty(); ph1.pop())
+        popped.push_back(ph1.top());
+    tiny_stl::vector<int> expected = {100, 101, 102, 103, 105,
+                                      106, 107, 108, 300};
+    UNIT_TEST(true, popped == expected);
+}
+
+void testSpscQueue() {
+    tiny_stl::spsc_queue<tiny_stl::string> q1(3);
+    UNIT_TEST(4, q1.capacity());
+    UNIT_TEST(true, q1.empty());
+    UNIT_TEST(true, q1.try_push("a"));
+    UNIT_TEST(true, q1.try_emplace(3, 'b'));
+    const char* strs[] = {"c", "d", "e"};
+    UNIT_TEST(2, q1.try_push_n(strs, 3));
+    UNIT_TEST(false, q1.try_push("f"));
+    UNIT_TEST(4, q1.size());
+
+    tiny_stl::string s;
+    UNIT_TEST(true, q1.try_pop(s));
+    UNIT_TEST("a", s);
+    UNIT_TEST("bbb", *q1.front());
+    q1.pop();
+    tiny_stl::string out[4];
+    UNIT_TEST(2, q1.try_pop_n(out, 4));
+    UNIT_TEST("c", out[0]);
+    UNIT_TEST("d", out[1]);
+    UNIT_TEST(true, q1.front() == nullptr);
+    UNIT_TEST(false, q1.try_pop(s));
+    q1.try_push("g"); // destroyed by ~spsc_queue
+
+    // one producer and one consumer thread, FIFO order is kept
+    const int kCount = 100000;
+    tiny_stl::spsc_queue<int> q2(64);
+    std::thread producer([&q2] {
+        int batch[16];
+        for (int i = 0; i < kCount;) {
+            if (i % 3 == 0) {
+                int n = tiny_stl::min(16, kCount - i);
+                for (int j = 0; j < n; ++j)
+                    batch[j] = i + j;
+                i += static_cast<int>(q2.try_push_n(batch, n));
+            } else if (q2.try_push(i)) {
+                ++i;
+            }
+        }
+    });
+
+    bool ordered = true;
+    long long sum = 0;
+    for (int expect = 0; expect < kCount;) {
+        int x;
+        if (q2.try_pop(x)) {
+            ordered = ordered && x == expect;
+            sum += x;
+            ++expect;
+        }
+    }
+    producer.join();
+    UNIT_TEST(true, ordered);
+    UNIT_TEST(4999950000LL, sum);
+    UNIT_TEST(true, q2.empty());
+}
+
+void testMpmcQueue() {
+    tiny_stl::mpmc_queue<tiny_stl::unique_ptr<int>> q1(1);
+    UNIT_TEST(2, q1.capacity());
+    UNIT_TEST(true, q1.try_push(tiny_stl::make_unique<int>(1)));
+    q1.push(tiny_stl::make_unique<int>(2));
+    UNIT_TEST(false, q1.try_emplace(tiny_stl::make_unique<int>(3)));
+    UNIT_TEST(2, q1.size());
+    tiny_stl::unique_ptr<int> p;
+    UNIT_TEST(true, q1.try_pop(p));
+    UNIT_TEST(1, *p);
+    q1.pop(p);
+    UNIT_TEST(2, *p);
+    UNIT_TEST(false, q1.try_pop(p));
+    q1.emplace(new int(4)); // destroyed by ~mpmc_queue
+
+    tiny_stl::mpmc_queue<tiny_stl::string> q2(2);
+    const tiny_stl::string str = "copied";
+    q2.push(str);
+    UNIT_TEST(true, q2.try_emplace(3, 'x'));
+    tiny_stl::string s;
+    q2.pop(s);
+    UNIT_TEST("copied", s);
+    q2.pop(s);
+    UNIT_TEST("xxx", s);
+
+    // producers and consumers block on a small queue, nothing is lost
+    const int kPerThread = 20000;
+    tiny_stl::mpmc_queue<int> q3(8);
+    std::atomic<long long> sum(0);
+    tiny_stl::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t) {
+        threads.emplace_back([&q3, t] {
+            for (int i = 1; i <= kPerThread; ++i)
+                q3.push(i * 3 + t);
+        });
+        threads.emplace_back([&q3, &sum] {
+            long long local = 0;
+            for (int i = 0; i < kPerThread; ++i) {
+                int x;
+                q3.pop(x);
+                local += x;
+            }
+            sum += local;
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+    UNIT_TEST(3LL * 3 * kPerThread * (kPerThread + 1) / 2 + 3 * kPerThread,
+              sum.load());
+    UNIT_TEST(true, q3.empty());
 }
 
 void testStringView() {
@@ -962,6 +2003,11 @@ void testString() {
     UNIT_TEST(8, str3.size());
     UNIT_TEST('h', str3.back());
 
+    tiny_stl::string shortA = "short a", shortB = "the short b";
+    shortA.swap(shortB);
+    UNIT_TEST(tiny_stl::string{"the short b"}, shortA);
+    UNIT_TEST(tiny_stl::string{"short a"}, shortB);
+
     str8.push_back('a');
     UNIT_TEST(31, str8.size());
     UNIT_TEST('a', str8.back());
@@ -1121,6 +2167,23 @@ void testSet() {
     }
     UNIT_TEST(true, tiny_stl::is_sorted(s1.begin(), s1.end()));
     UNIT_TEST(1000, s1.size());
+
+    // erase the root while it still has a child
+    tiny_stl::set<int> s2 = {1, 2};
+    s2.erase(1);
+    UNIT_TEST(1, s2.size());
+    UNIT_TEST(2, *s2.begin());
+    s2.erase(2);
+    UNIT_TEST(true, s2.empty());
+    for (int i = 0; i < 1000; ++i)
+        s2.insert(i);
+    for (int i = 0; i < 1000; i += 2)
+        s2.erase(i);
+    UNIT_TEST(500, s2.size());
+    UNIT_TEST(1, *s2.begin());
+    UNIT_TEST(999, *s2.rbegin());
+    tiny_stl::set<int> s3 = s2;
+    UNIT_TEST(true, s3 == s2);
 }
 
 void testMap() {
@@ -1270,6 +2333,10 @@ void testUnorderedMap() {
     UNIT_TEST(8, um.size());
     um[7] = 7.7;
     UNIT_TEST(7.7, um[7]);
+    UNIT_TEST(1, um.erase(7));
+    UNIT_TEST(0, um.count(7));
+    UNIT_TEST(7, um.size());
+    um[7] = 7.7;
 
     // print_element_with_pair(um);
     auto um1 = um;
@@ -1287,17 +2354,135 @@ void testUnorderedMap() {
     UNIT_TEST(7, umm.size());
 }
 
+void testConcurrentUnorderedMap() {
+    tiny_stl::concurrent_unordered_map<int, tiny_stl::string> cm1;
+    UNIT_TEST(true, cm1.empty());
+    UNIT_TEST(true, cm1.insert({1, "one"}));
+    UNIT_TEST(false, cm1.emplace(1, "uno"));
+    UNIT_TEST(true, cm1.insert_or_assign(2, "two"));
+    UNIT_TEST(false, cm1.insert_or_assign(2, "dos"));
+    tiny_stl::string s;
+    UNIT_TEST(true, cm1.find(2, s));
+    UNIT_TEST("dos", s);
+    UNIT_TEST(false, cm1.find(3, s));
+    UNIT_TEST(true, cm1.update(1, [](tiny_stl::string& v) { v += "!"; }));
+    UNIT_TEST(true,
+              cm1.visit(1, [&s](const tiny_stl::string& v) { s = v; }));
+    UNIT_TEST("one!", s);
+    UNIT_TEST(2, cm1.size());
+    UNIT_TEST(1, cm1.erase(1));
+    UNIT_TEST(0, cm1.erase(1));
+    UNIT_TEST(false, cm1.contains(1));
+
+    // shards built with a bucket hint, torn down without leaking their
+    // default buckets (checked under -fsanitize=address)
+    {
+        tiny_stl::concurrent_unordered_map<int, int> cm3(1024);
+        UNIT_TEST(true, cm3.empty());
+        UNIT_TEST(true, cm3.insert({3, 3}));
+    }
+
+    // counters bumped from several threads, shards grow concurrently
+    using IntPair = tiny_stl::pair<int, int>;
+    tiny_stl::concurrent_unordered_map<int, int, tiny_stl::hash<int>,
+                                       tiny_stl::equal_to<int>,
+                                       tiny_stl::allocator<IntPair>, 8>
+        cm2;
+    tiny_stl::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&cm2] {
+            for (int i = 0; i < 2000; ++i)
+                cm2.emplace_or_update(i % 500, [](int& v) { ++v; }, 1);
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+    UNIT_TEST(500, cm2.size());
+    long long total = 0;
+    cm2.visit_all([&total](int, int v) { total += v; });
+    UNIT_TEST(8000, total);
+    int v = 0;
+    cm2.find(7, v);
+    UNIT_TEST(16, v);
+    cm2.clear();
+    UNIT_TEST(true, cm2.empty());
+}
+
+void testConcurrentMap() {
+    using Elem = tiny_stl::pair<const int, tiny_stl::string>;
+    tiny_stl::concurrent_map<int, tiny_stl::string> cm1;
+    UNIT_TEST(true, cm1.empty());
+    UNIT_TEST(true, cm1.insert({3, "three"}));
+    UNIT_TEST(true, cm1.emplace(1, "one"));
+    UNIT_TEST(false, cm1.emplace(1, "uno"));
+    UNIT_TEST(true, cm1.emplace(2, "two"));
+    tiny_stl::string s;
+    UNIT_TEST(true, cm1.find(1, s));
+    UNIT_TEST("one", s);
+    UNIT_TEST(false, cm1.find(4, s));
+    UNIT_TEST(true,
+              cm1.visit(3, [&s](const tiny_stl::string& v) { s = v; }));
+    UNIT_TEST("three", s);
+    s.clear();
+    cm1.for_each([&s](const Elem& e) { s += e.second; });
+    UNIT_TEST("onetwothree", s);
+    s.clear();
+    UNIT_TEST(2, cm1.scan(2, 10, [&s](const Elem& e) { s += e.second; }));
+    UNIT_TEST("twothree", s);
+    s.clear();
+    UNIT_TEST(1, cm1.scan_n(0, 1, [&s](const Elem& e) { s += e.second; }));
+    UNIT_TEST("one", s);
+    UNIT_TEST(1, cm1.erase(2));
+    UNIT_TEST(0, cm1.erase(2));
+    UNIT_TEST(false, cm1.contains(2));
+    UNIT_TEST(2, cm1.size());
+
+    // disjoint inserts and erases from several threads
+    tiny_stl::concurrent_set<int> cs;
+    tiny_stl::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&cs, t] {
+            for (int i = t; i < 4000; i += 4)
+                cs.insert(i);
+            for (int i = t; i < 4000; i += 8)
+                cs.erase(i);
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+    UNIT_TEST(2000, cs.size());
+    int prev = -1;
+    bool ordered = true;
+    cs.for_each([&](int v) {
+        ordered = ordered && prev < v && v % 8 >= 4;
+        prev = v;
+    });
+    UNIT_TEST(true, ordered);
+    UNIT_TEST(true, cs.contains(3999));
+    cs.clear();
+    UNIT_TEST(true, cs.empty());
+}
+
 void testAll() {
     testUtility();
     testTypeTraits();
     testAlgorithm();
+    testNumeric();
     testArray();
     testMemory();
     testVector();
+    testSmallVector();
+    testStaticVector();
+    testDynamicBitset();
     testList();
     testForwardList();
     testDeque();
+    testCircularBuffer();
+    testSearchIndex();
     testAdaptor();
+    testIndexedHeap();
+    testSpscQueue();
+    testMpmcQueue();
     testCowString();
     testString();
     testStringView();
@@ -1307,6 +2492,8 @@ void testAll() {
     testTuple();
     testUnorderSet();
     testUnorderedMap();
+    testConcurrentUnorderedMap();
+    testConcurrentMap();
 }
 
 int main() {
@@ -445,6 +445,9 @@ struct IsIntegral<char32_t> : true_type {};
 template <>
 struct IsIntegral<short> : true_type {};
 
+template <>
+struct IsIntegral<unsigned short> : true_type {};
+
 template <>
 struct IsIntegral<unsigned int> : true_type {};
 
@@ -473,7 +476,7 @@ template <typename T, bool = is_integral<T>::value>
 struct SignBase {
     using U = remove_cv_t<T>;
     using Signed = bool_constant<U(-1) < U(0)>;
-    using Unsiged = bool_constant<U(0) < U(-1)>;
+    using Unsigned = bool_constant<U(0) < U(-1)>;
 };
 
 template <typename T>
@@ -483,7 +486,7 @@ struct SignBase<T, false> {
 };
 
 template <typename T>
-struct is_signed : SignBase<T>::SignBase {};
+struct is_signed : SignBase<T>::Signed {};
 
 template <typename T>
 constexpr bool is_signed_v = is_signed<T>::value;
@@ -705,6 +708,13 @@ template <typename T>
 constexpr bool is_trivially_destructible_v =
     is_trivially_destructible<T>::value;
 
+template <typename T>
+struct is_trivially_copyable
+    : bool_constant<std::is_trivially_copyable<T>::value> {};
+
+template <typename T>
+constexpr bool is_trivially_copyable_v = is_trivially_copyable<T>::value;
+
 template <typename T, typename... Args>
 struct is_nothrow_constructible
     : bool_constant<std::is_nothrow_constructible<T, Args...>::value> {};
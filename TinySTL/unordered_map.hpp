@@ -151,7 +151,7 @@ public:
     T& operator[](const key_type& key) {
         iterator pos = this->find(key);
         if (pos == this->end())
-            return this->insert(make_pair(key, T{})).first->second;
+            return this->insert(tiny_stl::make_pair(key, T{})).first->second;
 
         return pos->second;
     }
@@ -159,7 +159,7 @@ public:
     T& operator[](key_type&& key) {
         iterator pos = this->find(key);
         if (pos == this->end())
-            return this->insert(make_pair(tiny_stl::move(key), T{}))
+            return this->insert(tiny_stl::make_pair(tiny_stl::move(key), T{}))
                 .first->second;
 
         return pos->second;
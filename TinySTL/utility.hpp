@@ -27,6 +27,68 @@
 #define IFCONSTEXPR
 #endif // TINY_STL_CXX17
 
+// read prefetch hint, a no-op where the compiler has no intrinsic
+#if defined(__GNUC__) || defined(__clang__)
+#define TINY_STL_PREFETCH(addr) __builtin_prefetch(addr)
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <xmmintrin.h>
+#define TINY_STL_PREFETCH(addr)                                                \
+    _mm_prefetch(reinterpret_cast<const char*>(addr), _MM_HINT_T0)
+#else
+#define TINY_STL_PREFETCH(addr) ((void)(addr))
+#endif
+
+// pause hint for the body of a spin-wait loop
+#if (defined(__GNUC__) || defined(__clang__)) &&                              \
+    (defined(__x86_64__) || defined(__i386__))
+#define TINY_STL_CPU_RELAX() __builtin_ia32_pause()
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__)
+#define TINY_STL_CPU_RELAX() asm volatile("yield" ::: "memory")
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#define TINY_STL_CPU_RELAX() _mm_pause()
+#else
+#define TINY_STL_CPU_RELAX() ((void)0)
+#endif
+
+// SIMD instruction sets the translation unit is compiled for
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TINY_STL_SSE2
+#endif
+
+#if defined(__AVX2__)
+#define TINY_STL_AVX2
+#endif
+
+// Without -mavx2, AVX2 kernels are still compiled for their own functions and
+// picked at run time. TINY_STL_NO_RUNTIME_DISPATCH keeps such builds on SSE2.
+#if defined(TINY_STL_SSE2) && !defined(TINY_STL_AVX2) &&                       \
+    !defined(TINY_STL_NO_RUNTIME_DISPATCH)
+#if defined(__GNUC__) || defined(__clang__)
+#define TINY_STL_AVX2_DISPATCH
+#define TINY_STL_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(_MSC_VER)
+#define TINY_STL_AVX2_DISPATCH
+#endif
+#endif
+
+#ifndef TINY_STL_TARGET_AVX2
+#define TINY_STL_TARGET_AVX2
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define TINY_STL_FORCE_INLINE inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define TINY_STL_FORCE_INLINE __forceinline
+#else
+#define TINY_STL_FORCE_INLINE inline
+#endif
+
+// keeps data written by different threads on different cache lines
+#ifndef TINY_STL_CACHE_LINE_SIZE
+#define TINY_STL_CACHE_LINE_SIZE 64
+#endif
+
 namespace tiny_stl {
 
 template <typename T>
@@ -5,8 +5,15 @@
 #pragma once
 
 #include "memory.hpp"
+#include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <initializer_list>
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 namespace tiny_stl {
 
 template <typename T>
@@ -198,6 +205,27 @@ operator+(typename VectorIterator<T>::difference_type offset,
     return iter += offset;
 }
 
+template <typename Iter, typename Ptr>
+struct VectorContiguousTraits {
+    using is_contiguous_iterator = true_type;
+
+    static Ptr toPointer(const Iter& iter) {
+        return iter.ptr;
+    }
+
+    static Iter fromPointer(const Iter&, Ptr p) {
+        return Iter(const_cast<typename Iter::value_type*>(p));
+    }
+};
+
+template <typename T>
+struct ContiguousIteratorTraits<VectorConstIterator<T>>
+    : VectorContiguousTraits<VectorConstIterator<T>, const T*> {};
+
+template <typename T>
+struct ContiguousIteratorTraits<VectorIterator<T>>
+    : VectorContiguousTraits<VectorIterator<T>, T*> {};
+
 template <typename T, typename Alloc>
 class VectorBase {
 public:
@@ -517,13 +545,17 @@ private:
         }
     }
 
+    // release the old block before taking over rhs's
     void assignMove(vector&& rhs, true_type) noexcept {
+        tidy();
         constructMove(tiny_stl::move(rhs), true_type{});
     }
 
     void assignMove(vector&& rhs, false_type) {
-        if (this->alloc == rhs.alloc)
-            constructMove(tiny_stl::move(rhs), true_type{});
+        if (this->alloc == rhs.alloc) {
+            assignMove(tiny_stl::move(rhs), true_type{});
+            return;
+        }
 
         // Move individually
         const size_type newSize = rhs.size();
@@ -605,16 +637,17 @@ public:
         allocator_traits<Alloc>::is_always_equal::value) {
         assert(this != tiny_stl::addressof(rhs));
 
-        if (allocator_traits<
-                Alloc>::propagate_on_container_move_assignment::value)
-            this->alloc = rhs.alloc;
-
+        // the old block goes back to the allocator that owns it
         assignMove(
             tiny_stl::move(rhs),
             disjunction<typename allocator_traits<
                             Alloc>::propagate_on_container_move_assignment,
                         typename allocator_traits<Alloc>::is_always_equal>{});
 
+        if (allocator_traits<
+                Alloc>::propagate_on_container_move_assignment::value)
+            this->alloc = rhs.alloc;
+
         return *this;
     }
 
@@ -993,8 +1026,10 @@ private:
             static_cast<size_type>(tiny_stl::distance(xfirst, xlast));
         const size_type offset = pos.ptr - this->first;
 
-        if (n == 1 && pos.ptr == this->last)
+        if (n == 1 && pos.ptr == this->last) {
             emplace(pos.ptr, *xfirst);
+            return;
+        }
 
         if (n == 0) {
             // do nothing
@@ -1021,32 +1056,27 @@ private:
                 throw;
             }
         } else { // no reallocate
+            const pointer p = const_cast<pointer>(pos.ptr);
             const pointer oldLast = this->last;
-            const size_type number_move = oldLast - pos.ptr;
-            if (n >= number_move) { // no move backward
-                const pointer newPos = this->first + (offset + n);
-                this->last = moveAux(pos.ptr, oldLast, newPos);
-
-                try {
-                    copyAux(xfirst, xlast, pos.ptr);
-                } catch (...) {
-                    // FIXME, move rollback
-                    tidy();
-                    throw;
-                }
-            } else { // move backward
-                this->last = oldLast + n;
-                pointer p = const_cast<pointer>(oldLast + (n - 1));
-                for (size_type i = 0; i < number_move; ++i, --p)
-                    *p = tiny_stl::move(p[-static_cast<difference_type>(n)]);
-
-                try {
-                    copyAux(xfirst, xlast, pos.ptr);
-                } catch (...) {
-                    // FIXME, move rollback
-                    tidy();
-                    throw;
+            const size_type number_move = oldLast - p;
+            try {
+                if (n < number_move) {
+                    // 1 2 3 4 5 _ _ => 1 2 3 4 5 4 5 => 1 2 3 2 3 4 5
+                    this->last = moveAux(oldLast - n, oldLast, oldLast);
+                    tiny_stl::move_backward(p, oldLast - n, oldLast);
+                    tiny_stl::copy(xfirst, xlast, p);
+                } else {
+                    // 1 2 _ _ _ => 1 2 x x _ => 1 2 x x 2 => 1 x x x 2
+                    FwdIter mid = xfirst;
+                    tiny_stl::advance(mid, number_move);
+                    this->last = copyAux(mid, xlast, oldLast);
+                    this->last = moveAux(p, oldLast, this->last);
+                    tiny_stl::copy(xfirst, mid, p);
                 }
+            } catch (...) {
+                // FIXME, move rollback
+                tidy();
+                throw;
             }
         }
     }
@@ -1105,14 +1135,21 @@ private:
             if (newSize > max_size())
                 xLength();
 
-            size_type newCapacity = (newSize >> 1) + newSize;
+            const size_type newCapacity = capacityGrowth(newSize);
+            const pointer newFirst = this->alloc.allocate(newCapacity);
+            try {
+                default_or_fill(newFirst + oldSize, newSize - oldSize);
+            } catch (...) {
+                this->alloc.deallocate(newFirst, newCapacity);
+                throw;
+            }
 
-            const pointer newFirst = nullptr;
             try {
-                newFirst = this->alloc.allocate(newCapacity);
                 moveOrCopy(this->first, this->last, newFirst);
             } catch (...) {
-                tidy();
+                destroyAllocRange(newFirst + oldSize, newFirst + newSize,
+                                  this->alloc);
+                this->alloc.deallocate(newFirst, newCapacity);
                 throw;
             }
 
@@ -1147,9 +1184,9 @@ public:
         noexcept(allocator_traits<Alloc>::propagate_on_container_swap::value ||
                  allocator_traits<Alloc>::is_always_equal::value)) {
         swapAlloc(this->alloc, rhs.alloc);
-        swapADL(this->first, rhs.first);
-        swapADL(this->last, rhs.last);
-        swapADL(this->end_of_storage, rhs.end_of_storage);
+        tiny_stl::swap(this->first, rhs.first);
+        tiny_stl::swap(this->last, rhs.last);
+        tiny_stl::swap(this->end_of_storage, rhs.end_of_storage);
     }
 
 private:
@@ -1162,6 +1199,804 @@ private:
     }
 }; // class vector<T>
 
+namespace details {
+
+using BitWord = std::uint64_t;
+
+constexpr unsigned kBitWordBits = 64;
+
+inline unsigned popCount(BitWord w) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_popcountll(w));
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return static_cast<unsigned>(__popcnt64(w));
+#else
+    w = w - ((w >> 1) & 0x5555555555555555ULL);
+    w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+    w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return static_cast<unsigned>((w * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// w != 0
+inline unsigned countTrailingZeros(BitWord w) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(w));
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long idx;
+    _BitScanForward64(&idx, w);
+    return static_cast<unsigned>(idx);
+#else
+    unsigned n = 0;
+    for (; (w & 1) == 0; w >>= 1)
+        ++n;
+    return n;
+#endif
+}
+
+// bits [lo, hi) of a word, 0 <= lo < hi <= 64
+inline BitWord bitMask(unsigned lo, unsigned hi) noexcept {
+    return (~BitWord(0) >> (kBitWordBits - (hi - lo))) << lo;
+}
+
+// n bits (1 <= n <= 64) starting at bit off of *w, they may continue in w[1]
+inline BitWord loadBits(const BitWord* w, unsigned off, unsigned n) noexcept {
+    BitWord bits = w[0] >> off;
+    if (off + n > kBitWordBits)
+        bits |= w[1] << (kBitWordBits - off);
+    return n == kBitWordBits ? bits : bits & bitMask(0, n);
+}
+
+// n bits (1 <= n <= 64 - off) into *w at bit off
+inline void storeBits(BitWord* w, unsigned off, unsigned n,
+                      BitWord bits) noexcept {
+    const BitWord mask = bitMask(off, off + n);
+    *w = (*w & ~mask) | ((bits << off) & mask);
+}
+
+} // namespace details
+
+// proxy for one bit of vector<bool>
+class BitReference {
+public:
+    details::BitWord* word;
+    details::BitWord mask;
+
+    BitReference(details::BitWord* w, details::BitWord m) noexcept
+        : word(w), mask(m) {
+    }
+
+    operator bool() const noexcept {
+        return (*word & mask) != 0;
+    }
+
+    BitReference& operator=(bool x) noexcept {
+        if (x)
+            *word |= mask;
+        else
+            *word &= ~mask;
+        return *this;
+    }
+
+    BitReference& operator=(const BitReference& rhs) noexcept {
+        return *this = static_cast<bool>(rhs);
+    }
+
+    bool operator~() const noexcept {
+        return !static_cast<bool>(*this);
+    }
+
+    void flip() noexcept {
+        *word ^= mask;
+    }
+}; // class BitReference
+
+inline void swap(BitReference lhs, BitReference rhs) noexcept {
+    const bool tmp = lhs;
+    lhs = rhs;
+    rhs = tmp;
+}
+
+// The const and mutable iterators are one template instead of a derived
+// pair, so the word-level algorithms below can be written once and are
+// picked over the generic ones by partial ordering.
+template <bool IsConst>
+struct BitIterator {
+    using iterator_category = random_access_iterator_tag;
+    using value_type = bool;
+    using difference_type = std::ptrdiff_t;
+    using pointer = conditional_t<IsConst, const bool*, BitReference*>;
+    using reference = conditional_t<IsConst, bool, BitReference>;
+    using Self = BitIterator<IsConst>;
+
+    details::BitWord* word;
+    unsigned offset; // [0, 64)
+
+    BitIterator() : word(), offset() {
+    }
+
+    BitIterator(details::BitWord* w, unsigned off) : word(w), offset(off) {
+    }
+
+    // iterator to const_iterator
+    template <bool Other, typename = enable_if_t<IsConst && !Other>>
+    BitIterator(const BitIterator<Other>& rhs)
+        : word(rhs.word), offset(rhs.offset) {
+    }
+
+    reference operator*() const {
+        return BitReference(word, details::BitWord(1) << offset);
+    }
+
+    Self& operator++() {
+        if (++offset == details::kBitWordBits) {
+            offset = 0;
+            ++word;
+        }
+        return *this;
+    }
+
+    Self operator++(int) {
+        Self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    Self& operator--() {
+        if (offset-- == 0) {
+            offset = details::kBitWordBits - 1;
+            --word;
+        }
+        return *this;
+    }
+
+    Self operator--(int) {
+        Self tmp = *this;
+        --*this;
+        return tmp;
+    }
+
+    Self& operator+=(difference_type n) {
+        constexpr difference_type bits = details::kBitWordBits;
+        n += offset;
+        word += n / bits;
+        n %= bits;
+        if (n < 0) {
+            n += bits;
+            --word;
+        }
+        offset = static_cast<unsigned>(n);
+        return *this;
+    }
+
+    Self operator+(difference_type n) const {
+        Self tmp = *this;
+        return tmp += n;
+    }
+
+    Self& operator-=(difference_type n) {
+        return *this += -n;
+    }
+
+    Self operator-(difference_type n) const {
+        Self tmp = *this;
+        return tmp -= n;
+    }
+
+    difference_type operator-(const Self& rhs) const {
+        return (word - rhs.word) * difference_type(details::kBitWordBits) +
+               static_cast<difference_type>(offset) -
+               static_cast<difference_type>(rhs.offset);
+    }
+
+    reference operator[](difference_type n) const {
+        return *(*this + n);
+    }
+
+    bool operator==(const Self& rhs) const {
+        return word == rhs.word && offset == rhs.offset;
+    }
+
+    bool operator!=(const Self& rhs) const {
+        return !(*this == rhs);
+    }
+
+    bool operator<(const Self& rhs) const {
+        return word < rhs.word || (word == rhs.word && offset < rhs.offset);
+    }
+
+    bool operator>(const Self& rhs) const {
+        return rhs < *this;
+    }
+
+    bool operator<=(const Self& rhs) const {
+        return !(rhs < *this);
+    }
+
+    bool operator>=(const Self& rhs) const {
+        return !(*this < rhs);
+    }
+}; // struct BitIterator<IsConst>
+
+template <bool IsConst>
+inline BitIterator<IsConst>
+operator+(typename BitIterator<IsConst>::difference_type n,
+          BitIterator<IsConst> iter) {
+    return iter += n;
+}
+
+// Overloads of the algorithms for bit ranges. They walk the range a word
+// at a time: a masked partial word at each end and whole words between.
+
+template <bool IsConst, typename T>
+inline BitIterator<IsConst> find(BitIterator<IsConst> first,
+                                 BitIterator<IsConst> last, const T& val) {
+    using details::BitWord;
+    using details::kBitWordBits;
+
+    // look for set bits in w ^ flip
+    const BitWord flip = static_cast<bool>(val) ? 0 : ~BitWord(0);
+    std::ptrdiff_t n = last - first;
+    BitWord* w = first.word;
+    if (first.offset != 0 && n > 0) {
+        const unsigned end =
+            static_cast<unsigned>(tiny_stl::min<std::ptrdiff_t>(
+                kBitWordBits, first.offset + n));
+        const BitWord bits = (*w ^ flip) & details::bitMask(first.offset, end);
+        if (bits != 0)
+            return BitIterator<IsConst>(w, details::countTrailingZeros(bits));
+        n -= end - first.offset;
+        ++w;
+    }
+
+    for (; n >= kBitWordBits; n -= kBitWordBits, ++w) {
+        const BitWord bits = *w ^ flip;
+        if (bits != 0)
+            return BitIterator<IsConst>(w, details::countTrailingZeros(bits));
+    }
+
+    if (n > 0) {
+        const BitWord bits =
+            (*w ^ flip) & details::bitMask(0, static_cast<unsigned>(n));
+        if (bits != 0)
+            return BitIterator<IsConst>(w, details::countTrailingZeros(bits));
+    }
+
+    return last;
+}
+
+template <bool IsConst, typename T>
+inline std::ptrdiff_t count(BitIterator<IsConst> first,
+                            BitIterator<IsConst> last, const T& val) {
+    using details::BitWord;
+    using details::kBitWordBits;
+
+    const std::ptrdiff_t total = last - first;
+    std::ptrdiff_t n = total;
+    std::ptrdiff_t ones = 0;
+    const BitWord* w = first.word;
+    if (first.offset != 0 && n > 0) {
+        const unsigned end =
+            static_cast<unsigned>(tiny_stl::min<std::ptrdiff_t>(
+                kBitWordBits, first.offset + n));
+        ones += details::popCount(*w & details::bitMask(first.offset, end));
+        n -= end - first.offset;
+        ++w;
+    }
+
+    for (; n >= kBitWordBits; n -= kBitWordBits, ++w)
+        ones += details::popCount(*w);
+
+    if (n > 0)
+        ones += details::popCount(
+            *w & details::bitMask(0, static_cast<unsigned>(n)));
+
+    return static_cast<bool>(val) ? ones : total - ones;
+}
+
+template <typename T>
+inline void fill(BitIterator<false> first, BitIterator<false> last,
+                 const T& val) {
+    using details::BitWord;
+    using details::kBitWordBits;
+
+    const BitWord fillWord = static_cast<bool>(val) ? ~BitWord(0) : 0;
+    std::ptrdiff_t n = last - first;
+    BitWord* w = first.word;
+    if (first.offset != 0 && n > 0) {
+        const unsigned end =
+            static_cast<unsigned>(tiny_stl::min<std::ptrdiff_t>(
+                kBitWordBits, first.offset + n));
+        details::storeBits(w, first.offset, end - first.offset, fillWord);
+        n -= end - first.offset;
+        ++w;
+    }
+
+    const std::ptrdiff_t words = n / kBitWordBits;
+    for (std::ptrdiff_t i = 0; i < words; ++i)
+        w[i] = fillWord;
+    w += words;
+    n -= words * kBitWordBits;
+
+    if (n > 0)
+        details::storeBits(w, 0, static_cast<unsigned>(n), fillWord);
+}
+
+template <bool IsConst>
+inline BitIterator<false> copy(BitIterator<IsConst> first,
+                               BitIterator<IsConst> last,
+                               BitIterator<false> dst) {
+    using details::kBitWordBits;
+
+    // each step fills the rest of one destination word, so a range may
+    // be moved to a lower address in place
+    std::ptrdiff_t n = last - first;
+    if (first.offset == dst.offset && n >= kBitWordBits) {
+        if (first.offset != 0) {
+            const unsigned head = kBitWordBits - first.offset;
+            details::storeBits(dst.word, dst.offset, head,
+                               details::loadBits(first.word, first.offset,
+                                                 head));
+            first += head;
+            dst += head;
+            n -= head;
+        }
+
+        const std::ptrdiff_t words = n / kBitWordBits;
+        std::memmove(dst.word, first.word, words * sizeof(details::BitWord));
+        first.word += words;
+        dst.word += words;
+        n -= words * kBitWordBits;
+    }
+
+    while (n > 0) {
+        const unsigned chunk = static_cast<unsigned>(
+            tiny_stl::min<std::ptrdiff_t>(kBitWordBits - dst.offset, n));
+        details::storeBits(dst.word, dst.offset, chunk,
+                           details::loadBits(first.word, first.offset, chunk));
+        first += chunk;
+        dst += chunk;
+        n -= chunk;
+    }
+
+    return dst;
+}
+
+template <bool IsConst>
+inline BitIterator<false> copy_backward(BitIterator<IsConst> first,
+                                        BitIterator<IsConst> last,
+                                        BitIterator<false> dstLast) {
+    using details::kBitWordBits;
+
+    // mirror of copy, a range may be moved to a higher address in place
+    std::ptrdiff_t n = last - first;
+    while (n > 0) {
+        const unsigned room =
+            dstLast.offset == 0 ? kBitWordBits : dstLast.offset;
+        const unsigned chunk =
+            static_cast<unsigned>(tiny_stl::min<std::ptrdiff_t>(room, n));
+        last -= chunk;
+        dstLast -= chunk;
+        details::storeBits(dstLast.word, dstLast.offset, chunk,
+                           details::loadBits(last.word, last.offset, chunk));
+        n -= chunk;
+    }
+
+    return dstLast;
+}
+
+template <bool IsConst1, bool IsConst2>
+inline bool equal(BitIterator<IsConst1> first1, BitIterator<IsConst1> last1,
+                  BitIterator<IsConst2> first2) {
+    using details::BitWord;
+    using details::kBitWordBits;
+
+    std::ptrdiff_t n = last1 - first1;
+    if (first1.offset == first2.offset) {
+        const BitWord* w1 = first1.word;
+        const BitWord* w2 = first2.word;
+        if (first1.offset != 0 && n > 0) {
+            const unsigned end =
+                static_cast<unsigned>(tiny_stl::min<std::ptrdiff_t>(
+                    kBitWordBits, first1.offset + n));
+            if ((*w1 ^ *w2) & details::bitMask(first1.offset, end))
+                return false;
+            n -= end - first1.offset;
+            ++w1;
+            ++w2;
+        }
+
+        for (; n >= kBitWordBits; n -= kBitWordBits, ++w1, ++w2)
+            if (*w1 != *w2)
+                return false;
+
+        return n <= 0 ||
+               ((*w1 ^ *w2) & details::bitMask(0, static_cast<unsigned>(n))) ==
+                   0;
+    }
+
+    // different alignment, compare 64 bits at a time through loadBits
+    for (; n > 0; n -= kBitWordBits) {
+        const unsigned chunk = static_cast<unsigned>(
+            tiny_stl::min<std::ptrdiff_t>(kBitWordBits, n));
+        if (details::loadBits(first1.word, first1.offset, chunk) !=
+            details::loadBits(first2.word, first2.offset, chunk))
+            return false;
+        ++first1.word;
+        ++first2.word;
+    }
+
+    return true;
+}
+
+template <bool IsConst1, bool IsConst2>
+inline bool equal(BitIterator<IsConst1> first1, BitIterator<IsConst1> last1,
+                  BitIterator<IsConst2> first2, BitIterator<IsConst2> last2) {
+    return last1 - first1 == last2 - first2 &&
+           tiny_stl::equal(first1, last1, first2);
+}
+
+// vector<bool> packs 64 flags into each word of an underlying
+// vector<uint64_t>. Bits of the last word past size() are unspecified,
+// every operation writes the bits it exposes.
+template <typename Alloc>
+class vector<bool, Alloc> {
+public:
+    static_assert(tiny_stl::is_same_v<bool, typename Alloc::value_type>,
+                  "Alloc::value_type is not the same as bool");
+
+    using value_type = bool;
+    using allocator_type = Alloc;
+    using size_type = typename Alloc::size_type;
+    using difference_type = typename Alloc::difference_type;
+    using reference = BitReference;
+    using const_reference = bool;
+    using iterator = BitIterator<false>;
+    using const_iterator = BitIterator<true>;
+    using reverse_iterator = tiny_stl::reverse_iterator<iterator>;
+    using const_reverse_iterator = tiny_stl::reverse_iterator<const_iterator>;
+
+private:
+    using Word = details::BitWord;
+    using AlWord =
+        typename allocator_traits<Alloc>::template rebind_alloc<Word>;
+
+    vector<Word, AlWord> words; // words.size() == wordCount(nbits)
+    size_type nbits;
+
+private:
+    static size_type wordCount(size_type n) noexcept {
+        return (n + details::kBitWordBits - 1) / details::kBitWordBits;
+    }
+
+    iterator makeIter(size_type i) const noexcept {
+        return iterator(const_cast<Word*>(words.data()) +
+                            i / details::kBitWordBits,
+                        static_cast<unsigned>(i % details::kBitWordBits));
+    }
+
+    // make room for n bits at i, the new bits are unspecified
+    void openGap(size_type i, size_type n) {
+        const size_type oldSize = nbits;
+        if (n > max_size() - oldSize)
+            xLength();
+
+        words.resize(wordCount(oldSize + n));
+        nbits = oldSize + n;
+        tiny_stl::copy_backward(makeIter(i), makeIter(oldSize), end());
+    }
+
+    template <typename InIter>
+    void insertRange(size_type i, InIter xfirst, InIter xlast,
+                     input_iterator_tag) {
+        for (; xfirst != xlast; ++xfirst, ++i)
+            insert(cbegin() + i, static_cast<bool>(*xfirst));
+    }
+
+    template <typename FwdIter>
+    void insertRange(size_type i, FwdIter xfirst, FwdIter xlast,
+                     forward_iterator_tag) {
+        openGap(i, static_cast<size_type>(tiny_stl::distance(xfirst, xlast)));
+        tiny_stl::copy(xfirst, xlast, makeIter(i));
+    }
+
+public:
+    vector() noexcept(noexcept(Alloc())) : vector(Alloc()) {
+    }
+
+    explicit vector(const Alloc& alloc) noexcept
+        : words(AlWord(alloc)), nbits(0) {
+    }
+
+    vector(size_type count, const bool& val, const Alloc& alloc = Alloc())
+        : words(wordCount(count), val ? ~Word(0) : Word(0), AlWord(alloc)),
+          nbits(count) {
+    }
+
+    explicit vector(size_type count, const Alloc& alloc = Alloc())
+        : vector(count, false, alloc) {
+    }
+
+    template <typename InIter,
+              typename = enable_if_t<is_iterator<InIter>::value>>
+    vector(InIter xfirst, InIter xlast, const Alloc& alloc = Alloc())
+        : vector(alloc) {
+        insert(cend(), xfirst, xlast);
+    }
+
+    vector(const vector& rhs, const Alloc& alloc)
+        : words(rhs.words, AlWord(alloc)), nbits(rhs.nbits) {
+    }
+
+    vector(vector&& rhs, const Alloc& alloc)
+        : words(tiny_stl::move(rhs.words), AlWord(alloc)), nbits(rhs.nbits) {
+        rhs.nbits = 0;
+    }
+
+    vector(std::initializer_list<bool> ilist, const Alloc& alloc = Alloc())
+        : vector(ilist.begin(), ilist.end(), alloc) {
+    }
+
+    vector(const vector&) = default;
+
+    vector(vector&& rhs) noexcept
+        : words(tiny_stl::move(rhs.words)), nbits(rhs.nbits) {
+        rhs.nbits = 0;
+    }
+
+    vector& operator=(const vector&) = default;
+
+    vector& operator=(vector&& rhs) noexcept(
+        noexcept(words = tiny_stl::move(rhs.words))) {
+        if (this != &rhs) {
+            words = tiny_stl::move(rhs.words);
+            nbits = rhs.nbits;
+            rhs.nbits = 0;
+        }
+        return *this;
+    }
+
+    vector& operator=(std::initializer_list<bool> ilist) {
+        assign(ilist);
+        return *this;
+    }
+
+    void assign(size_type n, const bool& val) {
+        clear();
+        insert(cend(), n, val);
+    }
+
+    template <typename InIter,
+              typename = enable_if_t<is_iterator<InIter>::value>>
+    void assign(InIter xfirst, InIter xlast) {
+        clear();
+        insert(cend(), xfirst, xlast);
+    }
+
+    void assign(std::initializer_list<bool> ilist) {
+        assign(ilist.begin(), ilist.end());
+    }
+
+    allocator_type get_allocator() const {
+        return allocator_type(words.get_allocator());
+    }
+
+public:
+    reference at(size_type pos) {
+        if (pos >= nbits)
+            xRange();
+        return (*this)[pos];
+    }
+
+    const_reference at(size_type pos) const {
+        if (pos >= nbits)
+            xRange();
+        return (*this)[pos];
+    }
+
+    reference operator[](size_type pos) {
+        return *makeIter(pos);
+    }
+
+    const_reference operator[](size_type pos) const {
+        return *makeIter(pos);
+    }
+
+    reference front() {
+        return *begin();
+    }
+
+    const_reference front() const {
+        return *begin();
+    }
+
+    reference back() {
+        return *(end() - 1);
+    }
+
+    const_reference back() const {
+        return *(end() - 1);
+    }
+
+    iterator begin() noexcept {
+        return makeIter(0);
+    }
+
+    const_iterator begin() const noexcept {
+        return makeIter(0);
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    iterator end() noexcept {
+        return makeIter(nbits);
+    }
+
+    const_iterator end() const noexcept {
+        return makeIter(nbits);
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator crbegin() const noexcept {
+        return rbegin();
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    const_reverse_iterator crend() const noexcept {
+        return rend();
+    }
+
+public:
+    bool empty() const noexcept {
+        return nbits == 0;
+    }
+
+    size_type size() const noexcept {
+        return nbits;
+    }
+
+    size_type max_size() const noexcept {
+        const size_type maxWords = words.max_size();
+        return maxWords > static_cast<size_type>(-1) / details::kBitWordBits
+                   ? static_cast<size_type>(-1)
+                   : maxWords * details::kBitWordBits;
+    }
+
+    void reserve(size_type newCapacity) {
+        words.reserve(wordCount(newCapacity));
+    }
+
+    size_type capacity() const noexcept {
+        return words.capacity() * details::kBitWordBits;
+    }
+
+    void shrink_to_fit() {
+        words.shrink_to_fit();
+    }
+
+public:
+    void clear() noexcept {
+        words.clear();
+        nbits = 0;
+    }
+
+    void push_back(const bool& val) {
+        if (nbits % details::kBitWordBits == 0)
+            words.push_back(Word(0));
+        ++nbits;
+        back() = val;
+    }
+
+    template <typename... Args>
+    void emplace_back(Args&&... args) {
+        push_back(bool(tiny_stl::forward<Args>(args)...));
+    }
+
+    void pop_back() {
+        assert(!empty());
+        if (--nbits % details::kBitWordBits == 0)
+            words.pop_back();
+    }
+
+    iterator insert(const_iterator pos, const bool& val) {
+        return insert(pos, 1, val);
+    }
+
+    iterator insert(const_iterator pos, size_type n, const bool& val) {
+        const size_type i = static_cast<size_type>(pos - cbegin());
+        openGap(i, n);
+        tiny_stl::fill(makeIter(i), makeIter(i + n), val);
+        return makeIter(i);
+    }
+
+    template <typename InIter,
+              typename = enable_if_t<is_iterator<InIter>::value>>
+    iterator insert(const_iterator pos, InIter xfirst, InIter xlast) {
+        const size_type i = static_cast<size_type>(pos - cbegin());
+        insertRange(i, xfirst, xlast,
+                    typename iterator_traits<InIter>::iterator_category{});
+        return makeIter(i);
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<bool> ilist) {
+        return insert(pos, ilist.begin(), ilist.end());
+    }
+
+    template <typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args) {
+        return insert(pos, bool(tiny_stl::forward<Args>(args)...));
+    }
+
+    iterator erase(const_iterator pos) {
+        return erase(pos, pos + 1);
+    }
+
+    iterator erase(const_iterator xfirst, const_iterator xlast) {
+        const size_type i = static_cast<size_type>(xfirst - cbegin());
+        const size_type n = static_cast<size_type>(xlast - xfirst);
+        if (n != 0) {
+            tiny_stl::copy(makeIter(i + n), makeIter(nbits), makeIter(i));
+            nbits -= n;
+            words.resize(wordCount(nbits));
+        }
+        return makeIter(i);
+    }
+
+    void resize(size_type newSize, bool val = false) {
+        if (newSize <= nbits) {
+            nbits = newSize;
+            words.resize(wordCount(newSize));
+        } else {
+            insert(cend(), newSize - nbits, val);
+        }
+    }
+
+    void flip() noexcept {
+        for (Word& w : words)
+            w = ~w;
+    }
+
+    void swap(vector& rhs) noexcept(noexcept(words.swap(rhs.words))) {
+        words.swap(rhs.words);
+        tiny_stl::swap(nbits, rhs.nbits);
+    }
+
+    static void swap(reference lhs, reference rhs) noexcept {
+        const bool tmp = lhs;
+        lhs = rhs;
+        rhs = tmp;
+    }
+
+private:
+    [[noreturn]] static void xLength() {
+        throw "vector<bool> too long";
+    }
+
+    [[noreturn]] static void xRange() {
+        throw "invalid vector<bool> subscript";
+    }
+}; // class vector<bool, Alloc>
+
 template <typename T, typename Alloc>
 inline bool operator==(const vector<T, Alloc>& lhs,
                        const vector<T, Alloc>& rhs) {
@@ -0,0 +1,70 @@
+// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// small helpers shared by the benchmark programs, not part of the library
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+inline double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start)
+        .count();
+}
+
+// best wall time of reps runs of f(), in milliseconds
+template <typename F>
+double bestOf(int reps, F f) {
+    double best = 0;
+    for (int i = 0; i < reps; ++i) {
+        const Clock::time_point start = Clock::now();
+        f();
+        const double ms = msSince(start);
+        if (i == 0 || ms < best)
+            best = ms;
+    }
+    return best;
+}
+
+// keeps the optimizer from dropping the computation of val
+template <typename T>
+inline void doNotOptimize(const T& val) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(&val) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &val;
+#endif
+}
+
+// pin the calling thread to cpu (modulo the number of CPUs), only on Linux
+inline void pinThread(unsigned cpu) {
+#if defined(__linux__)
+    const unsigned n = std::thread::hardware_concurrency();
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(n == 0 ? 0 : cpu % n, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
+
+// argv[i] as a number, or def if it is missing
+inline long long arg(int argc, char** argv, int i, long long def) {
+    return i < argc ? std::atoll(argv[i]) : def;
+}
+
+} // namespace bench
@@ -0,0 +1,183 @@
+// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+// concurrent_map (skiplist) against std::mutex around tiny_stl::map:
+// 80% find, 10% insert or erase, 10% scans of 16 elements from 1 to max
+// threads, then single-threaded find-only and scan-only costs.
+//
+//   concurrent_map_bench [ops = 1000000] [keys = 200000] [max threads = 64]
+
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "bench.hpp"
+#include "concurrent_map.hpp"
+#include "map.hpp"
+#include "vector.hpp"
+
+namespace {
+
+constexpr std::size_t kScanLength = 16;
+
+// xorshift64*, one per thread
+struct Rng {
+    std::uint64_t s;
+
+    std::uint64_t operator()() noexcept {
+        s ^= s >> 12;
+        s ^= s << 25;
+        s ^= s >> 27;
+        return s * 0x2545F4914F6CDD1Dull;
+    }
+};
+
+struct SkipList {
+    tiny_stl::concurrent_map<long, long> map;
+
+    bool find(long key, long& val) {
+        return map.find(key, val);
+    }
+
+    void insert(long key) {
+        map.insert(tiny_stl::make_pair(key, key));
+    }
+
+    void erase(long key) {
+        map.erase(key);
+    }
+
+    long scan(long key) {
+        long sum = 0;
+        map.scan_n(key, kScanLength,
+                   [&sum](const tiny_stl::pair<const long, long>& e) {
+                       sum += e.second;
+                   });
+        return sum;
+    }
+};
+
+struct Locked {
+    tiny_stl::map<long, long> map;
+    std::mutex m;
+
+    bool find(long key, long& val) {
+        std::lock_guard<std::mutex> g(m);
+        auto pos = map.find(key);
+        if (pos == map.end())
+            return false;
+        val = pos->second;
+        return true;
+    }
+
+    void insert(long key) {
+        std::lock_guard<std::mutex> g(m);
+        map.insert(tiny_stl::make_pair(key, key));
+    }
+
+    void erase(long key) {
+        std::lock_guard<std::mutex> g(m);
+        map.erase(key);
+    }
+
+    long scan(long key) {
+        std::lock_guard<std::mutex> g(m);
+        long sum = 0;
+        auto pos = map.lower_bound(key);
+        for (std::size_t i = 0; i != kScanLength && pos != map.end();
+             ++i, ++pos)
+            sum += pos->second;
+        return sum;
+    }
+};
+
+template <typename Map>
+void fill(Map& m, long keys) {
+    for (long k = 0; k < keys; k += 2)
+        m.insert(k);
+}
+
+// percentages: find below 80, insert below 85, erase below 90, else scan.
+// Returns Mops/s.
+template <typename Map>
+double mixed(long long ops, long keys, unsigned nthreads) {
+    Map m;
+    fill(m, keys);
+
+    tiny_stl::vector<std::thread> threads;
+    const bench::Clock::time_point start = bench::Clock::now();
+    for (unsigned t = 0; t < nthreads; ++t) {
+        threads.emplace_back([&m, ops, keys, nthreads, t] {
+            Rng rng{0x9E3779B97F4A7C15ull * (t + 1)};
+            long sink = 0;
+            long val = 0;
+            for (long long i = ops * t / nthreads;
+                 i < ops * (t + 1) / nthreads; ++i) {
+                const std::uint64_t r = rng();
+                const long key = static_cast<long>((r >> 8) % keys);
+                const unsigned pick = static_cast<unsigned>(r % 100);
+                if (pick < 80)
+                    sink += m.find(key, val);
+                else if (pick < 85)
+                    m.insert(key);
+                else if (pick < 90)
+                    m.erase(key);
+                else
+                    sink += m.scan(key);
+            }
+            bench::doNotOptimize(sink);
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+    return static_cast<double>(ops) / bench::msSince(start) / 1e3;
+}
+
+// ns per find or per scan on one thread
+template <typename Map>
+void single(long long ops, long keys, double& findNs, double& scanNs) {
+    Map m;
+    fill(m, keys);
+    Rng rng{42};
+    long sink = 0;
+    long val = 0;
+
+    bench::Clock::time_point start = bench::Clock::now();
+    for (long long i = 0; i < ops; ++i)
+        sink += m.find(static_cast<long>(rng() % keys), val);
+    findNs = bench::msSince(start) * 1e6 / static_cast<double>(ops);
+
+    start = bench::Clock::now();
+    for (long long i = 0; i < ops; ++i)
+        sink += m.scan(static_cast<long>(rng() % keys));
+    scanNs = bench::msSince(start) * 1e6 / static_cast<double>(ops);
+    bench::doNotOptimize(sink);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const long long ops = bench::arg(argc, argv, 1, 1000000);
+    const long keys = static_cast<long>(bench::arg(argc, argv, 2, 200000));
+    const unsigned maxThreads =
+        static_cast<unsigned>(bench::arg(argc, argv, 3, 64));
+
+    std::printf("%lld ops over %ld keys, %u CPUs, Mops/s\n", ops, keys,
+                std::thread::hardware_concurrency());
+    std::printf("  threads  skiplist  mutex+map\n");
+    for (unsigned n = 1; n <= maxThreads; n *= 2) {
+        const double skip = mixed<SkipList>(ops, keys, n);
+        const double locked = mixed<Locked>(ops, keys, n);
+        std::printf("  %7u %9.2f %10.2f\n", n, skip, locked);
+    }
+
+    double skipFind = 0, skipScan = 0, mapFind = 0, mapScan = 0;
+    single<SkipList>(ops, keys, skipFind, skipScan);
+    single<Locked>(ops, keys, mapFind, mapScan);
+    std::printf("one thread, ns per op   skiplist  mutex+map\n");
+    std::printf("  find                 %9.1f %10.1f\n", skipFind, mapFind);
+    std::printf("  scan of %2zu           %9.1f %10.1f\n", kScanLength,
+                skipScan, mapScan);
+    return 0;
+}
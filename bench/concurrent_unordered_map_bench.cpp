@@ -0,0 +1,116 @@
+// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+// Mixed find / insert_or_assign on concurrent_unordered_map from 1 to
+// max threads, against std::mutex around tiny_stl::unordered_map.
+//
+//   concurrent_unordered_map_bench [ops = 2000000] [keys = 100000]
+//                                  [max threads = 64]
+
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "bench.hpp"
+#include "concurrent_unordered_map.hpp"
+#include "unordered_map.hpp"
+#include "vector.hpp"
+
+namespace {
+
+// xorshift64*, one per thread
+struct Rng {
+    std::uint64_t s;
+
+    std::uint64_t operator()() noexcept {
+        s ^= s >> 12;
+        s ^= s << 25;
+        s ^= s >> 27;
+        return s * 0x2545F4914F6CDD1Dull;
+    }
+};
+
+struct Sharded {
+    tiny_stl::concurrent_unordered_map<long, long> map;
+
+    bool find(long key, long& val) {
+        return map.find(key, val);
+    }
+
+    void assign(long key, long val) {
+        map.insert_or_assign(key, val);
+    }
+};
+
+struct Locked {
+    tiny_stl::unordered_map<long, long> map;
+    std::mutex m;
+
+    bool find(long key, long& val) {
+        std::lock_guard<std::mutex> g(m);
+        auto pos = map.find(key);
+        if (pos == map.end())
+            return false;
+        val = pos->second;
+        return true;
+    }
+
+    void assign(long key, long val) {
+        std::lock_guard<std::mutex> g(m);
+        map[key] = val;
+    }
+};
+
+// ops spread over nthreads, writePercent of them insert_or_assign,
+// returns Mops/s
+template <typename Map>
+double run(long long ops, long keys, unsigned nthreads, unsigned writePercent) {
+    Map m;
+    for (long k = 0; k < keys; k += 2)
+        m.assign(k, k);
+
+    tiny_stl::vector<std::thread> threads;
+    const bench::Clock::time_point start = bench::Clock::now();
+    for (unsigned t = 0; t < nthreads; ++t) {
+        threads.emplace_back([&m, ops, keys, nthreads, writePercent, t] {
+            Rng rng{0x9E3779B97F4A7C15ull * (t + 1)};
+            long hits = 0;
+            long val = 0;
+            for (long long i = ops * t / nthreads;
+                 i < ops * (t + 1) / nthreads; ++i) {
+                const std::uint64_t r = rng();
+                const long key = static_cast<long>((r >> 8) % keys);
+                if (r % 100 < writePercent)
+                    m.assign(key, static_cast<long>(i));
+                else
+                    hits += m.find(key, val);
+            }
+            bench::doNotOptimize(hits);
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+    return static_cast<double>(ops) / bench::msSince(start) / 1e3;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const long long ops = bench::arg(argc, argv, 1, 2000000);
+    const long keys = static_cast<long>(bench::arg(argc, argv, 2, 100000));
+    const unsigned maxThreads =
+        static_cast<unsigned>(bench::arg(argc, argv, 3, 64));
+
+    std::printf("%lld ops over %ld keys, %u CPUs, Mops/s\n", ops, keys,
+                std::thread::hardware_concurrency());
+    for (unsigned writes : {10u, 50u}) {
+        std::printf("%u%% writes\n  threads   sharded     mutex\n", writes);
+        for (unsigned n = 1; n <= maxThreads; n *= 2) {
+            const double sharded = run<Sharded>(ops, keys, n, writes);
+            const double locked = run<Locked>(ops, keys, n, writes);
+            std::printf("  %7u %9.2f %9.2f\n", n, sharded, locked);
+        }
+    }
+    return 0;
+}
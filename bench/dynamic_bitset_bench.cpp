@@ -0,0 +1,74 @@
+// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+// Intersecting two large dynamic_bitsets, best of 5. The kernels are
+// picked at compile time, so build with and without -mavx2 (or -mpopcnt)
+// to compare them.
+//
+//   dynamic_bitset_bench [bits = 1000000000]
+
+#include <cstdint>
+
+#include "bench.hpp"
+#include "dynamic_bitset.hpp"
+
+namespace {
+
+const char* kernelName() {
+#if defined(TINY_STL_AVX2)
+    return "AVX2";
+#elif defined(TINY_STL_SSE2) && defined(__POPCNT__)
+    return "SSE2 + popcnt";
+#elif defined(TINY_STL_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+// sets about one bit in (maxGap + 1) / 2, at random gaps
+void fillRandom(tiny_stl::dynamic_bitset<>& b, std::uint64_t seed,
+                unsigned maxGap) {
+    std::uint64_t s = seed;
+    for (std::size_t i = 0; i < b.size();) {
+        b.set(i);
+        s ^= s >> 12;
+        s ^= s << 25;
+        s ^= s >> 27;
+        i += 1 + (s * 0x2545F4914F6CDD1Dull >> 32) % maxGap;
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t bits =
+        static_cast<std::size_t>(bench::arg(argc, argv, 1, 1000000000));
+    constexpr int kReps = 5;
+
+    tiny_stl::dynamic_bitset<> a(bits);
+    tiny_stl::dynamic_bitset<> b(bits);
+    fillRandom(a, 1, 3);
+    fillRandom(b, 2, 5);
+    tiny_stl::dynamic_bitset<> dst(bits);
+    tiny_stl::dynamic_bitset<> inPlace(a);
+
+    std::printf("%zu bits (%.0f MB per bitset), %s kernels, best of %d\n",
+                bits, static_cast<double>(bits) / 8 / 1e6, kernelName(),
+                kReps);
+
+    const double andMs = bench::bestOf(kReps, [&] { dst.assign_and(a, b); });
+    const double inPlaceMs = bench::bestOf(kReps, [&] { inPlace &= b; });
+    std::size_t ones = 0;
+    const double countMs = bench::bestOf(kReps, [&] { ones = a.count(); });
+    bench::doNotOptimize(ones);
+
+    std::printf("  assign_and   %8.1f ms  %6.1f GB/s moved\n", andMs,
+                3.0 * static_cast<double>(bits) / 8 / andMs / 1e6);
+    std::printf("  &= in place  %8.1f ms\n", inPlaceMs);
+    std::printf("  count        %8.1f ms  (%zu bits set)\n", countMs, ones);
+    std::printf("  check        %s\n",
+                dst == inPlace && dst.count() <= ones ? "ok" : "MISMATCH");
+    return 0;
+}
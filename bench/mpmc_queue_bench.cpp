@@ -0,0 +1,123 @@
+// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+// mpmc_queue scaling from 1 to max producer/consumer pairs, blocking
+// push/pop, against a bounded queue made of a mutex, two condition
+// variables and tiny_stl::queue.
+//
+//   mpmc_queue_bench [items = 8000000] [capacity = 1024] [max pairs = 8]
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "bench.hpp"
+#include "mpmc_queue.hpp"
+#include "queue.hpp"
+#include "vector.hpp"
+
+namespace {
+
+class MutexQueue {
+private:
+    tiny_stl::queue<long> q;
+    std::size_t cap;
+    std::mutex m;
+    std::condition_variable notFull;
+    std::condition_variable notEmpty;
+
+public:
+    explicit MutexQueue(std::size_t n) : cap(n) {
+    }
+
+    void push(long v) {
+        std::unique_lock<std::mutex> g(m);
+        notFull.wait(g, [this] { return q.size() < cap; });
+        q.push(v);
+        g.unlock();
+        notEmpty.notify_one();
+    }
+
+    void pop(long& v) {
+        std::unique_lock<std::mutex> g(m);
+        notEmpty.wait(g, [this] { return !q.empty(); });
+        v = q.front();
+        q.pop();
+        g.unlock();
+        notFull.notify_one();
+    }
+};
+
+// items spread over `pairs` producers and as many consumers, returns ms
+template <typename Queue>
+double run(Queue& q, long long items, unsigned pairs, long long& sum) {
+    tiny_stl::vector<std::thread> threads;
+    tiny_stl::vector<long long> sums(pairs, 0);
+    const bench::Clock::time_point start = bench::Clock::now();
+
+    for (unsigned t = 0; t < pairs; ++t) {
+        const long long first = items * t / pairs;
+        const long long last = items * (t + 1) / pairs;
+        threads.emplace_back([&q, first, last, t] {
+            bench::pinThread(2 * t);
+            for (long long i = first; i < last; ++i)
+                q.push(static_cast<long>(i));
+        });
+        threads.emplace_back([&q, &sums, first, last, t] {
+            bench::pinThread(2 * t + 1);
+            long long s = 0;
+            long v = 0;
+            for (long long i = first; i < last; ++i) {
+                q.pop(v);
+                s += v;
+            }
+            sums[t] = s;
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+
+    const double ms = bench::msSince(start);
+    sum = 0;
+    for (long long s : sums)
+        sum += s;
+    return ms;
+}
+
+void report(double ms, long long items, long long sum, long long expect) {
+    std::printf("  %8.1f ms %6.1f M/s%s", ms,
+                static_cast<double>(items) / ms / 1e3,
+                sum == expect ? "" : " (wrong sum)");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const long long items = bench::arg(argc, argv, 1, 8000000);
+    const std::size_t cap =
+        static_cast<std::size_t>(bench::arg(argc, argv, 2, 1024));
+    const unsigned maxPairs =
+        static_cast<unsigned>(bench::arg(argc, argv, 3, 8));
+    const long long expect = items * (items - 1) / 2;
+
+    std::printf("%lld longs, capacity %zu, %u CPUs\n", items, cap,
+                std::thread::hardware_concurrency());
+    std::printf("  threads          mpmc_queue"
+                "           mutex+condvar+queue\n");
+
+    for (unsigned pairs = 1; pairs <= maxPairs; pairs *= 2) {
+        long long sum = 0;
+        std::printf("  %2uP/%2uC", pairs, pairs);
+
+        tiny_stl::mpmc_queue<long> mq(cap);
+        double ms = run(mq, items, pairs, sum);
+        report(ms, items, sum, expect);
+
+        MutexQueue lq(cap);
+        ms = run(lq, items, pairs, sum);
+        report(ms, items, sum, expect);
+        std::printf("\n");
+    }
+    return 0;
+}
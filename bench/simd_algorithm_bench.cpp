@@ -0,0 +1,112 @@
+// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+// find, count, min_element and minmax_element on int8 to int64, float and
+// double, in ns per element, best of 7. "old" is the predicate or
+// comparator overload, which stays on the scalar loop; "new" is the
+// vectorized overload. Define TINY_STL_NO_RUNTIME_DISPATCH to measure
+// the SSE2 kernels on a CPU with AVX2.
+//
+//   simd_algorithm_bench [elements = 4096] [elements touched per run]
+
+#include <cstdint>
+
+#include "algorithm.hpp"
+#include "bench.hpp"
+#include "vector.hpp"
+
+namespace {
+
+constexpr int kReps = 7;
+
+// ns per element of f() over a range of n, repeated to touch about
+// `touched` elements per timed run
+template <typename F>
+double nsPerElement(std::size_t n, long long touched, F f) {
+    const long long rounds = touched / static_cast<long long>(n) + 1;
+    const double ms = bench::bestOf(kReps, [&] {
+        for (long long r = 0; r < rounds; ++r)
+            f();
+    });
+    return ms * 1e6 / static_cast<double>(rounds) / static_cast<double>(n);
+}
+
+template <typename T>
+void benchType(const char* name, std::size_t n, long long touched) {
+    // values in [0, 100), so searching for 101 scans the whole range
+    tiny_stl::vector<T> v(n);
+    std::uint64_t s = 0x9E3779B97F4A7C15ull;
+    for (auto& x : v) {
+        s ^= s >> 12;
+        s ^= s << 25;
+        s ^= s >> 27;
+        x = static_cast<T>((s * 0x2545F4914F6CDD1Dull >> 33) % 100);
+    }
+    const T absent = static_cast<T>(101);
+    const T present = static_cast<T>(7);
+    const T* first = v.data();
+    const T* last = v.data() + n;
+
+    const double findOld = nsPerElement(n, touched, [&] {
+        bench::doNotOptimize(tiny_stl::find_if(
+            first, last, [absent](const T& x) { return x == absent; }));
+    });
+    const double findNew = nsPerElement(n, touched, [&] {
+        bench::doNotOptimize(tiny_stl::find(first, last, absent));
+    });
+    const double countOld = nsPerElement(n, touched, [&] {
+        bench::doNotOptimize(tiny_stl::count_if(
+            first, last, [present](const T& x) { return x == present; }));
+    });
+    const double countNew = nsPerElement(n, touched, [&] {
+        bench::doNotOptimize(tiny_stl::count(first, last, present));
+    });
+    const double minOld = nsPerElement(n, touched, [&] {
+        bench::doNotOptimize(
+            tiny_stl::min_element(first, last, tiny_stl::less<T>()));
+    });
+    const double minNew = nsPerElement(n, touched, [&] {
+        bench::doNotOptimize(tiny_stl::min_element(first, last));
+    });
+    const double minmaxOld = nsPerElement(n, touched, [&] {
+        bench::doNotOptimize(
+            tiny_stl::minmax_element(first, last, tiny_stl::less<T>()));
+    });
+    const double minmaxNew = nsPerElement(n, touched, [&] {
+        bench::doNotOptimize(tiny_stl::minmax_element(first, last));
+    });
+
+    std::printf("  %-6s %6.3f->%-6.3f %6.3f->%-6.3f %6.3f->%-6.3f "
+                "%6.3f->%.3f\n",
+                name, findOld, findNew, countOld, countNew, minOld, minNew,
+                minmaxOld, minmaxNew);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t n =
+        static_cast<std::size_t>(bench::arg(argc, argv, 1, 4096));
+    const long long touched = bench::arg(argc, argv, 2, 50000000);
+
+#if defined(TINY_STL_AVX2)
+    const char* isa = "AVX2 (compiled in)";
+#elif defined(TINY_STL_AVX2_DISPATCH)
+    const char* isa = "SSE2, AVX2 picked at run time";
+#elif defined(TINY_STL_SSE2)
+    const char* isa = "SSE2";
+#else
+    const char* isa = "scalar";
+#endif
+    std::printf("%zu elements, %s, ns per element old->new\n", n, isa);
+    std::printf("  type       find          count         min_element"
+                "   minmax_element\n");
+    benchType<std::int8_t>("int8", n, touched);
+    benchType<std::int16_t>("int16", n, touched);
+    benchType<std::int32_t>("int32", n, touched);
+    benchType<std::int64_t>("int64", n, touched);
+    benchType<float>("float", n, touched);
+    benchType<double>("double", n, touched);
+    return 0;
+}
@@ -0,0 +1,187 @@
+// Copyright (C) 2021 syn1w
+// Distributed under the MIT software license, see the accompanying
+// file LICENSE or http://www.opensource.org/licenses/mit-license.php.
+
+// spsc_queue throughput and latency between two pinned threads, against a
+// mutex around tiny_stl::queue.
+//
+//   spsc_queue_bench [items = 20000000] [capacity = 1024] [round trips]
+
+#include <mutex>
+#include <thread>
+
+#include "bench.hpp"
+#include "queue.hpp"
+#include "spsc_queue.hpp"
+
+namespace {
+
+constexpr std::size_t kBatch = 64;
+
+// both ends spin on the queue, yielding when it is full or empty so a
+// machine with a single CPU still makes progress
+template <typename Produce, typename Consume>
+long long runPair(Produce produce, Consume consume) {
+    long long sum = 0;
+    std::thread consumer([&] {
+        bench::pinThread(1);
+        sum = consume();
+    });
+    bench::pinThread(0);
+    produce();
+    consumer.join();
+    return sum;
+}
+
+double spscOneByOne(long long items, std::size_t cap, long long& sum) {
+    tiny_stl::spsc_queue<long> q(cap);
+    const bench::Clock::time_point start = bench::Clock::now();
+    sum = runPair(
+        [&] {
+            for (long i = 0; i < items; ++i) {
+                while (!q.try_push(i))
+                    std::this_thread::yield();
+            }
+        },
+        [&] {
+            long long s = 0;
+            long v = 0;
+            for (long long i = 0; i < items; ++i) {
+                while (!q.try_pop(v))
+                    std::this_thread::yield();
+                s += v;
+            }
+            return s;
+        });
+    return bench::msSince(start);
+}
+
+double spscBatch(long long items, std::size_t cap, long long& sum) {
+    tiny_stl::spsc_queue<long> q(cap);
+    const bench::Clock::time_point start = bench::Clock::now();
+    sum = runPair(
+        [&] {
+            long buf[kBatch];
+            for (long long i = 0; i < items;) {
+                const long long left = items - i;
+                const std::size_t want =
+                    left < static_cast<long long>(kBatch)
+                        ? static_cast<std::size_t>(left)
+                        : kBatch;
+                for (std::size_t k = 0; k != want; ++k)
+                    buf[k] = static_cast<long>(i + k);
+                std::size_t done = 0;
+                while (done != want) {
+                    const std::size_t n =
+                        q.try_push_n(buf + done, want - done);
+                    if (n == 0)
+                        std::this_thread::yield();
+                    done += n;
+                }
+                i += want;
+            }
+        },
+        [&] {
+            long long s = 0;
+            long buf[kBatch];
+            for (long long i = 0; i < items;) {
+                const std::size_t n = q.try_pop_n(buf, kBatch);
+                if (n == 0)
+                    std::this_thread::yield();
+                for (std::size_t k = 0; k != n; ++k)
+                    s += buf[k];
+                i += static_cast<long long>(n);
+            }
+            return s;
+        });
+    return bench::msSince(start);
+}
+
+double mutexQueue(long long items, long long& sum) {
+    tiny_stl::queue<long> q;
+    std::mutex m;
+    const bench::Clock::time_point start = bench::Clock::now();
+    sum = runPair(
+        [&] {
+            for (long i = 0; i < items; ++i) {
+                std::lock_guard<std::mutex> g(m);
+                q.push(i);
+            }
+        },
+        [&] {
+            long long s = 0;
+            for (long long i = 0; i < items;) {
+                {
+                    std::lock_guard<std::mutex> g(m);
+                    if (!q.empty()) {
+                        s += q.front();
+                        q.pop();
+                        ++i;
+                        continue;
+                    }
+                }
+                std::this_thread::yield();
+            }
+            return s;
+        });
+    return bench::msSince(start);
+}
+
+// one element goes there and back, ns per round trip
+double pingPong(long long trips) {
+    tiny_stl::spsc_queue<long> ping(2);
+    tiny_stl::spsc_queue<long> pong(2);
+    const bench::Clock::time_point start = bench::Clock::now();
+    runPair(
+        [&] {
+            long v = 0;
+            for (long i = 0; i < trips; ++i) {
+                while (!ping.try_push(i))
+                    std::this_thread::yield();
+                while (!pong.try_pop(v))
+                    std::this_thread::yield();
+            }
+        },
+        [&] {
+            long v = 0;
+            for (long long i = 0; i < trips; ++i) {
+                while (!ping.try_pop(v))
+                    std::this_thread::yield();
+                while (!pong.try_push(v))
+                    std::this_thread::yield();
+            }
+            return 0LL;
+        });
+    return bench::msSince(start) * 1e6 / static_cast<double>(trips);
+}
+
+void report(const char* name, long long items, double ms, long long sum,
+            long long expect) {
+    std::printf("  %-24s %8.1f ms  %7.1f Mops/s%s\n", name, ms,
+                static_cast<double>(items) / ms / 1e3,
+                sum == expect ? "" : "  (wrong sum)");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const long long items = bench::arg(argc, argv, 1, 20000000);
+    const std::size_t cap =
+        static_cast<std::size_t>(bench::arg(argc, argv, 2, 1024));
+    const long long trips = bench::arg(argc, argv, 3, 200000);
+    const long long expect = items * (items - 1) / 2;
+
+    std::printf("%lld longs, capacity %zu, %u CPUs\n", items, cap,
+                std::thread::hardware_concurrency());
+
+    long long sum = 0;
+    double ms = spscOneByOne(items, cap, sum);
+    report("spsc try_push/try_pop", items, ms, sum, expect);
+    ms = spscBatch(items, cap, sum);
+    report("spsc batch of 64", items, ms, sum, expect);
+    ms = mutexQueue(items, sum);
+    report("mutex + queue<deque>", items, ms, sum, expect);
+    std::printf("  %-24s %8.0f ns\n", "spsc ping-pong round trip",
+                pingPong(trips));
+    return 0;
+}